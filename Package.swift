@@ -121,6 +121,10 @@ let cxxSettings: [CXXSetting] = useUnsafeFlags ? [.unsafeFlags(flags, .when(conf
 
 NSLog("--- compiling with UNSAFE C++ flags: %d", useUnsafeFlags)
 
+// The render guard replaces the global `operator new` and `operator delete`, so it is only built in on request.
+let useRenderGuard: Bool = ProcessInfo.processInfo.environment["DSPHEADERS_RENDER_GUARD"] != nil
+let renderGuardSettings: [CXXSetting] = useRenderGuard ? [.define("DSPHEADERS_RENDER_GUARD_ENABLED", to: "1")] : []
+
 let package = Package(
   name: "AUv3Support",
   platforms: [.iOS(.v16), .macOS(.v14)],
@@ -134,7 +138,7 @@ let package = Package(
     .target(
       name: "DSPHeaders",
       exclude: ["README.md"],
-      cxxSettings: cxxSettings,
+      cxxSettings: cxxSettings + renderGuardSettings,
       swiftSettings: [.define("APPLICATION_EXTENSION_API_ONLY"), .interoperabilityMode(.Cxx)]
     ),
     .target(
@@ -191,6 +195,7 @@ let package = Package(
       name: "DSPHeadersTests",
       dependencies: ["DSPHeaders"],
       exclude: ["Pirkle/README.md", "Pirkle/readme.txt"],
+      cxxSettings: renderGuardSettings,
       linkerSettings: [.linkedFramework("AVFoundation")]
     ),
     .testTarget(
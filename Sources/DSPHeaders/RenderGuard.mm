@@ -0,0 +1,180 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <execinfo.h>
+#include <new>
+
+#include "DSPHeaders/RenderGuard.hpp"
+
+#if DSPHEADERS_RENDER_GUARD_C_HOOKS
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+using namespace DSPHeaders;
+
+void RenderGuard::prepare() noexcept {
+  std::array<void*, 1> frames;
+  backtrace(frames.data(), int(frames.size()));
+}
+
+void RenderGuard::record(Kind kind, size_t size) noexcept {
+  // Capturing the stack could allocate, which must not be recorded as well.
+  Suspend suspend{};
+  auto index = count_.fetch_add(1, std::memory_order_acq_rel);
+  if (index >= maxViolations) return;
+  auto& violation{violations_[index]};
+  violation.kind = kind;
+  violation.size = size;
+  violation.stackDepth = size_t(std::max(0, backtrace(violation.stack.data(), int(maxStackFrames))));
+}
+
+std::string RenderGuard::describe(size_t index) {
+  const auto& entry{violation(index)};
+  std::string description;
+  switch (entry.kind) {
+    case Kind::allocation: description = "allocation of " + std::to_string(entry.size) + " bytes"; break;
+    case Kind::deallocation: description = "deallocation"; break;
+    case Kind::lock: description = "mutex lock"; break;
+  }
+
+  auto symbols = backtrace_symbols(entry.stack.data(), int(entry.stackDepth));
+  if (symbols != nullptr) {
+    for (size_t frame = 0; frame < entry.stackDepth; ++frame) description += std::string("\n  ") + symbols[frame];
+    std::free(symbols);
+  }
+  return description;
+}
+
+#if DSPHEADERS_RENDER_GUARD_ENABLED
+
+#if DSPHEADERS_RENDER_GUARD_C_HOOKS
+
+// The glibc allocator entry points, which let the wrappers below call the real allocator.
+extern "C" {
+void* __libc_malloc(size_t size) noexcept;
+void* __libc_calloc(size_t count, size_t size) noexcept;
+void* __libc_realloc(void* pointer, size_t size) noexcept;
+void __libc_free(void* pointer) noexcept;
+}
+
+namespace {
+
+using MutexLock = int (*)(pthread_mutex_t*);
+
+/// The `pthread_mutex_lock` that the wrapper below replaces. Resolved on first use without taking a lock.
+std::atomic<MutexLock> nextMutexLock{nullptr};
+
+void* rawAllocate(size_t size) noexcept { return __libc_malloc(size); }
+void rawFree(void* pointer) noexcept { __libc_free(pointer); }
+
+}
+
+extern "C" {
+
+void* malloc(size_t size) noexcept {
+  RenderGuard::check(RenderGuard::Kind::allocation, size);
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) noexcept {
+  RenderGuard::check(RenderGuard::Kind::allocation, count * size);
+  return __libc_calloc(count, size);
+}
+
+void* realloc(void* pointer, size_t size) noexcept {
+  RenderGuard::check(RenderGuard::Kind::allocation, size);
+  return __libc_realloc(pointer, size);
+}
+
+void free(void* pointer) noexcept {
+  if (pointer != nullptr) RenderGuard::check(RenderGuard::Kind::deallocation);
+  __libc_free(pointer);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) noexcept {
+  RenderGuard::check(RenderGuard::Kind::lock);
+  auto next = nextMutexLock.load(std::memory_order_relaxed);
+  if (next == nullptr) [[unlikely]] {
+    next = reinterpret_cast<MutexLock>(dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+    nextMutexLock.store(next, std::memory_order_relaxed);
+  }
+  return next(mutex);
+}
+
+}
+
+#else
+
+namespace {
+
+void* rawAllocate(size_t size) noexcept { return std::malloc(size); }
+void rawFree(void* pointer) noexcept { std::free(pointer); }
+
+}
+
+#endif // DSPHEADERS_RENDER_GUARD_C_HOOKS
+
+namespace {
+
+void* checkedAllocate(size_t size) noexcept {
+  RenderGuard::check(RenderGuard::Kind::allocation, size);
+  return rawAllocate(size == 0 ? 1 : size);
+}
+
+void* checkedAllocate(size_t size, std::align_val_t alignment) noexcept {
+  RenderGuard::check(RenderGuard::Kind::allocation, size);
+  void* pointer = nullptr;
+  auto bytes = std::max(size_t(alignment), sizeof(void*));
+  return posix_memalign(&pointer, bytes, size == 0 ? 1 : size) == 0 ? pointer : nullptr;
+}
+
+void* throwingAllocate(size_t size) {
+  if (auto pointer = checkedAllocate(size)) return pointer;
+  throw std::bad_alloc();
+}
+
+void* throwingAllocate(size_t size, std::align_val_t alignment) {
+  if (auto pointer = checkedAllocate(size, alignment)) return pointer;
+  throw std::bad_alloc();
+}
+
+void checkedFree(void* pointer) noexcept {
+  if (pointer == nullptr) return;
+  RenderGuard::check(RenderGuard::Kind::deallocation);
+  rawFree(pointer);
+}
+
+}
+
+// Replacements of the global allocation functions. Memory from `posix_memalign` is released with `free` as well.
+
+void* operator new(size_t size) { return throwingAllocate(size); }
+void* operator new[](size_t size) { return throwingAllocate(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return checkedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return checkedAllocate(size); }
+void* operator new(size_t size, std::align_val_t alignment) { return throwingAllocate(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return throwingAllocate(size, alignment); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return checkedAllocate(size, alignment);
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+  return checkedAllocate(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept { checkedFree(pointer); }
+void operator delete[](void* pointer) noexcept { checkedFree(pointer); }
+void operator delete(void* pointer, size_t) noexcept { checkedFree(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { checkedFree(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { checkedFree(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { checkedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { checkedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { checkedFree(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { checkedFree(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { checkedFree(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { checkedFree(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { checkedFree(pointer); }
+
+#endif // DSPHEADERS_RENDER_GUARD_ENABLED
@@ -0,0 +1,200 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+/**
+ Single point of entry for the Apple audio types used by the DSPHeaders classes. On Apple platforms this just imports
+ the AudioToolbox, AVFoundation and os_log headers. Elsewhere (Linux CI and batch machines) it provides a small
+ stand-in for the handful of AudioToolbox types and constants that `EventProcessor` and friends depend on so that
+ kernels can be built and driven offline without any Apple frameworks. The stand-in types mirror the layout and values
+ of the Apple definitions, but only to the extent needed by this package.
+ */
+
+#if defined(__APPLE__)
+
+#import <os/log.h>
+#import <AudioToolbox/AudioToolbox.h>
+#import <AVFoundation/AVFoundation.h>
+
+#else
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+#if !defined(__clang__)
+#define _Nonnull
+#define _Nullable
+#endif
+
+using UInt8 = std::uint8_t;
+using UInt16 = std::uint16_t;
+using UInt32 = std::uint32_t;
+using UInt64 = std::uint64_t;
+using SInt16 = std::int16_t;
+using SInt32 = std::int32_t;
+using SInt64 = std::int64_t;
+using Float32 = float;
+using Float64 = double;
+using Byte = std::uint8_t;
+using NSInteger = long;
+using OSStatus = SInt32;
+
+using AUValue = float;
+using AUParameterAddress = UInt64;
+using AUAudioFrameCount = UInt32;
+using AVAudioFrameCount = UInt32;
+using AUAudioChannelCount = UInt32;
+using AVAudioChannelCount = UInt32;
+using AUEventSampleTime = SInt64;
+using AUAudioUnitStatus = OSStatus;
+using AudioUnitRenderActionFlags = UInt32;
+
+enum : OSStatus {
+  noErr = 0,
+  kAudioUnitErr_InvalidParameter = -10878,
+  kAudioUnitErr_NoConnection = -10876,
+  kAudioUnitErr_TooManyFramesToProcess = -10874,
+  kAudioUnitErr_FormatNotSupported = -10868,
+  kAudioUnitErr_Uninitialized = -10867,
+  kAudioUnitErr_CannotDoInCurrentContext = -10863
+};
+
+enum : AudioUnitRenderActionFlags {
+  kAudioUnitRenderAction_PreRender = (1U << 2),
+  kAudioUnitRenderAction_PostRender = (1U << 3),
+  kAudioUnitRenderAction_OutputIsSilence = (1U << 4),
+  kAudioOfflineUnitRenderAction_Preflight = (1U << 5),
+  kAudioOfflineUnitRenderAction_Render = (1U << 6),
+  kAudioOfflineUnitRenderAction_Complete = (1U << 7),
+  kAudioUnitRenderAction_PostRenderError = (1U << 8),
+  kAudioUnitRenderAction_DoNotCheckRenderArgs = (1U << 9)
+};
+
+/// Stand-in for CoreAudio's `AudioBuffer` -- one channel of non-interleaved samples.
+struct AudioBuffer {
+  UInt32 mNumberChannels;
+  UInt32 mDataByteSize;
+  void* _Nullable mData;
+};
+
+/// Stand-in for CoreAudio's variable-length `AudioBufferList`. As with the real thing, storage for more than one
+/// buffer must be allocated by the owner.
+struct AudioBufferList {
+  UInt32 mNumberBuffers;
+  AudioBuffer mBuffers[1];
+};
+
+enum : UInt32 {
+  kAudioTimeStampSampleTimeValid = (1U << 0),
+  kAudioTimeStampHostTimeValid = (1U << 1),
+  kAudioTimeStampRateScalarValid = (1U << 2)
+};
+
+/// Stand-in for CoreAudio's `AudioTimeStamp`. SMPTE time is not supported.
+struct AudioTimeStamp {
+  Float64 mSampleTime;
+  UInt64 mHostTime;
+  Float64 mRateScalar;
+  UInt64 mWordClockTime;
+  UInt32 mFlags;
+  UInt32 mReserved;
+};
+
+enum AURenderEventType : UInt8 {
+  AURenderEventParameter = 1,
+  AURenderEventParameterRamp = 2,
+  AURenderEventMIDI = 8,
+  AURenderEventMIDISysEx = 9,
+  AURenderEventMIDIEventList = 10
+};
+
+union AURenderEvent;
+
+struct AURenderEventHeader {
+  AURenderEvent* _Nullable next;
+  AUEventSampleTime eventSampleTime;
+  AURenderEventType eventType;
+  UInt8 reserved;
+};
+
+struct AUParameterEvent {
+  AURenderEvent* _Nullable next;
+  AUEventSampleTime eventSampleTime;
+  AURenderEventType eventType;
+  UInt8 reserved[3];
+  AUAudioFrameCount rampDurationSampleFrames;
+  AUParameterAddress parameterAddress;
+  AUValue value;
+};
+
+struct AUMIDIEvent {
+  AURenderEvent* _Nullable next;
+  AUEventSampleTime eventSampleTime;
+  AURenderEventType eventType;
+  UInt8 reserved;
+  UInt16 length;
+  UInt8 cable;
+  UInt8 data[3];
+};
+
+using MIDITimeStamp = UInt64;
+
+enum MIDIProtocolID : SInt32 {
+  kMIDIProtocol_1_0 = 1,
+  kMIDIProtocol_2_0 = 2
+};
+
+#pragma pack(push, 4)
+
+/// Stand-in for CoreMIDI's `MIDIEventPacket` -- one or more Universal MIDI Packet messages with the same timestamp.
+struct MIDIEventPacket {
+  MIDITimeStamp timeStamp;
+  UInt32 wordCount;
+  UInt32 words[64];
+};
+
+/// Stand-in for CoreMIDI's variable-length `MIDIEventList`. As with the real thing, each packet only occupies the
+/// words that it uses, so the next one starts right after `words[wordCount - 1]`.
+struct MIDIEventList {
+  MIDIProtocolID protocol;
+  UInt32 numPackets;
+  MIDIEventPacket packet[1];
+};
+
+#pragma pack(pop)
+
+struct AUMIDIEventList {
+  AURenderEvent* _Nullable next;
+  AUEventSampleTime eventSampleTime;
+  AURenderEventType eventType;
+  UInt8 reserved;
+  UInt8 cable;
+  MIDIEventList eventList;
+};
+
+union AURenderEvent {
+  AURenderEventHeader head;
+  AUParameterEvent parameter;
+  AUMIDIEvent MIDI;
+  AUMIDIEventList MIDIEventsList;
+};
+
+/// Stand-in for the `AURenderPullInputBlock` Objective-C block that is used to obtain upstream samples.
+using AURenderPullInputBlock = std::function<AUAudioUnitStatus(AudioUnitRenderActionFlags* _Nonnull actionFlags,
+                                                               const AudioTimeStamp* _Nonnull timestamp,
+                                                               AUAudioFrameCount frameCount,
+                                                               NSInteger inputBusNumber,
+                                                               AudioBufferList* _Nonnull inputData)>;
+
+/// Stand-in for os_log -- logging is discarded.
+struct os_log_s;
+using os_log_t = os_log_s*;
+
+inline os_log_t _Nullable os_log_create(const char* _Nonnull, const char* _Nonnull) noexcept { return nullptr; }
+
+#define os_log_info(log, ...) ((void)(log))
+#define os_log_debug(log, ...) ((void)(log))
+#define os_log_error(log, ...) ((void)(log))
+
+#endif
@@ -6,7 +6,7 @@
 #include <limits>
 #include <utility>
 
-#include <AVFoundation/AVFoundation.h>
+#include "DSPHeaders/AudioTypes.hpp"
 
 namespace DSPHeaders::Biquad {
 
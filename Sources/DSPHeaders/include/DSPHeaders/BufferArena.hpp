@@ -0,0 +1,191 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <algorithm>
+#import <cassert>
+#import <cstddef>
+#import <cstring>
+#import <memory>
+#import <new>
+
+#import "DSPHeaders/AudioTypes.hpp"
+
+namespace DSPHeaders {
+
+/**
+ Holds the sample storage for a set of busses, each with the same number of non-interleaved `AUValue` channels, in one
+ allocation. The `AudioBufferList` of each bus lives in the same block, ahead of the samples.
+
+ Every channel starts on a 64-byte boundary, so SIMD loads of the first samples are aligned and no two channels share a
+ cache line. When the distance between channels would be a multiple of 1 KiB -- as it is for the common power-of-two
+ frame counts -- one cache line of padding is added to it. Otherwise, the same sample of every channel would map to
+ the same few cache sets and evict one another when a kernel walks all of the channels together.
+
+ Memory is only allocated by `allocate`, which must not be called while rendering.
+ */
+class BufferArena {
+public:
+  /// The alignment of each channel in bytes
+  static constexpr size_t alignment = 64;
+
+  /// Channel strides that are a multiple of this many bytes get padded
+  static constexpr size_t aliasingStride = 1024;
+
+  BufferArena() noexcept = default;
+  BufferArena(BufferArena&&) noexcept = default;
+  BufferArena& operator=(BufferArena&&) noexcept = default;
+  BufferArena(const BufferArena&) = delete;
+  BufferArena& operator=(const BufferArena&) = delete;
+
+  /**
+   Obtain the number of samples from the start of one channel to the start of the next.
+
+   @param maxFrames the number of frames a channel must hold
+   @returns the channel stride in samples
+   */
+  static constexpr size_t channelStride(AUAudioFrameCount maxFrames) noexcept {
+    constexpr size_t lineSamples = alignment / sizeof(AUValue);
+    auto stride = std::max((size_t(maxFrames) + lineSamples - 1) / lineSamples, size_t(1)) * lineSamples;
+    if ((stride * sizeof(AUValue)) % aliasingStride == 0) stride += lineSamples;
+    return stride;
+  }
+
+  /**
+   Allocate storage for the given busses. The block held before is reused if it is large enough, so restarting
+   rendering with the same format does not touch the heap. All samples are set to zero.
+
+   @param busCount the number of busses to hold
+   @param channelCount the number of channels in each bus
+   @param maxFrames the maximum number of frames to hold in each channel
+   */
+  void allocate(size_t busCount, AUAudioChannelCount channelCount, AUAudioFrameCount maxFrames) {
+    if (busCount == 0) {
+      release();
+      return;
+    }
+
+    listSize_ = roundUp(offsetof(AudioBufferList, mBuffers) + std::max(channelCount, 1U) * sizeof(AudioBuffer),
+                        alignof(AudioBufferList));
+    samplesOffset_ = roundUp(listSize_ * busCount, alignment);
+    stride_ = channelStride(maxFrames);
+    auto size = samplesOffset_ + busCount * channelCount * stride_ * sizeof(AUValue);
+    if (!storage_ || size > allocatedSize_) {
+      release();
+      storage_.reset(static_cast<std::byte*>(::operator new(size, std::align_val_t{alignment})));
+      allocatedSize_ = size;
+    }
+    std::memset(storage_.get(), 0, size);
+
+    busCount_ = busCount;
+    channelCount_ = channelCount;
+    maxFrames_ = maxFrames;
+    for (size_t bus = 0; bus < busCount; ++bus) {
+      mutableAudioBufferList(bus)->mNumberBuffers = channelCount;
+      reset(bus);
+      setFrameCount(bus, maxFrames);
+    }
+  }
+
+  /**
+   Forget any allocated storage.
+   */
+  void release() noexcept {
+    storage_.reset();
+    allocatedSize_ = 0;
+    busCount_ = 0;
+    channelCount_ = 0;
+    maxFrames_ = 0;
+  }
+
+  /**
+   Point the buffers of a bus back at their own storage, undoing any change made by a host or an upstream node.
+
+   @param bus the bus to reset
+   */
+  void reset(size_t bus) noexcept {
+    auto bufferList = mutableAudioBufferList(bus);
+    for (UInt32 channel = 0; channel < channelCount_; ++channel) {
+      auto& buffer{bufferList->mBuffers[channel]};
+      buffer.mNumberChannels = 1;
+      buffer.mData = samples(bus, channel);
+    }
+  }
+
+  /**
+   Update the buffers of a bus to reflect that they have or will hold `frameCount` frames.
+
+   @param bus the bus to update
+   @param frameCount the number of frames. Must not be more than `capacity`.
+   */
+  void setFrameCount(size_t bus, AUAudioFrameCount frameCount) noexcept {
+    assert(frameCount <= maxFrames_);
+    auto bufferList = mutableAudioBufferList(bus);
+    UInt32 byteSize = frameCount * sizeof(AUValue);
+    for (UInt32 channel = 0; channel < channelCount_; ++channel) bufferList->mBuffers[channel].mDataByteSize = byteSize;
+  }
+
+  /**
+   Update the buffers of all busses to reflect that they have or will hold `frameCount` frames.
+
+   @param frameCount the number of frames. Must not be more than `capacity`.
+   */
+  void setFrameCount(AUAudioFrameCount frameCount) noexcept {
+    for (size_t bus = 0; bus < busCount_; ++bus) setFrameCount(bus, frameCount);
+  }
+
+  /**
+   Obtain the `AudioBufferList` of a bus.
+
+   @param bus the bus to access
+   @returns pointer to the buffer list
+   */
+  AudioBufferList* mutableAudioBufferList(size_t bus) const noexcept {
+    assert(bus < busCount_);
+    return reinterpret_cast<AudioBufferList*>(storage_.get() + bus * listSize_);
+  }
+
+  /**
+   Obtain the storage of a channel. This does not change when a host replaces the pointers in the buffer list.
+
+   @param bus the bus to access
+   @param channel the channel to access
+   @returns pointer to the first sample
+   */
+  AUValue* samples(size_t bus, size_t channel) const noexcept {
+    return reinterpret_cast<AUValue*>(storage_.get() + samplesOffset_) + (bus * channelCount_ + channel) * stride_;
+  }
+
+  /// @returns the number of busses held
+  size_t busCount() const noexcept { return busCount_; }
+
+  /// @returns the number of channels in each bus
+  size_t channelCount() const noexcept { return channelCount_; }
+
+  /// @returns the maximum number of frames in a channel
+  AUAudioFrameCount capacity() const noexcept { return maxFrames_; }
+
+  /// @returns the number of samples from the start of one channel to the start of the next
+  size_t stride() const noexcept { return stride_; }
+
+private:
+
+  struct Deleter {
+    void operator()(std::byte* pointer) const noexcept { ::operator delete(pointer, std::align_val_t{alignment}); }
+  };
+
+  static constexpr size_t roundUp(size_t value, size_t multiple) noexcept {
+    return (value + multiple - 1) / multiple * multiple;
+  }
+
+  std::unique_ptr<std::byte[], Deleter> storage_{};
+  size_t allocatedSize_{0};
+  size_t busCount_{0};
+  size_t channelCount_{0};
+  AUAudioFrameCount maxFrames_{0};
+  size_t listSize_{0};
+  size_t samplesOffset_{0};
+  size_t stride_{0};
+};
+
+} // end namespace DSPHeaders
@@ -2,41 +2,83 @@
 
 #pragma once
 
-#import <string>
-
-#import <os/log.h>
-#import <AudioToolbox/AUAudioUnit.h>
 #import <algorithm>
+#import <cassert>
 #import <span>
+#import <type_traits>
 #import <vector>
 
+#import "DSPHeaders/AudioTypes.hpp"
 #import "DSPHeaders/BusBuffers.hpp"
+#import "DSPHeaders/DSP.hpp"
+#import "DSPHeaders/RenderGuard.hpp"
+
+/// Controls if `BusBufferFacet` checks the buffers it is given and reports problems with `AUAudioUnitStatus` codes. By
+/// default, this is only enabled in debug builds. When disabled, the checks are compiled out and the methods always
+/// report `noErr`.
+#if !defined(DSPHEADERS_BUFFER_VALIDATION_STRICT)
+#if defined(NDEBUG)
+#define DSPHEADERS_BUFFER_VALIDATION_STRICT 0
+#else
+#define DSPHEADERS_BUFFER_VALIDATION_STRICT 1
+#endif
+#endif
 
 namespace DSPHeaders {
 
+/**
+ Validation policies for `BasicBusBufferFacet`.
+ */
+namespace BufferValidation {
+
+/// Check buffer lists and channel counts and report problems as `AUAudioUnitStatus` codes.
+struct Strict {
+  static constexpr bool enabled = true;
+};
+
+/// Trust the caller -- no checks are made. Passing an invalid buffer list results in undefined behavior.
+struct None {
+  static constexpr bool enabled = false;
+};
+
+} // end namespace BufferValidation
+
+/// The validation policy to use for `BusBufferFacet`. Controlled by `DSPHEADERS_BUFFER_VALIDATION_STRICT`.
+using DefaultBufferValidation = std::conditional_t<DSPHEADERS_BUFFER_VALIDATION_STRICT, BufferValidation::Strict,
+                                                   BufferValidation::None>;
+
 /**
  Provides a simple view of an N-channel `AudioBufferList` as a vector of `AUValue` pointers. This is much easier to work
  with in a kernel than an `AudioBufferList` instance. In `EventProcessor`, the `AudioBufferList` value comes from a
  `BusSampleBuffer` instance, but this is not required here.
 
  Supports in-place rendering where the input buffer is used for rendering and is overwritten with output samples.
+
+ None of the methods throw since they are used on the render thread. Problems are instead reported with
+ `AUAudioUnitStatus` codes when the `Validation` policy is `BufferValidation::Strict`. With `BufferValidation::None`
+ the checks are compiled out.
  */
-struct BusBufferFacet {
+template <typename Validation = DefaultBufferValidation>
+struct BasicBusBufferFacet {
 
   /**
    Construct a new instance.
    */
-  BusBufferFacet() noexcept {}
+  BasicBusBufferFacet() noexcept {}
 
   /**
    Set the expected number of channels to support during rendering. The goal is to not encounter any memory
    allocations while rendering, so this *must* be called before rendering is started.
 
    @param channelCount the number of channels to expect
+   @returns `kAudioUnitErr_FormatNotSupported` if there are more than `BusBuffers::maxChannelCount` channels, in which
+   case the facet is left unchanged, `noErr` otherwise
    */
-  void setChannelCount(AUAudioChannelCount channelCount) noexcept {
+  AUAudioUnitStatus setChannelCount(AUAudioChannelCount channelCount) noexcept {
+    if (channelCount > BusBuffers::maxChannelCount) return kAudioUnitErr_FormatNotSupported;
     pointers_.reserve(channelCount);
     pointers_.resize(channelCount);
+    return noErr;
   }
 
   /**
@@ -46,31 +88,32 @@ struct BusBufferFacet {
    - bufferList has non-nullptr mData values -- use it as-is
    - bufferList has nullptr mData values && inPlaceSource != nullptr -- use the inPlaceSource mData elements
 
-   Note that this method will throw an exception if the channel count of either `bufferList` does not match the expected
-   channel count.
-
    @param bufferList the collection of buffers to use
    @param inPlaceSource if not nullptr, use their mData elements for storage
+   @returns `kAudioUnitErr_InvalidParameter` if there is no storage to use, `kAudioUnitErr_FormatNotSupported` if the
+   channel count of `bufferList` or `inPlaceSource` does not match the expected channel count, or `noErr`
    */
-  void assignBufferList(AudioBufferList* bufferList, AudioBufferList* inPlaceSource = nullptr) {
-    bufferList_ = bufferList;
+  AUAudioUnitStatus assignBufferList(AudioBufferList* bufferList, AudioBufferList* inPlaceSource = nullptr) noexcept {
+    if constexpr (Validation::enabled) {
+      if (bufferList == nullptr || bufferList->mNumberBuffers != pointers_.size()) [[unlikely]] {
+        return bufferList == nullptr ? kAudioUnitErr_InvalidParameter : kAudioUnitErr_FormatNotSupported;
+      }
+    }
+
     if (bufferList->mBuffers[0].mData == nullptr) {
 
       // The given bufferList does not have space to use -- attempt to perform in-place rendering.
-      if (inPlaceSource == nullptr) {
-        throw std::runtime_error("inPlaceSource == nullptr");
+      if constexpr (Validation::enabled) {
+        if (inPlaceSource == nullptr) [[unlikely]] return kAudioUnitErr_InvalidParameter;
+        if (inPlaceSource->mNumberBuffers != pointers_.size()) [[unlikely]] return kAudioUnitErr_FormatNotSupported;
       }
       for (UInt32 channel = 0; channel < bufferList->mNumberBuffers; ++channel) {
         bufferList->mBuffers[channel].mData = inPlaceSource->mBuffers[channel].mData;
       }
     }
 
-    size_t numBuffers = bufferList_->mNumberBuffers;
-    if (numBuffers != pointers_.size()) {
-      throw std::runtime_error("numBuffers != pointers_.size()");
-    }
-
-    setOffset(0);
+    bufferList_ = bufferList;
+    return setOffset(0);
   }
 
   /**
@@ -78,12 +121,14 @@ struct BusBufferFacet {
    pointers will start `offset` samples into the underlying buffer.
 
    @param offset number of samples to offset.
+   @returns `kAudioUnitErr_Uninitialized` if there is no buffer list, or `noErr`
    */
-  void setOffset(AUAudioFrameCount offset) {
-    validateBufferList();
+  AUAudioUnitStatus setOffset(AUAudioFrameCount offset) noexcept {
+    if (auto status = validateBufferList(); status != noErr) [[unlikely]] return status;
     for (size_t channel = 0; channel < pointers_.size(); ++channel) {
       pointers_[channel] = getBufferPointer(channel, offset);
     }
+    return noErr;
   }
 
   /**
@@ -91,13 +136,15 @@ struct BusBufferFacet {
    returned to Apple's audio engine that is driving the rendering.
 
    @param frameCount number of samples in a buffer.
+   @returns `kAudioUnitErr_Uninitialized` if there is no buffer list, or `noErr`
    */
-  void setFrameCount(AUAudioFrameCount frameCount) {
-    validateBufferList();
+  AUAudioUnitStatus setFrameCount(AUAudioFrameCount frameCount) noexcept {
+    if (auto status = validateBufferList(); status != noErr) [[unlikely]] return status;
     UInt32 byteSize = frameCount * sizeof(AUValue);
     for (UInt32 channel = 0; channel < bufferList_->mNumberBuffers; ++channel) {
       bufferList_->mBuffers[channel].mDataByteSize = byteSize;
     }
+    return noErr;
   }
 
   /// @returns true if the facet is linked to a buffer
@@ -105,13 +152,16 @@ struct BusBufferFacet {
 
   /**
    Release the underlying buffers.
+
+   @returns `kAudioUnitErr_Uninitialized` if there is no buffer list, or `noErr`
    */
-  void unlink() {
-    validateBufferList();
+  AUAudioUnitStatus unlink() noexcept {
+    if (auto status = validateBufferList(); status != noErr) [[unlikely]] return status;
     bufferList_ = nullptr;
     for (size_t channel = 0; channel < pointers_.size(); ++channel) {
       pointers_[channel] = nullptr;
     }
+    return noErr;
   }
 
   /**
@@ -130,12 +180,17 @@ struct BusBufferFacet {
       return kAudioUnitErr_NoConnection;
     }
 
-    validateBufferList();
+    if (auto status = validateBufferList(); status != noErr) [[unlikely]] return status;
     if (frameCount * sizeof(AUValue) > bufferList_->mBuffers[0].mDataByteSize) [[unlikely]] {
       return kAudioUnitErr_TooManyFramesToProcess;
     }
 
     setFrameCount(frameCount);
+
+#if DSPHEADERS_RENDER_GUARD_ENABLED
+    // Rendering done upstream is not the concern of the kernel.
+    RenderGuard::Suspend suspend{};
+#endif
     return pullInputBlock(actionFlags, timestamp, frameCount, inputBusNumber, bufferList_);
   }
 
@@ -146,9 +201,12 @@ struct BusBufferFacet {
    @param destination the buffer to copy into
    @param offset the offset to apply before writing
    @param frameCount the number of samples to write
+   @returns `kAudioUnitErr_Uninitialized` if either facet has no buffer list, or `noErr`
    */
-  void copyInto(BusBufferFacet& destination, AUAudioFrameCount offset, AUAudioFrameCount frameCount) const {
-    validateBufferList();
+  AUAudioUnitStatus copyInto(BasicBusBufferFacet& destination, AUAudioFrameCount offset,
+                             AUAudioFrameCount frameCount) const noexcept {
+    if (auto status = validateBufferList(); status != noErr) [[unlikely]] return status;
+    if (auto status = destination.validateBufferList(); status != noErr) [[unlikely]] return status;
     auto outputs = destination.bufferList_;
     for (UInt32 channel = 0; channel < bufferList_->mNumberBuffers; ++channel) {
       if (bufferList_->mBuffers[channel].mData == outputs->mBuffers[channel].mData) {
@@ -159,6 +217,7 @@ struct BusBufferFacet {
       auto out = destination.getBufferPointer(channel, offset);
       std::copy_n(in, frameCount, out);
     }
+    return noErr;
   }
 
   /**
@@ -173,10 +232,31 @@ struct BusBufferFacet {
     }
   }
 
+  /**
+   Determine if the first N frames of all channels hold nothing but zeros.
+
+   @param frameCount the number of frames to check
+   @returns true if all samples are zero
+   */
+  bool isSilent(AUAudioFrameCount frameCount) const noexcept {
+    for (UInt32 channel = 0; channel < bufferList_->mNumberBuffers; ++channel) {
+      if (!DSP::isSilent(getBufferPointer(channel, 0), frameCount)) return false;
+    }
+    return true;
+  }
+
+  /**
+   Obtain the samples of a channel from the start of the buffer, regardless of any offset set by `setOffset`.
+
+   @param channel the channel to access
+   @returns pointer to the first sample
+   */
+  const AUValue* channelSamples(size_t channel) const noexcept { return getBufferPointer(channel, 0); }
+
   /// @returns the number of channels that are currently supported
   size_t channelCount() const noexcept { return pointers_.size(); }
 
-  /// @returns new BusBuffers instance that refers to our collection of AUValue pointers for storing render samples.
+  /// @returns new BusBuffers instance that holds a copy of our AUValue pointers for storing render samples.
   BusBuffers busBuffers() noexcept {
     return BusBuffers(pointers_);
   }
@@ -187,14 +267,18 @@ private:
     return static_cast<AUValue*>(bufferList_->mBuffers[channel].mData) + offset;
   }
 
-  void validateBufferList() const {
-    if (bufferList_ == nullptr) [[unlikely]] {
-      throw std::runtime_error("bufferList_ == nullptr");
+  AUAudioUnitStatus validateBufferList() const noexcept {
+    if constexpr (Validation::enabled) {
+      if (bufferList_ == nullptr) [[unlikely]] return kAudioUnitErr_Uninitialized;
     }
+    return noErr;
   }
 
   AudioBufferList* bufferList_{nullptr};
   std::vector<AUValue*> pointers_{};
 };
 
+/// The facet used by `EventProcessor`, with validation set by `DSPHEADERS_BUFFER_VALIDATION_STRICT`.
+using BusBufferFacet = BasicBusBufferFacet<>;
+
 } // end namespace DSPHeaders
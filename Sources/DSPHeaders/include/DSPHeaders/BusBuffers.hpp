@@ -2,12 +2,16 @@
 
 #pragma once
 
+#import <algorithm>
+#import <array>
 #import <cassert>
 #import <cmath>
+#import <numbers>
 #import <span>
-#import <vector>
+#import <type_traits>
 
-#import <AudioToolbox/AudioToolbox.h>
+#import "DSPHeaders/AudioTypes.hpp"
+#import "DSPHeaders/SIMD.hpp"
 
 namespace DSPHeaders {
 
@@ -16,38 +20,75 @@ namespace DSPHeaders {
  two (stereo) channels of audio. There are methods specific to mono and stereo as well as general-purpose methods for
  treating them all the same or as alternating variations like stereo but as even (0/L) and odd (1/R) pairs.
 
- Note that this class only holds a refernce to the collection that is used. The collection must not go out of scope
- while an instance of this class exists. In `EventProcessor` it is only used to pass the sample pointers to the
- kernel for rendering.
+ The channel pointers are held inline, so an instance is a small value that is meant to be passed by value -- for
+ instance to a kernel's `doRendering` method -- which lets the compiler keep the pointers in registers instead of
+ reaching them through the heap. Changing a pointer with `operator[]` or `shiftOver` only affects this instance.
+
+ Besides the per-frame `add` methods there are block methods that work on a range of frames in all channels at once
+ using the SIMD instructions of the platform (see `SIMD.hpp`). These are much faster when a kernel can do its work in
+ stages over a whole render block. Each takes the number of frames to process and an optional offset to the first
+ one. Methods that read from another `BusBuffers` instance require it to have at least as many channels.
  */
 class BusBuffers {
 public:
 
+  /// The max number of channels in a bus. Matches `FilterAudioUnit.audioBusMaxNumberOfChannels`.
+  static constexpr size_t maxChannelCount = 8;
+
   /**
-   Construct a new instance using the given collection of AUValue pointers.
+   Construct a new instance using the given collection of AUValue pointers. There must not be more than
+   `maxChannelCount` of them -- the methods that set up a rendering format reject larger channel counts before any
+   rendering takes place.
 
    @param buffers the AUValue pointers to use
    */
-  explicit BusBuffers(std::vector<AUValue*>& buffers) noexcept : buffers_{buffers} {}
+  explicit BusBuffers(std::span<AUValue* const> buffers) noexcept : size_{buffers.size()} {
+    assert(buffers.size() <= maxChannelCount);
+    std::copy_n(buffers.begin(), size_, buffers_.begin());
+  }
 
-  BusBuffers() = delete;
+  /// Construct an empty instance that is not valid.
+  BusBuffers() noexcept = default;
 
-  BusBuffers(const BusBuffers& other) = default;
+  BusBuffers(const BusBuffers& other) noexcept = default;
 
-  BusBuffers(BusBuffers&& other) = default;
+  BusBuffers(BusBuffers&& other) noexcept = default;
 
-  BusBuffers& operator =(BusBuffers&&) = delete;
+  BusBuffers& operator =(BusBuffers&&) noexcept = default;
 
-  BusBuffers& operator =(const BusBuffers&) = delete;
+  BusBuffers& operator =(const BusBuffers&) noexcept = default;
 
   /// @returns true if the buffer collection is usable
-  bool isValid() const noexcept { return !buffers_.empty(); }
+  bool isValid() const noexcept { return size_ > 0; }
 
   /// @returns true if the buffer collection is mono (1 channel)
-  bool isMono() const noexcept { return buffers_.size() == 1; }
+  bool isMono() const noexcept { return size_ == 1; }
 
   /// @returns true if the buffer collection is stereo (2 channel)
-  bool isStereo() const noexcept { return buffers_.size() > 1; }
+  bool isStereo() const noexcept { return size_ > 1; }
+
+  /**
+   Invoke a function with the number of channels. For mono and stereo busses the count is given as a
+   `std::integral_constant` so that loops over the channels in `proc` have a fixed trip count and are unrolled by the
+   compiler. For other busses it is given as a `size_t`. For example:
+
+   ```
+   outs.withChannelCount([&](auto channelCount) {
+     for (size_t channel = 0; channel < channelCount; ++channel) { ... }
+   });
+   ```
+
+   @param proc the function to invoke. It must return the same type for all channel counts.
+   @returns the value returned by `proc`
+   */
+  template <typename Proc>
+  decltype(auto) withChannelCount(Proc&& proc) const {
+    switch (size_) {
+      case 1: return proc(std::integral_constant<size_t, 1>{});
+      case 2: return proc(std::integral_constant<size_t, 2>{});
+      default: return proc(size_);
+    }
+  }
 
   /**
    Add a sample to the existing frame of a mono collection.
@@ -80,9 +121,11 @@ public:
    @param sample the value to update with
    */
   void addAll(AUAudioFrameCount frame, AUValue sample) noexcept {
-    for (auto& buffer : buffers_) {
-      buffer[frame] += sample;
-    }
+    withChannelCount([&](auto channelCount) {
+      for (size_t index = 0; index < channelCount; ++index) {
+        buffers_[index][frame] += sample;
+      }
+    });
   }
 
   /**
@@ -94,10 +137,144 @@ public:
    @param oddSample the sample to update odd (1 (R), 3, 5....) channels with
    */
   void addAlternating(AUAudioFrameCount frame, AUValue evenSample, AUValue oddSample) noexcept {
-    size_t size{buffers_.size()};
-    for (size_t index = 0; index < size; ++index) {
-      buffers_[index][frame] += (index % 2) ? oddSample : evenSample;
-    }
+    withChannelCount([&](auto channelCount) {
+      size_t index = 0;
+      for (; index + 1 < channelCount; index += 2) {
+        buffers_[index][frame] += evenSample;
+        buffers_[index + 1][frame] += oddSample;
+      }
+      if (index < channelCount) buffers_[index][frame] += evenSample;
+    });
+  }
+
+  /**
+   Copy samples from another collection.
+
+   @param source the samples to copy
+   @param frameCount the number of frames to copy
+   @param offset the index of the first frame to copy
+   */
+  void copyFrom(const BusBuffers& source, AUAudioFrameCount frameCount, AUAudioFrameCount offset = 0) noexcept {
+    forEachChannel(source, [=](const AUValue* in, AUValue* out) {
+      std::copy_n(in + offset, frameCount, out + offset);
+    });
+  }
+
+  /**
+   Add samples from another collection.
+
+   @param source the samples to add
+   @param frameCount the number of frames to add
+   @param offset the index of the first frame to add
+   */
+  void addFrom(const BusBuffers& source, AUAudioFrameCount frameCount, AUAudioFrameCount offset = 0) noexcept {
+    forEachChannel(source, [=](const AUValue* in, AUValue* out) { SIMD::add(in + offset, out + offset, frameCount); });
+  }
+
+  /**
+   Add samples from another collection after scaling them by a gain.
+
+   @param source the samples to add
+   @param gain the scaling to apply to the source samples
+   @param frameCount the number of frames to add
+   @param offset the index of the first frame to add
+   */
+  void mixFrom(const BusBuffers& source, AUValue gain, AUAudioFrameCount frameCount,
+               AUAudioFrameCount offset = 0) noexcept {
+    forEachChannel(source, [=](const AUValue* in, AUValue* out) {
+      SIMD::addScaled(in + offset, gain, out + offset, frameCount);
+    });
+  }
+
+  /**
+   Add samples from another collection after scaling them by per-frame gains, such as those from
+   `Parameters::Base::fillFrameValues`.
+
+   @param source the samples to add
+   @param gains the scaling to apply to the source samples, one per frame. Its size is the number of frames to add.
+   @param offset the index of the first frame to add
+   */
+  void mixFrom(const BusBuffers& source, std::span<const AUValue> gains, AUAudioFrameCount offset = 0) noexcept {
+    forEachChannel(source, [=](const AUValue* in, AUValue* out) {
+      SIMD::addProduct(in + offset, gains.data(), out + offset, gains.size());
+    });
+  }
+
+  /**
+   Scale samples by a gain.
+
+   @param gain the scaling to apply
+   @param frameCount the number of frames to scale
+   @param offset the index of the first frame to scale
+   */
+  void applyGain(AUValue gain, AUAudioFrameCount frameCount, AUAudioFrameCount offset = 0) noexcept {
+    forEachChannel([=](AUValue* out) { SIMD::scale(out + offset, gain, frameCount); });
+  }
+
+  /**
+   Scale samples by per-frame gains.
+
+   @param gains the scaling to apply, one per frame. Its size is the number of frames to scale.
+   @param offset the index of the first frame to scale
+   */
+  void applyGain(std::span<const AUValue> gains, AUAudioFrameCount offset = 0) noexcept {
+    forEachChannel([=](AUValue* out) { SIMD::multiply(gains.data(), out + offset, gains.size()); });
+  }
+
+  /**
+   Scale samples by a gain that moves linearly from `startGain` towards `endGain`. The first frame is scaled by
+   `startGain` and the frame that follows the last one would be scaled by `endGain`, so that consecutive ramps join up
+   without repeating a gain value.
+
+   @param startGain the scaling to apply to the first frame
+   @param endGain the scaling to reach at the end of the ramp
+   @param frameCount the number of frames to scale
+   @param offset the index of the first frame to scale
+   */
+  void applyGainRamp(AUValue startGain, AUValue endGain, AUAudioFrameCount frameCount,
+                     AUAudioFrameCount offset = 0) noexcept {
+    if (frameCount == 0) return;
+    auto step = (endGain - startGain) / AUValue(frameCount);
+    forEachChannel([=](AUValue* out) { SIMD::scaleRamp(out + offset, startGain, step, frameCount); });
+  }
+
+  /**
+   Write mono samples to the two channels of a stereo collection with a constant-power pan law. The center position
+   attenuates both channels by 3 dB.
+
+   @param source the mono samples to read
+   @param position the pan position from -1 (hard left) to +1 (hard right)
+   @param frameCount the number of frames to write
+   @param offset the index of the first frame to read and write
+   */
+  void panFrom(const AUValue* source, AUValue position, AUAudioFrameCount frameCount,
+               AUAudioFrameCount offset = 0) noexcept {
+    assert(isStereo());
+    auto angle = (std::clamp(position, AUValue(-1.0), AUValue(1.0)) + 1) * std::numbers::pi_v<AUValue> / 4;
+    SIMD::pan(source + offset, std::cos(angle), std::sin(angle), buffers_[0] + offset, buffers_[1] + offset,
+              frameCount);
+  }
+
+  /**
+   Convert the left and right channels of a stereo collection in place into mid (L + R) / 2 and side (L - R) / 2.
+
+   @param frameCount the number of frames to convert
+   @param offset the index of the first frame to convert
+   */
+  void encodeMidSide(AUAudioFrameCount frameCount, AUAudioFrameCount offset = 0) noexcept {
+    assert(isStereo());
+    SIMD::sumAndDifference(buffers_[0] + offset, buffers_[1] + offset, 0.5f, frameCount);
+  }
+
+  /**
+   Convert the mid and side channels of a stereo collection in place back into left (M + S) and right (M - S).
+
+   @param frameCount the number of frames to convert
+   @param offset the index of the first frame to convert
+   */
+  void decodeMidSide(AUAudioFrameCount frameCount, AUAudioFrameCount offset = 0) noexcept {
+    assert(isStereo());
+    SIMD::sumAndDifference(buffers_[0] + offset, buffers_[1] + offset, 1.0f, frameCount);
   }
 
   /**
@@ -124,13 +301,13 @@ public:
    @param frames the amount to shift
    */
   void shiftOver(AUAudioFrameCount frames) noexcept {
-    for (auto& buffer : buffers_ ) {
-      buffer += frames;
+    for (size_t index = 0; index < size_; ++index) {
+      buffers_[index] += frames;
     }
   }
 
   /// @returns number of channel buffers
-  size_t size() const noexcept { return buffers_.size(); }
+  size_t size() const noexcept { return size_; }
 
   /// @returns pointer to first AUValue pointer (first channel in bundle)
   AUValue* const* data() const noexcept { return buffers_.data(); }
@@ -139,7 +316,24 @@ public:
   AUValue** data() noexcept { return buffers_.data(); }
 
 private:
-  std::vector<AUValue*>& buffers_;
+
+  template <typename Proc>
+  void forEachChannel(Proc&& proc) noexcept {
+    withChannelCount([&](auto channelCount) {
+      for (size_t index = 0; index < channelCount; ++index) proc(buffers_[index]);
+    });
+  }
+
+  template <typename Proc>
+  void forEachChannel(const BusBuffers& source, Proc&& proc) noexcept {
+    assert(source.size() >= size_);
+    withChannelCount([&](auto channelCount) {
+      for (size_t index = 0; index < channelCount; ++index) proc(source.buffers_[index], buffers_[index]);
+    });
+  }
+
+  std::array<AUValue*, maxChannelCount> buffers_{};
+  size_t size_{0};
 };
 
 } // end namespace
@@ -0,0 +1,177 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <algorithm>
+#import <array>
+#import <cmath>
+#import <cstdint>
+
+#import "DSPHeaders/AudioTypes.hpp"
+#import "DSPHeaders/BusBufferFacet.hpp"
+#import "DSPHeaders/DSP.hpp"
+#import "DSPHeaders/TripleBuffer.hpp"
+
+namespace DSPHeaders {
+
+/**
+ Level meter and oscilloscope feed for the samples of one bus. The render thread calls `process` with each buffer it
+ renders. Once a window's worth of frames has gone by, the peak and RMS levels of each channel over the window are
+ published along with the latest decimated samples for a scope display. A UI thread can obtain the latest reading at
+ any time via `read` without blocking the render thread.
+
+ Only the first `maxChannels` channels of a bus are measured.
+ */
+class BusMeter {
+public:
+
+  /// The max number of channels that are measured.
+  static constexpr size_t maxChannels = 8;
+
+  /// The max number of scope samples held for each channel.
+  static constexpr size_t scopeSize = 256;
+
+  /**
+   Measurements over one window of frames.
+   */
+  struct Reading {
+    /// The number of readings published before this one. Shows when a reading is new.
+    uint64_t sequence{0};
+    /// The number of valid entries in `peak`, `rms`, and `scope`.
+    size_t channelCount{0};
+    /// The largest sample magnitude in each channel.
+    std::array<AUValue, maxChannels> peak{};
+    /// The RMS level of each channel.
+    std::array<AUValue, maxChannels> rms{};
+    /// The number of valid samples in each `scope` channel. Zero if the scope is disabled.
+    size_t scopeLength{0};
+    /// The most recent decimated samples of each channel, oldest first.
+    std::array<std::array<AUValue, scopeSize>, maxChannels> scope{};
+  };
+
+  BusMeter() noexcept = default;
+
+  BusMeter(const BusMeter&) = delete;
+  BusMeter& operator=(const BusMeter&) = delete;
+
+  /**
+   Set the measurement parameters. Must not be called while `process` could run.
+
+   @param sampleRate the sample rate of the samples being measured
+   @param channelCount the number of channels to measure
+   @param windowSeconds the duration of the window over which to measure levels
+   @param scopeDecimation if not zero, record every Nth sample for the scope
+   */
+  void configure(double sampleRate, AUAudioChannelCount channelCount, double windowSeconds,
+                 size_t scopeDecimation = 0) noexcept {
+    channelCount_ = std::min<size_t>(channelCount, maxChannels);
+    windowFrames_ = std::max<uint64_t>(1, uint64_t(std::round(sampleRate * windowSeconds)));
+    scopeDecimation_ = scopeDecimation;
+    reset();
+  }
+
+  /**
+   Measure the samples of a buffer. Only call from the render thread.
+
+   @param facet the buffer holding the samples
+   @param frameCount the number of frames in the buffer
+   */
+  void process(const BusBufferFacet& facet, AUAudioFrameCount frameCount) noexcept {
+    auto channelCount = std::min(channelCount_, facet.channelCount());
+    for (size_t channel = 0; channel < channelCount; ++channel) {
+      auto samples = facet.channelSamples(channel);
+      auto [peak, sum] = DSP::peakAndSumOfSquares(samples, frameCount);
+      peaks_[channel] = std::max(peaks_[channel], peak);
+      sums_[channel] += sum;
+      if (scopeDecimation_ > 0) recordScope(channel, samples, frameCount);
+    }
+
+    if (scopeDecimation_ > 0) advanceScope(frameCount);
+    frames_ += frameCount;
+    if (frames_ >= windowFrames_) publish();
+  }
+
+  /**
+   Obtain the latest reading. Only call from one reader thread. The reference stays valid and unchanged until the next
+   call.
+
+   @returns the latest reading
+   */
+  const Reading& read() noexcept { return readings_.read(); }
+
+  /**
+   Clear the measurements in progress. Only call from the render thread or when it is not running.
+   */
+  void reset() noexcept {
+    peaks_.fill(0.0);
+    sums_.fill(0.0);
+    frames_ = 0;
+    scopePhase_ = 0;
+    scopeWrite_ = 0;
+    scopeCount_ = 0;
+  }
+
+private:
+
+  void recordScope(size_t channel, const AUValue* samples, AUAudioFrameCount frameCount) noexcept {
+    auto& history{scopeHistory_[channel]};
+    auto write = scopeWrite_;
+    for (size_t frame = scopePhase_; frame < frameCount; frame += scopeDecimation_) {
+      history[write] = samples[frame];
+      write = (write + 1) % scopeSize;
+    }
+  }
+
+  void advanceScope(AUAudioFrameCount frameCount) noexcept {
+    if (scopePhase_ >= frameCount) {
+      scopePhase_ -= frameCount;
+      return;
+    }
+    auto recorded = (frameCount - scopePhase_ + scopeDecimation_ - 1) / scopeDecimation_;
+    scopeWrite_ = (scopeWrite_ + recorded) % scopeSize;
+    scopeCount_ = std::min(scopeCount_ + recorded, scopeSize);
+    scopePhase_ = scopePhase_ + recorded * scopeDecimation_ - frameCount;
+  }
+
+  void publish() noexcept {
+    auto& reading{readings_.writeValue()};
+    reading.sequence = sequence_++;
+    reading.channelCount = channelCount_;
+    reading.scopeLength = scopeCount_;
+    for (size_t channel = 0; channel < channelCount_; ++channel) {
+      reading.peak[channel] = peaks_[channel];
+      reading.rms[channel] = std::sqrt(sums_[channel] / AUValue(frames_));
+      if (scopeCount_ > 0) {
+        // Unroll the history ring so that the oldest sample comes first.
+        auto& history{scopeHistory_[channel]};
+        auto start = (scopeWrite_ + scopeSize - scopeCount_) % scopeSize;
+        auto firstPart = std::min(scopeCount_, scopeSize - start);
+        std::copy_n(history.begin() + long(start), firstPart, reading.scope[channel].begin());
+        std::copy_n(history.begin(), scopeCount_ - firstPart, reading.scope[channel].begin() + long(firstPart));
+      }
+    }
+    readings_.publish();
+
+    peaks_.fill(0.0);
+    sums_.fill(0.0);
+    frames_ = 0;
+  }
+
+  size_t channelCount_{0};
+  uint64_t windowFrames_{1};
+  size_t scopeDecimation_{0};
+
+  std::array<AUValue, maxChannels> peaks_{};
+  std::array<AUValue, maxChannels> sums_{};
+  uint64_t frames_{0};
+  uint64_t sequence_{0};
+
+  std::array<std::array<AUValue, scopeSize>, maxChannels> scopeHistory_{};
+  size_t scopePhase_{0};
+  size_t scopeWrite_{0};
+  size_t scopeCount_{0};
+
+  TripleBuffer<Reading> readings_{};
+};
+
+} // end namespace DSPHeaders
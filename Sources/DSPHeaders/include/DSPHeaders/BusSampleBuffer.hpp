@@ -3,20 +3,18 @@
 #pragma once
 
 #import <cassert>
-#import <string>
+#import <stdexcept>
 
-#import <os/log.h>
-#import <AudioToolbox/AudioToolbox.h>
-#import <AudioUnit/AudioUnit.h>
-#import <AVFoundation/AVFoundation.h>
+#import "DSPHeaders/AudioTypes.hpp"
+#import "DSPHeaders/BufferArena.hpp"
 
 namespace DSPHeaders {
 
 /**
  Maintains a collection of PCM samples which can be used to store samples from an upstream node and to save rendered
- samples. Internally uses an `AVAudioPCMBuffer` to deal with specifics involving the audio format. Note that this
- represents N channel buffers, where the number of channels is set by the audio format's channel layout definition.
- All channel buffers will hold the same number of frames / samples.
+ samples. Note that this represents N channel buffers, all of which hold the same number of frames / samples. The
+ samples are always non-interleaved `AUValue` values held in a `BufferArena`, so each channel is 64-byte aligned and
+ the same code is used on all platforms.
  */
 struct BusSampleBuffer {
 
@@ -25,28 +23,37 @@ struct BusSampleBuffer {
    */
   BusSampleBuffer() noexcept {}
 
+#if defined(__APPLE__)
   /**
-   Set the format of the buffer to use.
-   
+   Set the format of the buffer to use. Only the channel count of the format is used.
+
    @param format the format of the samples
    @param maxFrames the maximum number of frames to be found in the upstream output
    */
   void allocate(AVAudioFormat* format, AUAudioFrameCount maxFrames) noexcept {
+    allocate(format.channelCount, maxFrames);
+  }
+#endif
+
+  /**
+   Set the number of non-interleaved `AUValue` channels to hold.
+
+   @param channelCount the number of channels to support
+   @param maxFrames the maximum number of frames to be found in the upstream output
+   */
+  void allocate(AUAudioChannelCount channelCount, AUAudioFrameCount maxFrames) noexcept {
     maxFramesToRender_ = maxFrames;
-    buffer_ = [[AVAudioPCMBuffer alloc] initWithPCMFormat: format frameCapacity: maxFrames];
-    mutableAudioBufferList_ = buffer_.mutableAudioBufferList;
+    arena_.allocate(1, channelCount, maxFrames);
   }
-  
+
   /**
    Forget any allocated buffer.
    */
   void release() {
-    if (buffer_ == nullptr) {
-      throw std::runtime_error("buffer_ == nullptr");
+    if (arena_.busCount() == 0) {
+      throw std::runtime_error("no buffer allocated");
     }
-
-    buffer_ = nullptr;
-    mutableAudioBufferList_ = nullptr;
+    arena_.release();
   }
   
   /**
@@ -56,28 +63,24 @@ struct BusSampleBuffer {
    @param frameCount the number of frames to expect to place in the buffer
    */
   void setFrameCount(AVAudioFrameCount frameCount) noexcept {
-    assert(frameCount <= maxFramesToRender_ && mutableAudioBufferList_ != nullptr);
-    UInt32 byteSize = frameCount * sizeof(AUValue);
-    for (UInt32 channel = 0; channel < mutableAudioBufferList_->mNumberBuffers; ++channel) {
-      mutableAudioBufferList_->mBuffers[channel].mDataByteSize = byteSize;
-    }
+    assert(frameCount <= maxFramesToRender_ && arena_.busCount() != 0);
+    arena_.setFrameCount(0, frameCount);
   }
 
   /// Obtain the maximum size of the input buffer
   AUAudioFrameCount capacity() const noexcept { return maxFramesToRender_; }
 
   /// Obtain a mutable version of the internal AudioBufferList.
-  AudioBufferList* mutableAudioBufferList() const noexcept { return mutableAudioBufferList_; }
+  AudioBufferList* mutableAudioBufferList() const noexcept {
+    return arena_.busCount() != 0 ? arena_.mutableAudioBufferList(0) : nullptr;
+  }
 
   /// Obtain the number of channels in the buffer
-  size_t channelCount() const noexcept {
-    return mutableAudioBufferList_ != nullptr ? mutableAudioBufferList_->mNumberBuffers : 0;
-  }
+  size_t channelCount() const noexcept { return arena_.channelCount(); }
 
 private:
   AUAudioFrameCount maxFramesToRender_{0};
-  AVAudioPCMBuffer* buffer_{nullptr};
-  AudioBufferList* mutableAudioBufferList_{nullptr};
+  BufferArena arena_{};
 };
 
 } // end namespace DSPHeaders
@@ -0,0 +1,64 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <cstdint>
+#import <limits>
+
+#import "DSPHeaders/AudioTypes.hpp"
+
+namespace DSPHeaders {
+
+/**
+ Message sent from a UI thread to the render thread via `EventProcessor::postCommand`. A command either changes a
+ parameter value, or it carries a kernel-specific request such as a waveform change, a table swap, or a reset which the
+ kernel handles in its `doCommand` method.
+ */
+struct Command {
+
+  /// Sample time to use for a command that should be applied at the start of the next render call.
+  static constexpr AUEventSampleTime immediate = std::numeric_limits<AUEventSampleTime>::min();
+
+  enum class Kind : uint8_t {
+    parameter,
+    custom
+  };
+
+  /**
+   Create a command that changes a parameter value.
+
+   @param address the address of the parameter to change
+   @param value the new value for the parameter
+   @param rampDuration the number of frames to ramp to the new value
+   @param sampleTime the earliest sample time to apply the command
+   @returns new command
+   */
+  static constexpr Command parameter(AUParameterAddress address, AUValue value, AUAudioFrameCount rampDuration = 0,
+                                     AUEventSampleTime sampleTime = immediate) noexcept {
+    return {Kind::parameter, sampleTime, address, value, rampDuration, 0, nullptr};
+  }
+
+  /**
+   Create a command for the kernel to handle.
+
+   @param code kernel-defined identifier for the command
+   @param value optional value to go with the command
+   @param data optional pointer to go with the command. The sender owns whatever it points to.
+   @param sampleTime the earliest sample time to apply the command
+   @returns new command
+   */
+  static constexpr Command custom(uint32_t code, AUValue value = 0.0, void* _Nullable data = nullptr,
+                                  AUEventSampleTime sampleTime = immediate) noexcept {
+    return {Kind::custom, sampleTime, 0, value, 0, code, data};
+  }
+
+  Kind kind;
+  AUEventSampleTime sampleTime;
+  AUParameterAddress address;
+  AUValue value;
+  AUAudioFrameCount rampDuration;
+  uint32_t code;
+  void* _Nullable data;
+};
+
+} // end namespace DSPHeaders
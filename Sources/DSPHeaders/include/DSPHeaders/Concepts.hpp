@@ -1,11 +1,13 @@
 // Copyright © 2024-2025 Brad Howes. All rights reserved.
 
 #import <concepts>
+#import <span>
 #import <type_traits>
 
-#import <AVFoundation/AVFoundation.h>
-
+#import "DSPHeaders/AudioTypes.hpp"
 #import "DSPHeaders/BusBuffers.hpp"
+#import "DSPHeaders/Command.hpp"
+#import "DSPHeaders/MIDI2.hpp"
 
 namespace DSPHeaders {
 
@@ -43,6 +45,13 @@ concept HasMIDIEventV1 = requires(T a, const AUMIDIEvent& midi)
   { a.doMIDIEvent(midi) } -> std::convertible_to<void>;
 };
 
+/// Concept definition for a Kernel class with an optional `doMIDI2Event` method.
+template<typename T>
+concept HasMIDIEventV2 = requires(T a, const MIDI2::Event& event)
+{
+  { a.doMIDI2Event(event) } -> std::convertible_to<void>;
+};
+
 /// Concept definition for a Kernel class with an optional `doSetImmediateParameterValue` method.
 template<typename T>
 concept HasSetImmediateParameterValue = requires(T a, AUParameterAddress address, AUValue value,
@@ -72,12 +81,45 @@ concept HasGetPendingParameterValue = requires(T a, AUParameterAddress address)
   { a.doGetPendingParameterValue(address) } -> std::convertible_to<AUValue>;
 };
 
-/// Concept definition for a valid Kernel class, one that provides method definitions for the functions
-/// used by the EventProcessor template.
+/// Concept definition for a Kernel class with an optional `doCommand` method.
 template<typename T>
-concept IsViableKernelType = requires(T a, const AUParameterEvent& param, const AUMIDIEvent& midi, BusBuffers bb)
+concept HasCommand = requires(T a, const Command& command)
+{
+  { a.doCommand(command) } -> std::convertible_to<void>;
+};
+
+/// Concept definition for a Kernel class with an optional `doTailFrameCount` method. A kernel that provides it declares
+/// that its output decays to silence within that many frames once its input becomes silent.
+template<typename T>
+concept HasTailFrameCount = requires(T a)
+{
+  { a.doTailFrameCount() } -> std::convertible_to<AUAudioFrameCount>;
+};
+
+/// Concept definition for a Kernel class with a `doRendering` method that renders one output bus at a time.
+template<typename T>
+concept HasSingleBusRendering = requires(T a, BusBuffers bb)
 {
   { a.doRendering(bb, bb, AUAudioFrameCount(1) ) } -> std::convertible_to<void>;
 };
 
+/// Concept definition for a Kernel class with a `doRendering` method that renders all of its output busses at once.
+template<typename T>
+concept HasMultiBusRendering = requires(T a, BusBuffers bb, std::span<BusBuffers> outputs)
+{
+  { a.doRendering(bb, outputs, AUAudioFrameCount(1) ) } -> std::convertible_to<void>;
+};
+
+/// Concept definition for a Kernel class with a `doRendering` method that takes the buffers of all of its input busses.
+template<typename T>
+concept HasMultiInputRendering = requires(T a, std::span<BusBuffers> inputs, BusBuffers bb)
+{
+  { a.doRendering(inputs, bb, AUAudioFrameCount(1) ) } -> std::convertible_to<void>;
+};
+
+/// Concept definition for a valid Kernel class, one that provides method definitions for the functions
+/// used by the EventProcessor template.
+template<typename T>
+concept IsViableKernelType = HasSingleBusRendering<T> || HasMultiBusRendering<T> || HasMultiInputRendering<T>;
+
 }
@@ -4,8 +4,11 @@
 
 #import <algorithm>
 #import <array>
+#import <bit>
 #import <cassert>
 #import <cmath>
+#import <cstdint>
+#import <utility>
 
 #import "DSPHeaders/ConstMath.hpp"
 
@@ -78,6 +81,67 @@ constexpr auto parabolicSine(ValueType angle) noexcept {
   return Py * ConstMath::abs<>(y) - Py + y;
 }
 
+/**
+ Determine if all samples in a buffer are zero (either +0.0 or -0.0). The samples are checked as integers in blocks of
+ 16 by OR-ing their bits together without any branching, which the compiler turns into SIMD instructions. The check
+ stops at the end of the first block that holds a non-zero sample.
+
+ @param samples pointer to the first sample to check
+ @param count the number of samples to check
+ @returns true if all samples are zero
+ */
+inline bool isSilent(const float* samples, size_t count) noexcept {
+  constexpr size_t blockSize = 16;
+  constexpr uint32_t signMask = 0x7FFFFFFF;
+  size_t index = 0;
+  for (; index + blockSize <= count; index += blockSize) {
+    uint32_t bits = 0;
+    for (size_t offset = 0; offset < blockSize; ++offset) bits |= std::bit_cast<uint32_t>(samples[index + offset]);
+    if ((bits & signMask) != 0) return false;
+  }
+
+  uint32_t bits = 0;
+  for (; index < count; ++index) bits |= std::bit_cast<uint32_t>(samples[index]);
+  return (bits & signMask) == 0;
+}
+
+/**
+ Obtain the largest magnitude and the sum of the squares of the samples in a buffer. The samples are processed in
+ blocks of 8 with a separate accumulator for each lane so that there is no dependency between adjacent samples, which
+ lets the compiler turn the loop into SIMD instructions.
+
+ @param samples pointer to the first sample to process
+ @param count the number of samples to process
+ @returns pair of peak magnitude and sum of squares
+ */
+inline std::pair<float, float> peakAndSumOfSquares(const float* samples, size_t count) noexcept {
+  constexpr size_t laneCount = 8;
+  std::array<float, laneCount> peaks{};
+  std::array<float, laneCount> sums{};
+  size_t index = 0;
+  for (; index + laneCount <= count; index += laneCount) {
+    for (size_t lane = 0; lane < laneCount; ++lane) {
+      auto sample = samples[index + lane];
+      peaks[lane] = std::max(peaks[lane], std::abs(sample));
+      sums[lane] += sample * sample;
+    }
+  }
+
+  for (size_t lane = 0; index < count; ++index, ++lane) {
+    auto sample = samples[index];
+    peaks[lane] = std::max(peaks[lane], std::abs(sample));
+    sums[lane] += sample * sample;
+  }
+
+  float peak = 0.0f;
+  float sum = 0.0f;
+  for (size_t lane = 0; lane < laneCount; ++lane) {
+    peak = std::max(peak, peaks[lane]);
+    sum += sums[lane];
+  }
+  return {peak, sum};
+}
+
 namespace Interpolation {
 
 /**
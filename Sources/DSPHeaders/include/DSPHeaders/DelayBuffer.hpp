@@ -2,10 +2,15 @@
 
 #pragma once
 
+#import <algorithm>
+#import <cassert>
 #import <cmath>
+#import <span>
+#import <type_traits>
 #import <vector>
 
-#import "DSPHeaders/DSP.hpp"
+#import "DSPHeaders/DelayInterpolation.hpp"
+#import "DSPHeaders/DelayTaps.hpp"
 
 namespace DSPHeaders {
 
@@ -15,32 +20,37 @@ namespace DSPHeaders {
  being used to generate the sample value. This only works as long as each sample is written at a fixed sample rate so
  that a delay in seconds can be calculated as N number of samples in the past.
 
+ The interpolation is a policy type from `DelayInterpolation` so that it can be inlined into the read loops. The
+ default `DelayInterpolation::Runtime` policy allows the interpolation to be chosen when the buffer is created; it
+ resolves the choice once per read or block of reads.
+
  This buffer is not thread-safe. It is to be used in a the rendering flow of one channel of audio.
  */
-template <typename ValueType>
+template <typename ValueType, typename InterpolatorType = DelayInterpolation::Runtime>
 class DelayBuffer {
 public:
 
-  /// Types of interpolation that can be used to generate sample values using floating-point indices.
-  enum struct Interpolator {
-    linear,
-    cubic4thOrder
-  };
+  /// Types of interpolation that can be chosen at runtime to generate sample values using floating-point indices.
+  using Interpolator = DelayInterpolation::Kind;
 
   /**
    Construct new buffer that can hold given number of samples.
 
    @param sizeInSamples capacity of the buffer
-   @param kind the interpolation to apply to the samples. Default is linear.
+   @param interpolator the interpolation to apply to the samples. For the default policy, this is an `Interpolator`
+   value, and the default is linear.
    */
-  DelayBuffer(double sizeInSamples, Interpolator kind = Interpolator::linear) noexcept :
+  DelayBuffer(double sizeInSamples, InterpolatorType interpolator = {}) noexcept :
   buffer_(smallestPowerOf2For(sizeInSamples), ValueType{0.0}), writePos_{0}, wrapMask_{buffer_.size() - 1},
-  interpolatorProc_{interpolator(kind)} {}
+  interpolator_{interpolator} {}
 
   /**
    Wipe the buffer contents by filling it with zeros.
    */
-  void clear() noexcept { std::fill(buffer_.begin(), buffer_.end(), ValueType{0.0}); }
+  void clear() noexcept {
+    std::fill(buffer_.begin(), buffer_.end(), ValueType{0.0});
+    if constexpr (requires { interpolator_.reset(); }) interpolator_.reset();
+  }
 
   /**
    Write a sample to the end of the buffer, advancing the write position to the next location.
@@ -52,6 +62,24 @@ public:
     writePos_ = (writePos_ + 1) & wrapMask_;
   }
 
+  /**
+   Write a block of samples to the end of the buffer. This is the same as calling `write` for each sample, but the
+   samples are copied in at most two contiguous runs, one on each side of the wrap point.
+
+   @param values the samples to add
+   */
+  void writeBlock(std::span<const ValueType> values) noexcept {
+    // Only the last `size()` samples can survive the write
+    auto skip = values.size() > buffer_.size() ? values.size() - buffer_.size() : 0;
+    writePos_ = (writePos_ + skip) & wrapMask_;
+    auto source = values.data() + skip;
+    auto count = values.size() - skip;
+    auto first = std::min(count, buffer_.size() - writePos_);
+    std::copy_n(source, first, buffer_.data() + writePos_);
+    std::copy_n(source + first, count - first, buffer_.data());
+    writePos_ = (writePos_ + count) & wrapMask_;
+  }
+
   /**
    Physical size of the buffer. This is always a power of 2 and may not match the value given in the constructor or the
    last `setSizeInSamples` call.
@@ -78,54 +106,221 @@ public:
    */
   ValueType read(ValueType delay) const noexcept {
     // Convert delay distance into whole and partial components.
-    auto offset = int(delay);
-    return (this->*interpolatorProc_)(offset, delay - offset);
+    auto whole = ssize_t(delay);
+    ValueType partial = delay - whole;
+    return withInterpolator([&](const auto& policy) { return interpolate(policy, writePos_ - 1 - whole, partial); });
+  }
+
+  /**
+   Obtain a block of samples at a fixed delay. The block is taken to line up with the last `out.size()` samples
+   written, so that the result is the same as calling `write` and then `read` for each sample of the block:
+
+   ```
+   buffer.writeBlock(input);
+   buffer.readBlock(output, delay);
+   ```
+
+   An integral delay is a plain copy. Otherwise the interpolation weights are the same for every sample, so they are
+   computed once and applied in contiguous runs that the compiler can vectorize. The delay plus the block size should
+   fit in the buffer or the block will see samples that have been overwritten.
+
+   @param out the span to fill
+   @param delay distance from the write position of each sample to return
+   */
+  void readBlock(std::span<ValueType> out, ValueType delay) const noexcept {
+    assert(delay >= 0.0);
+    auto whole = size_t(delay);
+    ValueType partial = delay - whole;
+    auto first = writePos_ - out.size() - whole;
+    withInterpolator([&](const auto& policy) {
+      using Policy = std::decay_t<decltype(policy)>;
+      if constexpr (DelayInterpolation::WeightedInterpolator<Policy, ValueType>) {
+        if (partial == 0.0) {
+          first &= wrapMask_;
+          auto count = std::min(out.size(), buffer_.size() - first);
+          std::copy_n(buffer_.data() + first, count, out.data());
+          std::copy_n(buffer_.data(), out.size() - count, out.data() + count);
+        } else {
+          readWeighted<Policy::taps>(out, first + Policy::newer, Policy::weights(partial));
+        }
+      } else {
+        for (size_t index = 0; index < out.size(); ++index) out[index] = interpolate(policy, first + index, partial);
+      }
+    });
+  }
+
+  /**
+   Obtain a block of samples with a separate delay for each one, such as from an LFO. The samples line up with the
+   last `out.size()` samples written as they do for the fixed-delay `readBlock`. The choice of interpolator is made
+   once for the block rather than once per sample.
+
+   @param out the span to fill
+   @param delays distance from the write position of each sample to return. Must be the same size as `out`.
+   */
+  void readBlock(std::span<ValueType> out, std::span<const ValueType> delays) const noexcept {
+    assert(out.size() == delays.size());
+    auto last = writePos_ - out.size();
+    withInterpolator([&](const auto& policy) {
+      for (size_t index = 0; index < out.size(); ++index) {
+        auto whole = size_t(delays[index]);
+        out[index] = interpolate(policy, last + index - whole, delays[index] - whole);
+      }
+    });
+  }
+
+  /**
+   Obtain the sum of several taps for a block of samples. The samples line up with the last `out.size()` samples
+   written as they do for `readBlock`.
+
+   The work is done one tap at a time. A tap with a fixed delay has the same interpolation weights for every sample, so
+   they are computed once -- with the tap gain folded in -- and applied over contiguous runs of the buffer. Only a tap
+   that is ramping needs a separate position and set of weights for each sample. Ramps advance by `out.size()`
+   samples.
+
+   @param taps the taps to read
+   @param out the span to fill
+   */
+  template <size_t TapCount>
+  void readTaps(DelayTaps<ValueType, TapCount>& taps, std::span<ValueType> out) const noexcept {
+    std::fill(out.begin(), out.end(), ValueType{0.0});
+    withInterpolator([&](const auto& policy) {
+      for (size_t tap = 0; tap < TapCount; ++tap) readTap<true>(policy, taps[tap], out);
+    });
+  }
+
+  /**
+   Obtain the samples of several taps for a block of samples, each in its own span and scaled by the tap gain. The
+   samples line up with the last `frameCount` samples written as they do for `readBlock`.
+
+   @param taps the taps to read
+   @param outputs the place to write the samples of each tap. Must have one entry for each tap.
+   @param frameCount the number of samples to write to each output
+   */
+  template <size_t TapCount>
+  void readTaps(DelayTaps<ValueType, TapCount>& taps, std::span<ValueType* const> outputs,
+                size_t frameCount) const noexcept {
+    assert(outputs.size() == TapCount);
+    withInterpolator([&](const auto& policy) {
+      for (size_t tap = 0; tap < TapCount; ++tap) readTap<false>(policy, taps[tap], {outputs[tap], frameCount});
+    });
   }
 
 private:
-  using InterpolatorProc = ValueType (DelayBuffer::*)(ssize_t, ValueType) const noexcept;
 
   static size_t smallestPowerOf2For(double value) noexcept {
     return size_t(std::pow(2.0, std::ceil(std::log2(std::fmax(value, 1.0)))));
   }
 
-  static InterpolatorProc interpolator(Interpolator kind) noexcept {
-    return kind == Interpolator::linear ? &DelayBuffer::linearInterpolate : &DelayBuffer::cubic4thOrderInterpolate;
+  /**
+   Invoke a function with the interpolation policy to use. For the runtime adapter, this is the policy it selected.
+
+   @param proc the function to call
+   @returns the result of the function
+   */
+  template <typename Proc>
+  decltype(auto) withInterpolator(Proc&& proc) const noexcept {
+    if constexpr (std::is_same_v<InterpolatorType, DelayInterpolation::Runtime>) {
+      return interpolator_.visit(std::forward<Proc>(proc));
+    } else {
+      return proc(interpolator_);
+    }
   }
 
   /**
-   Obtain a linearly interpolated sample for a given index value.
+   Obtain an interpolated sample.
 
-   @param whole the index of the first sample to use
-   @param partial the non-integral part of the index
+   @param policy the interpolation to use
+   @param pos the unmasked buffer index of the sample at the whole part of the delay
+   @param partial the non-integral part of the delay
    @returns interpolated sample result
    */
-  ValueType linearInterpolate(ssize_t whole, ValueType partial) const noexcept {
-    return (partial == 0.0) ? readFromOffset(whole) : DSP::Interpolation::linear(partial,
-                                                                                 readFromOffset(whole),
-                                                                                 readFromOffset(whole + 1));
+  template <typename Policy>
+  ValueType interpolate(const Policy& policy, size_t pos, ValueType partial) const noexcept {
+    if constexpr (DelayInterpolation::WeightedInterpolator<Policy, ValueType>) {
+      if (partial == 0.0) return buffer_[pos & wrapMask_];
+      auto weights = Policy::weights(partial);
+      pos += Policy::newer;
+      ValueType sum{0.0};
+      for (size_t tap = 0; tap < Policy::taps; ++tap) sum += weights[tap] * buffer_[(pos - tap) & wrapMask_];
+      return sum;
+    } else {
+      return policy.interpolate(partial, [this, pos](ssize_t distance) {
+        return buffer_[(pos - distance) & wrapMask_];
+      });
+    }
   }
 
   /**
-   Obtain a cubic 4th-order interpolated sample for a given index value.
+   Read one tap of a multi-tap read into a block.
 
-   @param whole the index of the first sample to use
-   @param partial the non-integral part of the index
-   @returns interpolated sample result
+   @param policy the interpolation to use
+   @param tap the tap to read. Its ramp advances by the size of the block.
+   @param out the span to fill or add to
+   */
+  template <bool Accumulate, typename Policy, typename Tap>
+  void readTap(const Policy& policy, Tap& tap, std::span<ValueType> out) const noexcept {
+    static_assert(DelayInterpolation::WeightedInterpolator<Policy, ValueType>,
+                  "multi-tap reads need an interpolator without state");
+    auto last = writePos_ - out.size();
+    if (!tap.isRamping()) {
+      auto whole = size_t(tap.delay);
+      ValueType partial = tap.delay - whole;
+      auto first = last - whole;
+      if (partial == 0.0) {
+        readWeighted<1, Accumulate>(out, first, {tap.gain});
+      } else {
+        auto weights = Policy::weights(partial);
+        for (auto& weight : weights) weight *= tap.gain;
+        readWeighted<Policy::taps, Accumulate>(out, first + Policy::newer, weights);
+      }
+      return;
+    }
+
+    for (size_t index = 0; index < out.size(); ++index) {
+      auto whole = size_t(tap.delay);
+      auto value = tap.gain * interpolate(policy, last + index - whole, tap.delay - whole);
+      if constexpr (Accumulate) out[index] += value; else out[index] = value;
+      tap.advance();
+    }
+  }
+
+  /**
+   Fill a block with weighted sums of `Taps` consecutive samples, going back in time from `first + index` for each
+   output sample. Runs of samples whose taps do not cross the wrap point are done with plain pointer arithmetic.
+
+   @param out the span to fill
+   @param first the unmasked buffer index of the newest tap of the first output sample
+   @param weights the weight to apply to each tap, newest first
    */
-  ValueType cubic4thOrderInterpolate(ssize_t whole, ValueType partial) const noexcept {
-    // I think the indexing here may be off just slightly, but at 44.1K sampling rate, I'm not that concerned.
-    return (partial == 0.0) ? readFromOffset(whole) : DSP::Interpolation::cubic4thOrder(partial,
-                                                                                        readFromOffset(whole),
-                                                                                        readFromOffset(whole + 1),
-                                                                                        readFromOffset(whole + 2),
-                                                                                        readFromOffset(whole + 3));
+  template <size_t Taps, bool Accumulate = false>
+  void readWeighted(std::span<ValueType> out, size_t first, std::array<ValueType, Taps> weights) const noexcept {
+    size_t index = 0;
+    while (index < out.size()) {
+      auto pos = (first + index) & wrapMask_;
+      if (pos < Taps - 1) {
+        ValueType sum{0.0};
+        for (size_t tap = 0; tap < Taps; ++tap) sum += weights[tap] * buffer_[(pos - tap) & wrapMask_];
+        if constexpr (Accumulate) out[index++] += sum; else out[index++] = sum;
+        continue;
+      }
+
+      // Index from the oldest tap of the first sample so that no offset goes negative.
+      auto count = std::min(out.size() - index, buffer_.size() - pos);
+      auto oldest = buffer_.data() + (pos - (Taps - 1));
+      auto dest = out.data() + index;
+      for (size_t run = 0; run < count; ++run) {
+        ValueType sum{0.0};
+        for (size_t tap = 0; tap < Taps; ++tap) sum += weights[tap] * oldest[run + (Taps - 1 - tap)];
+        if constexpr (Accumulate) dest[run] += sum; else dest[run] = sum;
+      }
+      index += count;
+    }
   }
 
   std::vector<ValueType> buffer_;
   size_t writePos_;
   size_t wrapMask_;
-  InterpolatorProc interpolatorProc_;
+  InterpolatorType interpolator_;
 };
 
 } // end namespace DSPHeaders
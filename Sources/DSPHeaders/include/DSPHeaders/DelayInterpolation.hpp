@@ -0,0 +1,275 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <array>
+#import <cmath>
+#import <concepts>
+#import <cstddef>
+#import <numbers>
+#import <sys/types.h>
+
+#import "DSPHeaders/DSP.hpp"
+
+/**
+ Interpolation policies for `DelayBuffer`. A policy turns a fractional delay `whole + partial` into a sample value
+ using samples around `whole`. Samples are addressed by their distance from `whole` -- a positive distance is older, a
+ negative one is newer.
+
+ Most policies are FIR filters that only depend on `partial`. These provide their weights through the
+ `WeightedInterpolator` concept so that `DelayBuffer` can compute them once for a block with a fixed delay. The
+ remaining ones provide an `interpolate` method that is given a function that returns samples.
+ */
+namespace DSPHeaders::DelayInterpolation {
+
+/**
+ Concept for an FIR interpolator. It uses `taps` consecutive samples starting `newer` samples before `whole`. The
+ weights are returned newest sample first.
+ */
+template <typename T, typename ValueType>
+concept WeightedInterpolator = requires(ValueType partial)
+{
+  { T::taps } -> std::convertible_to<size_t>;
+  { T::newer } -> std::convertible_to<size_t>;
+  { T::weights(partial) } -> std::same_as<std::array<ValueType, T::taps>>;
+};
+
+/**
+ Linear interpolation between the samples at `whole` and `whole + 1`. Cheap, but it attenuates high frequencies and
+ the amount changes with `partial`, which is audible as a flutter when the delay is modulated.
+ */
+struct Linear {
+  static constexpr size_t taps = 2;
+  static constexpr size_t newer = 0;
+
+  template <typename ValueType>
+  static std::array<ValueType, taps> weights(ValueType partial) noexcept {
+    return {ValueType(1.0) - partial, partial};
+  }
+};
+
+/**
+ The original cubic interpolator of `DelayBuffer`, using the weights in `DSP::Interpolation::Cubic4thOrder`. Note that
+ it interpolates between the samples at `whole + 1` and `whole + 2`, so fractional delays come out one sample longer
+ than asked for. It is kept so that existing kernels sound the same; use `Hermite` for the same curve at the right
+ place.
+ */
+struct Cubic4thOrder {
+  static constexpr size_t taps = 4;
+  static constexpr size_t newer = 0;
+
+  template <typename ValueType>
+  static std::array<ValueType, taps> weights(ValueType partial) noexcept {
+    using Table = DSP::Interpolation::Cubic4thOrder;
+    const auto& w{Table::weights_[size_t(partial * Table::TableSize)]};
+    return {ValueType(w[0]), ValueType(w[1]), ValueType(w[2]), ValueType(w[3])};
+  }
+};
+
+/**
+ 4-point, 3rd-order Hermite (Catmull-Rom) interpolation between the samples at `whole` and `whole + 1`.
+ */
+struct Hermite {
+  static constexpr size_t taps = 4;
+  static constexpr size_t newer = 1;
+
+  template <typename ValueType>
+  static std::array<ValueType, taps> weights(ValueType partial) noexcept {
+    auto t1 = partial;
+    auto t2 = t1 * t1;
+    auto t3 = t2 * t1;
+    return {
+      ValueType(0.5) * (-t3 + ValueType(2.0) * t2 - t1),
+      ValueType(0.5) * (ValueType(3.0) * t3 - ValueType(5.0) * t2 + ValueType(2.0)),
+      ValueType(0.5) * (ValueType(-3.0) * t3 + ValueType(4.0) * t2 + t1),
+      ValueType(0.5) * (t3 - t2)
+    };
+  }
+};
+
+/**
+ Lagrange polynomial interpolation of an odd order, using `Order + 1` samples centered on `whole` and `whole + 1`.
+ The result is exact for polynomials up to `Order`, and the response is maximally flat at DC.
+
+ @tparam Order the order of the polynomial
+ */
+template <size_t Order>
+struct Lagrange {
+  static_assert(Order % 2 == 1, "Lagrange interpolation must use an odd order to be centered");
+  static constexpr size_t taps = Order + 1;
+  static constexpr size_t newer = (Order - 1) / 2;
+
+  template <typename ValueType>
+  static std::array<ValueType, taps> weights(ValueType partial) noexcept {
+    // Each weight is the product of (partial - node) over all of the other nodes, so use running products from both
+    // ends instead of a nested loop.
+    std::array<ValueType, taps> weights;
+    ValueType product{1.0};
+    for (size_t tap = 0; tap < taps; ++tap) {
+      weights[tap] = product * ValueType(scales_[tap]);
+      product *= partial - ValueType(ssize_t(tap) - ssize_t(newer));
+    }
+    product = 1.0;
+    for (size_t tap = taps; tap-- > 0;) {
+      weights[tap] *= product;
+      product *= partial - ValueType(ssize_t(tap) - ssize_t(newer));
+    }
+    return weights;
+  }
+
+private:
+
+  /// The reciprocal of the product of the distances from each node to the others.
+  static constexpr std::array<double, taps> scales_ = [] {
+    std::array<double, taps> scales;
+    for (ssize_t tap = 0; tap < ssize_t(taps); ++tap) {
+      double product = 1.0;
+      for (ssize_t other = 0; other < ssize_t(taps); ++other) if (other != tap) product *= double(tap - other);
+      scales[tap] = 1.0 / product;
+    }
+    return scales;
+  }();
+};
+
+using Lagrange3 = Lagrange<3>;
+using Lagrange5 = Lagrange<5>;
+
+/**
+ Band-limited interpolation with a Blackman-windowed sinc kernel of `Taps` samples centered on `whole` and
+ `whole + 1`. The kernel is tabulated for `Phases` values of `partial` and linearly interpolated between them. Rows are
+ normalized to unity gain at DC. The table is built when the first instance is created.
+
+ @tparam Taps the number of samples that contribute to a value
+ @tparam Phases the number of table rows
+ */
+template <size_t Taps = 8, size_t Phases = 256>
+struct WindowedSinc {
+  static_assert(Taps % 2 == 0 && Taps >= 4, "WindowedSinc needs an even number of taps");
+  static constexpr size_t taps = Taps;
+  static constexpr size_t newer = Taps / 2 - 1;
+
+  WindowedSinc() noexcept { table(); }
+
+  template <typename ValueType>
+  static std::array<ValueType, taps> weights(ValueType partial) noexcept {
+    auto position = partial * ValueType(Phases);
+    auto row = size_t(position);
+    auto fraction = position - ValueType(row);
+    const auto& lower{table()[row]};
+    const auto& upper{table()[row + 1]};
+    std::array<ValueType, taps> weights;
+    for (size_t tap = 0; tap < taps; ++tap) {
+      weights[tap] = ValueType(lower[tap] + fraction * (upper[tap] - lower[tap]));
+    }
+    return weights;
+  }
+
+private:
+  using Table = std::array<std::array<double, Taps>, Phases + 1>;
+
+  static const Table& table() noexcept {
+    static const Table table = [] {
+      Table table;
+      constexpr double halfWidth = Taps / 2;
+      for (size_t row = 0; row <= Phases; ++row) {
+        double partial = double(row) / Phases;
+        double sum = 0.0;
+        for (size_t tap = 0; tap < Taps; ++tap) {
+          double x = partial - (double(tap) - double(newer));
+          double sinc = x == 0.0 ? 1.0 : std::sin(std::numbers::pi * x) / (std::numbers::pi * x);
+          double phase = std::numbers::pi * x / halfWidth;
+          double window = 0.42 + 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase);
+          table[row][tap] = sinc * window;
+          sum += table[row][tap];
+        }
+        for (auto& weight : table[row]) weight /= sum;
+      }
+      return table;
+    }();
+    return table;
+  }
+};
+
+/**
+ First-order Thiran allpass interpolation. It has a flat magnitude response, so unlike the FIR interpolators it does
+ not dull the signal, but it is recursive. The filter state lives in the policy, so it only works for a single read of
+ the delay line per written sample, with a delay that changes slowly. The fractional delay is kept in [0.5, 1.5),
+ where the filter is stable and its phase is most linear, so delays must be at least 1 sample long.
+ */
+class Thiran {
+public:
+
+  /**
+   Obtain the next interpolated sample.
+
+   @param partial the non-integral part of the delay
+   @param sample function that returns the sample at a given distance from `whole`
+   @returns interpolated sample
+   */
+  template <typename ValueType, typename Source>
+  ValueType interpolate(ValueType partial, const Source& sample) const noexcept {
+    ssize_t offset = partial < 0.5 ? -1 : 0;
+    double fraction = partial - offset;
+    double coefficient = (1.0 - fraction) / (1.0 + fraction);
+    previous_ = coefficient * (sample(offset) - previous_) + sample(offset + 1);
+    return ValueType(previous_);
+  }
+
+  /// Forget the filter state.
+  void reset() noexcept { previous_ = 0.0; }
+
+private:
+  mutable double previous_{0.0};
+};
+
+/// The interpolators that can be chosen at runtime.
+enum struct Kind {
+  linear,
+  cubic4thOrder,
+  hermite,
+  lagrange3,
+  lagrange5,
+  windowedSinc
+};
+
+/**
+ Adapter that selects one of the stateless interpolators at runtime. `DelayBuffer` asks it for the policy once for
+ each read or block of reads, and then runs the policy's inlined code.
+ */
+class Runtime {
+public:
+
+  /**
+   Construct new adapter.
+
+   @param kind the interpolator to use
+   */
+  Runtime(Kind kind = Kind::linear) noexcept : kind_{kind} {}
+
+  /// @returns the interpolator in use
+  Kind kind() const noexcept { return kind_; }
+
+  /**
+   Invoke a function with the selected policy.
+
+   @param proc the function to call
+   @returns the result of the function
+   */
+  template <typename Proc>
+  decltype(auto) visit(Proc&& proc) const noexcept {
+    switch (kind_) {
+      case Kind::cubic4thOrder: return proc(Cubic4thOrder{});
+      case Kind::hermite: return proc(Hermite{});
+      case Kind::lagrange3: return proc(Lagrange3{});
+      case Kind::lagrange5: return proc(Lagrange5{});
+      case Kind::windowedSinc: return proc(sinc_);
+      default: return proc(Linear{});
+    }
+  }
+
+private:
+  Kind kind_;
+  WindowedSinc<> sinc_{};
+};
+
+} // end namespace DSPHeaders::DelayInterpolation
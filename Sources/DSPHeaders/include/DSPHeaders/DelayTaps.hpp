@@ -0,0 +1,137 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <array>
+#import <cassert>
+#import <cstddef>
+
+namespace DSPHeaders {
+
+/**
+ A fixed set of read positions into a `DelayBuffer`, each with a gain, for multitap echoes, early reflections and
+ chorus voices. `DelayBuffer::readTaps` reads all of them for a block of samples at once.
+
+ The delay of a tap can be ramped to a new value over a number of samples, which is how modulated taps are done without
+ the clicks that come from jumping to a new position. While a tap ramps, its delay changes by a fixed amount after
+ every sample it produces.
+
+ @tparam ValueType the type of sample held in the delay buffer
+ @tparam TapCount the number of taps
+ */
+template <typename ValueType, size_t TapCount>
+class DelayTaps {
+public:
+
+  /**
+   The state of one tap.
+   */
+  struct Tap {
+    /// The current delay in samples
+    ValueType delay{0.0};
+    /// The scaling to apply to the samples of the tap
+    ValueType gain{1.0};
+    /// The amount to change the delay by after each sample while ramping
+    ValueType step{0.0};
+    /// The delay to stop at when ramping ends
+    ValueType target{0.0};
+    /// The number of samples left in the ramp
+    size_t remaining{0};
+
+    /// @returns true if the delay is changing
+    bool isRamping() const noexcept { return remaining > 0; }
+
+    /**
+     Move the delay one step towards its target. Does nothing if the tap is not ramping.
+     */
+    void advance() noexcept {
+      if (remaining > 0) {
+        delay = --remaining == 0 ? target : delay + step;
+      }
+    }
+  };
+
+  /**
+   Construct new set with all taps at zero delay and unity gain.
+   */
+  DelayTaps() noexcept = default;
+
+  /**
+   Construct new set with the given delays and gains.
+
+   @param delays the delay of each tap in samples
+   @param gains the gain of each tap
+   */
+  DelayTaps(const std::array<ValueType, TapCount>& delays, const std::array<ValueType, TapCount>& gains) noexcept {
+    for (size_t tap = 0; tap < TapCount; ++tap) {
+      taps_[tap].delay = delays[tap];
+      taps_[tap].gain = gains[tap];
+    }
+  }
+
+  /// @returns the number of taps
+  static constexpr size_t size() noexcept { return TapCount; }
+
+  /**
+   Set the delay of a tap, stopping any ramp in progress.
+
+   @param tap the tap to change
+   @param delay the new delay in samples
+   */
+  void setDelay(size_t tap, ValueType delay) noexcept {
+    assert(tap < TapCount);
+    taps_[tap].delay = delay;
+    taps_[tap].remaining = 0;
+  }
+
+  /**
+   Move the delay of a tap to a new value over a number of samples. A duration of zero sets the delay immediately.
+
+   @param tap the tap to change
+   @param delay the delay to end at
+   @param duration the number of samples to take to get there
+   */
+  void rampDelay(size_t tap, ValueType delay, size_t duration) noexcept {
+    assert(tap < TapCount);
+    auto& entry{taps_[tap]};
+    if (duration == 0) {
+      setDelay(tap, delay);
+      return;
+    }
+    entry.step = (delay - entry.delay) / ValueType(duration);
+    entry.target = delay;
+    entry.remaining = duration;
+  }
+
+  /**
+   Set the gain of a tap.
+
+   @param tap the tap to change
+   @param gain the new gain
+   */
+  void setGain(size_t tap, ValueType gain) noexcept {
+    assert(tap < TapCount);
+    taps_[tap].gain = gain;
+  }
+
+  /**
+   Obtain the state of a tap.
+
+   @param tap the tap to access
+   @returns reference to the tap state
+   */
+  Tap& operator[](size_t tap) noexcept { return taps_[tap]; }
+
+  /**
+   Obtain the state of a tap.
+
+   @param tap the tap to access
+   @returns reference to the tap state
+   */
+  const Tap& operator[](size_t tap) const noexcept { return taps_[tap]; }
+
+private:
+  std::array<Tap, TapCount> taps_{};
+};
+
+} // end namespace DSPHeaders
@@ -2,23 +2,34 @@
 
 #pragma once
 
-#import <os/log.h>
 #import <algorithm>
 #import <atomic>
 #import <cassert>
+#import <cinttypes>
+#import <cmath>
 #import <concepts>
 #import <functional>
 #import <initializer_list>
-#import <ranges>
+#import <limits>
+#import <memory>
+#import <span>
 #import <string>
-#import <unordered_map>
-
-#import <AudioToolbox/AudioToolbox.h>
 
+#import "DSPHeaders/AudioTypes.hpp"
+#import "DSPHeaders/BufferArena.hpp"
 #import "DSPHeaders/BusBufferFacet.hpp"
+#import "DSPHeaders/BusMeter.hpp"
 #import "DSPHeaders/BusSampleBuffer.hpp"
 #import "DSPHeaders/BusBuffers.hpp"
+#import "DSPHeaders/Command.hpp"
+#import "DSPHeaders/MIDI2.hpp"
+#import "DSPHeaders/Oversampler.hpp"
 #import "DSPHeaders/Parameters/Base.hpp"
+#import "DSPHeaders/Parameters/Registry.hpp"
+#import "DSPHeaders/RenderGuard.hpp"
+#import "DSPHeaders/RenderLog.hpp"
+#import "DSPHeaders/RenderMetrics.hpp"
+#import "DSPHeaders/SPSCQueue.hpp"
 #import "DSPHeaders/Concepts.hpp"
 
 namespace DSPHeaders {
@@ -32,25 +43,60 @@ namespace DSPHeaders {
  invoke at the appropriate times but without any virtual dispatching. The only one that is required is
  the `doRendering` method.
 
- - doRendering -- perform rendering of samples
+ - doRendering -- perform rendering of samples. A kernel with more than one output bus may instead provide a version
+ that takes a `std::span<BusBuffers>` holding the buffers of all of the output busses. In that case, all of the busses
+ are rendered at once during the first `processAndRender` call for a given sample time, and the other calls for that
+ time obtain their samples from the rendered buffers. A kernel with more than one input bus -- such as one with a
+ side-chain -- may provide a version that takes a `std::span<BusBuffers>` holding the buffers of all of the input
+ busses (see `setInputBusCount`).
  - doSetImmediateParameterValue [optional] -- set a parameter value from within the render loop. The default action
  is to invoke the parameter's setImmediate method.
  - doSetPendingParameterValue [optional] -- set a paramete value from outside render loop (AUParameterTree)
  - doGetImmediateParameterValue [optional] -- read parameter value set by render loop
  - doGetPendingParameterValue [optional] -- read parameter value set outside render loop (AUParameterTree)
  - doMIDIEvent [optional] -- process MIDI v1 message
+ - doMIDI2Event [optional] -- process a channel voice message from a MIDI event list (see `MIDI2::forEachEvent`)
+ - doCommand [optional] -- process a custom `Command` posted via `postCommand`
  - doRenderingStateChanged [optional] -- notification that the rendering state has changed
+ - doTailFrameCount [optional] -- number of frames the kernel output lasts after its input becomes silent
+
+ By default, `doRendering` is called with whatever frame counts result from splitting the host's buffer at the sample
+ times of the events in the render event list, so it can see any count down to 1. If `FixedBlockSize` is not zero,
+ `doRendering` is instead always called with exactly `FixedBlockSize` frames. The samples from the host are staged into
+ internal buffers until there is a full block to render, which delays the output by `FixedBlockSize` frames -- see
+ `latency`. Events are quantized to block boundaries: an event is applied before the rendering of the block that
+ holds the event's sample time, so it takes effect up to `FixedBlockSize - 1` frames early.
+
+ A kernel with the single-bus `doRendering` method can also have it run at 2, 4, or 8 times the host's sample rate
+ (see `setOversampling`). The input samples are upsampled into internal buffers before `doRendering` is called with
+ that many times more frames, and its output is then decimated back into the host's buffer. Events still split the
+ rendering at the same places, so their offsets grow by the same factor as seen by the kernel, and ramp durations are
+ scaled to match.
  */
-template <typename KernelType>
+template <typename KernelType, AUAudioFrameCount FixedBlockSize = 0>
 class EventProcessor {
 public:
-  using ParameterMap = std::unordered_map<AUParameterAddress, std::reference_wrapper<DSPHeaders::Parameters::Base>>;
+  using ParameterMap = DSPHeaders::Parameters::Registry;
+
+  /// The number of frames the output is delayed by fixed-size block rendering. Kernels should report this (in seconds)
+  /// via the `latency` property of their `AUAudioUnit`, along with any `oversamplingLatency`.
+  static constexpr AUAudioFrameCount latency = FixedBlockSize;
+
+  /// The number of commands that can be waiting for the render thread.
+  static constexpr size_t commandQueueCapacity = 256;
+
+  /// The number of commands after a parameter change to search for another change to the same parameter.
+  static constexpr size_t commandCoalesceWindow = 32;
 
   /**
    Construct new instance.
    */
   EventProcessor(std::string name) noexcept
-  : log_{os_log_create(name.c_str(), "Kernel")}, derived_{static_cast<KernelType&>(*this)} {}
+  : log_{os_log_create(name.c_str(), "Kernel")},
+#if DSPHEADERS_RENDER_LOG_ENABLED
+  renderLog_{log_},
+#endif
+  derived_{static_cast<KernelType&>(*this)} {}
 
   /**
    Set the bypass mode.
@@ -65,12 +111,43 @@ public:
   /// @returns true if effect is bypassed
   inline bool isBypassed() const noexcept { return bypassed_.load(std::memory_order_relaxed); }
 
+  /**
+   Set the number of input busses to pull samples from. This only has an effect for a kernel that provides a
+   `doRendering` method that takes a span of input `BusBuffers`, and it must be called before `setRenderingFormat`.
+
+   @param inputBusCount the number of input busses. Bus 0 is the main input.
+   */
+  void setInputBusCount(size_t inputBusCount) noexcept { inputBusCount_ = std::max<size_t>(inputBusCount, 1); }
+
+  /// @returns the number of input busses
+  size_t inputBusCount() const noexcept { return inputBusCount_; }
+
+  /**
+   Set the factor by which to raise the sample rate when running `doRendering`. This only has an effect for a kernel
+   that provides the single-bus `doRendering` method and that does not render fixed-size blocks, and it must be called
+   before `setRenderingFormat`. Note that `sampleRate` remains that of the host, while `renderingSampleRate` gives the
+   rate seen by `doRendering`.
+
+   @param factor the oversampling factor: 1 (the default) to disable, or 2, 4, or 8
+   */
+  void setOversampling(size_t factor) noexcept {
+    assert(factor == 1 || factor == 2 || factor == 4 || factor == 8);
+    oversamplingFactor_ = factor;
+  }
+
+  /// @returns the oversampling factor in effect
+  size_t oversampling() const noexcept { return oversampler_.factor(); }
+
+  /// @returns the number of frames by which oversampling delays the output
+  double oversamplingLatency() const noexcept { return oversampler_.latency(); }
+
   /// @returns true if actively rendering samples
   inline bool isRendering() const noexcept { return rendering_.load(std::memory_order_relaxed); }
 
   /// @returns true if actively ramping one or more parameters
   inline bool isRamping() const noexcept { return rampRemaining_ > 0; }
 
+#if defined(__APPLE__)
   /**
    Update kernel and buffers to support the given format.
 
@@ -78,21 +155,55 @@ public:
    @param format the sample format to expect
    @param maxFramesToRender the maximum number of frames to expect on input
    @param treeBasedRampDuration the number of frames to ramp a parameter value change
+   @returns `kAudioUnitErr_FormatNotSupported` if the format has more than `BusBuffers::maxChannelCount` channels,
+   `noErr` otherwise
    */
-  void setRenderingFormat(NSInteger busCount, AVAudioFormat* _Nonnull format,
-                          AUAudioFrameCount maxFramesToRender, AUAudioFrameCount treeBasedRampDuration = 16) noexcept {
-    sampleRate_ = format.sampleRate;
-    treeBasedRampDuration_ = treeBasedRampDuration;
+  AUAudioUnitStatus setRenderingFormat(NSInteger busCount, AVAudioFormat* _Nonnull format,
+                                       AUAudioFrameCount maxFramesToRender,
+                                       AUAudioFrameCount treeBasedRampDuration = 16) noexcept {
+    return setRenderingFormat(busCount, format.sampleRate, format.channelCount, maxFramesToRender,
+                              treeBasedRampDuration);
+  }
+#endif
+
+  /**
+   Update kernel and buffers to support the given sample rate and channel count. Samples are always non-interleaved
+   `AUValue` values.
+
+   @param busCount the number of busses being used in the audio processing flow
+   @param sampleRate the sample rate to expect
+   @param channelCount the number of channels in each bus
+   @param maxFramesToRender the maximum number of frames to expect on input
+   @param treeBasedRampDuration the number of frames to ramp a parameter value change
+   @returns `kAudioUnitErr_FormatNotSupported` if `channelCount` is more than `BusBuffers::maxChannelCount`, in which
+   case nothing is changed and rendering is not started, `noErr` otherwise
+   */
+  AUAudioUnitStatus setRenderingFormat(NSInteger busCount, double sampleRate, AUAudioChannelCount channelCount,
+                                       AUAudioFrameCount maxFramesToRender,
+                                       AUAudioFrameCount treeBasedRampDuration = 16) noexcept {
+    // Reject the format here and not while rendering -- a bus holds at most `maxChannelCount` channels.
+    if (channelCount > BusBuffers::maxChannelCount) [[unlikely]] {
+      os_log_error(log_, "setRenderingFormat - unsupported channel count: %u", channelCount);
+      return kAudioUnitErr_FormatNotSupported;
+    }
+
+    sampleRate_ = sampleRate;
 
-    auto channelCount{format.channelCount};
+    if constexpr (FixedBlockSize == 0 && HasSingleBusRendering<KernelType>) {
+      oversampler_.allocate(oversamplingFactor_, channelCount, maxFramesToRender);
+    }
+
+    // Ramp durations are counted in frames at the rendering rate. Kernels that use `fillFrameValues` see `factor` of
+    // them for each input frame, and `checkForParameterValueChanges` steps ramps by `factor` each render pass, so a
+    // ramp takes the same time with or without oversampling.
+    treeBasedRampDuration_ = treeBasedRampDuration * AUAudioFrameCount(oversampler_.factor());
 
     // We want an internal buffer for each bus that we can generate output on. This is not strictly required since we
     // will be rendering one bus at a time, but doing so allows us to process the samples "in-place" and pass the buffer
-    // to the audio unit without having to make a copy for the next element in the signal processing chain.
-    while (outputBusses_.size() < size_t(busCount)) {
-      outputBusses_.emplace_back();
-      outputFacets_.emplace_back();
-    }
+    // to the audio unit without having to make a copy for the next element in the signal processing chain. The buffers
+    // of all busses come from one allocation.
+    auto outputBusCount = std::max(size_t(busCount), outputFacets_.size());
+    outputFacets_.resize(outputBusCount);
 
     // Extra facet at end is reserved for `pullInputBlock` processing to hold input samples.
     // facets_.emplace_back();
@@ -101,27 +212,70 @@ public:
     for (auto& facet : outputFacets_) facet.setChannelCount(channelCount);
     inputFacet_.setChannelCount(channelCount);
 
+    if constexpr (HasMultiInputRendering<KernelType>) {
+      allocateExtraInputs(channelCount, maxFramesToRender);
+    }
+
+    // A kernel that renders all of its output busses at once reads its input while writing them, so the input must
+    // have storage of its own.
+    if constexpr (HasMultiBusRendering<KernelType>) {
+      inputBus_.allocate(1, channelCount, maxFramesToRender);
+    }
+
     // Setup sample buffers to have the right format and capacity. This is constant as long as rendering is active.
-    for (auto& entry : outputBusses_) entry.allocate(format, maxFramesToRender);
+    outputBusses_.allocate(outputBusCount, channelCount, maxFramesToRender);
+
+    if (meterWindowSeconds_ > 0.0) {
+      while (meters_.size() < outputBusCount) meters_.emplace_back(std::make_unique<BusMeter>());
+      for (auto& meter : meters_) meter->configure(sampleRate, channelCount, meterWindowSeconds_, scopeDecimation_);
+    }
+
+    if constexpr (FixedBlockSize > 0) {
+      blockStages_.resize(outputBusCount);
+      for (auto& stage : blockStages_) stage.allocate(channelCount);
+    }
 
     // Link the output buffers with their corresponding facets. This only needs to be done once.
-    for (auto pair : std::views::zip(outputFacets_, outputBusses_)) {
-      std::get<0>(pair).assignBufferList(std::get<1>(pair).mutableAudioBufferList());
+    for (size_t bus = 0; bus < outputBusCount; ++bus) {
+      outputFacets_[bus].assignBufferList(outputBusses_.mutableAudioBufferList(bus));
+    }
+
+    if constexpr (HasMultiBusRendering<KernelType>) {
+      outputBusBuffers_.clear();
+      for (auto& facet : outputFacets_) outputBusBuffers_.push_back(facet.busBuffers());
+      cacheValid_ = false;
     }
 
+#if DSPHEADERS_RENDER_LOG_ENABLED
+    renderLog_.allocate();
+    renderLog_.startDraining();
+#endif
+
+#if DSPHEADERS_RENDER_GUARD_ENABLED
+    RenderGuard::prepare();
+#endif
+
     setRendering(true);
+  return noErr;
   }
 
   /// @returns current sample rate that is in effect
   inline double sampleRate() const noexcept { return sampleRate_; }
 
+  /// @returns the sample rate of the samples given to `doRendering`, which differs from `sampleRate` when oversampling
+  inline double renderingSampleRate() const noexcept { return sampleRate_ * double(oversampler_.factor()); }
+
   /**
    Rendering has stopped. Free up any resources it used.
    */
   void deallocateRenderResources() noexcept {
     setRendering(false);
+    // The bus storage is kept so that restarting with the same format does not allocate, and so that any pointers to it
+    // that a host still holds remain valid.
     for (auto& facet : outputFacets_) if (facet.isLinked()) facet.unlink();
-    for (auto& bus : outputBusses_) bus.release();
+#if DSPHEADERS_RENDER_LOG_ENABLED
+    renderLog_.stopDraining();
+#endif
   }
 
   /**
@@ -136,6 +290,54 @@ public:
     return isRendering() ? setPendingParameterValue(address, value) : setImmediateParameterValue(address, value, 0);
   }
 
+  /**
+   Send a command to the render thread. Unlike `setParameterValue`, every command is delivered in order, and commands
+   are not limited to parameter changes. The render thread applies them at the start of the first `processAndRender`
+   call whose frames reach the command's sample time. A parameter change is skipped if a later change to the same
+   parameter is also ready to be applied.
+
+   Only one thread may post commands. This does not block or allocate.
+
+   @param command the command to send
+   @returns true if the command was queued, false if the queue is full
+   */
+  bool postCommand(const Command& command) noexcept { return commands_.push(command); }
+
+  /**
+   Configure the measuring of peak and RMS levels of the output busses. Takes effect at the next `setRenderingFormat`
+   call, so this must not be called while rendering. Once configured, metering can be turned on and off at any time
+   with `setMeteringEnabled`.
+
+   @param windowSeconds the duration of each measurement window. Zero disables metering.
+   @param scopeDecimation if not zero, also record every Nth sample for a scope display
+   */
+  void configureMetering(double windowSeconds = 0.05, size_t scopeDecimation = 0) noexcept {
+    meterWindowSeconds_ = windowSeconds;
+    scopeDecimation_ = scopeDecimation;
+    metering_.store(windowSeconds > 0.0, std::memory_order_relaxed);
+  }
+
+  /**
+   Turn metering on or off. Has no effect if metering was not configured before the last `setRenderingFormat` call.
+
+   @param enabled true to measure the output levels
+   */
+  void setMeteringEnabled(bool enabled) noexcept { metering_.store(enabled, std::memory_order_relaxed); }
+
+  /// @returns true if metering is enabled
+  bool isMeteringEnabled() const noexcept { return metering_.load(std::memory_order_relaxed); }
+
+  /// @returns the number of output busses that have meters
+  size_t meterCount() const noexcept { return meters_.size(); }
+
+  /**
+   Obtain the latest level measurements of an output bus. Only one thread may read the measurements of a bus.
+
+   @param bus the output bus to read. Must be less than `meterCount()`
+   @returns the latest reading
+   */
+  const BusMeter::Reading& meterReading(size_t bus) noexcept { return meters_[bus]->read(); }
+
   /**
    Process an AU parameter value request from the parameter tree. This is only called from the KernelBridge class to
    handle UI component requests for values.
@@ -157,25 +359,47 @@ public:
    @param output the buffer to hold the rendered samples
    @param realtimeEventListHead pointer to the first AURenderEvent (may be null)
    @param pullInputBlock the closure to call to obtain upstream samples
+   @param actionFlags optional render flags from the host. If the kernel skips rendering because its input has been
+   silent for longer than its tail (see `HasTailFrameCount`), `kAudioUnitRenderAction_OutputIsSilence` is set here.
+
+   @returns `noErr` on success, or the status from `pullInputBlock`. When `DSPHEADERS_BUFFER_VALIDATION_STRICT` is
+   set, an `output` buffer list that does not match the bus format is reported with `kAudioUnitErr_FormatNotSupported`.
+
+   When `DSPHEADERS_RENDER_GUARD_ENABLED` is set, any memory allocation or lock use during the call -- other than by
+   `pullInputBlock` -- is recorded by `RenderGuard`.
    */
   AUAudioUnitStatus processAndRender(const AudioTimeStamp* _Nonnull timestamp,
                                      UInt32 frameCount,
                                      NSInteger outputBusNumber,
                                      AudioBufferList* _Nonnull output,
                                      const AURenderEvent* _Nullable realtimeEventListHead,
-                                     AURenderPullInputBlock _Nullable pullInputBlock) noexcept {
+                                     AURenderPullInputBlock _Nullable pullInputBlock,
+                                     AudioUnitRenderActionFlags* _Nullable actionFlags = nullptr) noexcept {
+#if DSPHEADERS_RENDER_GUARD_ENABLED
+    RenderGuard::Scope renderGuard{};
+#endif
+
     size_t outputBusIndex = size_t(outputBusNumber);
-    assert(outputBusIndex < outputBusses_.size());
+    assert(outputBusIndex < outputBusses_.busCount());
 
     // Get a buffer to use to read into if there is a `pullInputBlock`. We will also modify it in-place if necessary
     // use it for an output buffer if necessary.
-    auto& outputBus{outputBusses_[outputBusIndex]};
-    if (frameCount > outputBus.capacity()) [[unlikely]] {
+    auto outputBus = outputBusses_.mutableAudioBufferList(outputBusIndex);
+    if (frameCount > outputBusses_.capacity()) [[unlikely]] {
       return kAudioUnitErr_TooManyFramesToProcess;
     }
 
-    // Setup the rendering destination to properly use the internal buffer or the buffer attached to `output`.
-    outputFacets_[outputBusIndex].assignBufferList(output, outputBus.mutableAudioBufferList());
+    if constexpr (HasMultiBusRendering<KernelType>) {
+      return processAndRenderAllBusses(timestamp, frameCount, outputBusIndex, output, realtimeEventListHead,
+                                       pullInputBlock, actionFlags);
+    }
+
+    // Setup the rendering destination to properly use the internal buffer or the buffer attached to `output`. The
+    // buffer list comes from the host, so report any problem with it rather than rendering into it.
+    auto status = outputFacets_[outputBusIndex].assignBufferList(output, outputBus);
+    if (status != noErr) [[unlikely]] {
+      return status;
+    }
     outputFacets_[outputBusIndex].setFrameCount(frameCount);
 
     if (pullInputBlock) [[likely]] {
@@ -183,27 +407,73 @@ public:
       // Pull input samples from upstream. If the output buffer we are given has no storage assigned to it, then we
       // will use our own and perform in-place rendering of the samples. This is detected and handled in the
       // `assignBufferList` method.
-      inputFacet_.assignBufferList(output, outputBus.mutableAudioBufferList());
+      inputFacet_.assignBufferList(output, outputBus);
       inputFacet_.setFrameCount(frameCount);
 
-      AudioUnitRenderActionFlags actionFlags = 0;
-      auto status = inputFacet_.pullInput(&actionFlags, timestamp, frameCount, outputBusNumber, pullInputBlock);
+      AudioUnitRenderActionFlags pullFlags = 0;
+      status = inputFacet_.pullInput(&pullFlags, timestamp, frameCount, outputBusNumber, pullInputBlock);
       if (status != noErr) [[unlikely]] {
         return status;
       }
+
+      inputPulled_ = true;
+      if constexpr (HasMultiInputRendering<KernelType>) {
+        pullExtraInputs(timestamp, frameCount, pullInputBlock);
+      }
+
+      if constexpr (HasTailFrameCount<KernelType>) {
+        if (canSkipRendering(pullFlags, frameCount, realtimeEventListHead)) [[unlikely]] {
+          skipRendering(outputBusIndex, timestamp, frameCount, realtimeEventListHead, actionFlags);
+          meterOutput(outputBusIndex, frameCount);
+          return noErr;
+        }
+      }
     } else {
 
       // Clear the output buffer before use when there is no input data.
       outputFacets_[outputBusIndex].clear(frameCount);
+      inputPulled_ = false;
+      if constexpr (HasMultiInputRendering<KernelType>) {
+        // Give the kernel silent input buffers for all busses, with the main one shared with the output.
+        inputFacet_.assignBufferList(output);
+        inputPulled_ = true;
+        for (size_t bus = 0; bus < extraInputFacets_.size(); ++bus) {
+          resetExtraInput(bus, frameCount);
+          extraInputFacets_[bus].clear(frameCount);
+        }
+      }
     }
 
+#if DSPHEADERS_RENDER_METRICS_ENABLED
+    // Only measure our own work -- time spent pulling input is spent rendering upstream nodes.
+    auto startTicks = RenderMetrics::now();
+    subBlockCount_ = 0;
+#endif
+
     // Apply any paramter changes posted by the UI
-    checkForParameterValueChanges();
-    render(outputBusNumber, timestamp, frameCount, realtimeEventListHead);
+    updateParameters(timestamp, frameCount);
+    if constexpr (FixedBlockSize > 0) {
+      renderFixedBlocks(outputBusIndex, timestamp, frameCount, realtimeEventListHead, bool(pullInputBlock));
+    } else {
+      render(outputBusNumber, timestamp, frameCount, realtimeEventListHead);
+    }
+
+#if DSPHEADERS_RENDER_METRICS_ENABLED
+    renderMetrics_.record(RenderMetrics::now() - startTicks, frameCount, subBlockCount_, sampleRate_);
+#endif
 
+    meterOutput(outputBusIndex, frameCount);
     return noErr;
   }
 
+#if DSPHEADERS_RENDER_METRICS_ENABLED
+  /// @returns the timing measurements of `processAndRender` calls. Safe to read from any thread.
+  const RenderMetrics& renderMetrics() const noexcept { return renderMetrics_; }
+
+  /// @returns the timing measurements of `processAndRender` calls. Safe to read from any thread.
+  RenderMetrics& renderMetrics() noexcept { return renderMetrics_; }
+#endif
+
   /// @returns the ramp duration to use for UI changes
   AUAudioFrameCount treeBasedRampDuration() const noexcept { return treeBasedRampDuration_; }
 
@@ -241,8 +511,8 @@ protected:
    @param parameter the parameter to register
    */
   void registerParameter(Parameters::Base& parameter) {
-    auto result = parameters_.emplace(parameter.address(), parameter);
-    assert(result.second);
+    [[maybe_unused]] auto added = parameters_.add(parameter);
+    assert(added);
   }
 
   /**
@@ -254,20 +524,17 @@ protected:
   BusBuffers busBuffers(size_t bus) noexcept { return outputFacets_[bus].busBuffers(); }
 
   /**
-   Visit registered parameters and see if they have a change pending from the AUParameterTree.
+   Visit the registered parameters that have a change pending from the AUParameterTree or that are still ramping.
 
    @returns true if there is was a new change
    */
   bool checkForParameterValueChanges() noexcept {
-    auto changed = false;
-    for (auto param : parameters_) {
-      changed |= param.second.get().checkForValueChange(treeBasedRampDuration_);
-    }
-
+    auto steps = AUAudioFrameCount(oversampler_.factor());
+    auto changed = parameters_.checkForValueChanges(treeBasedRampDuration_, steps);
     if (changed) {
-      rampRemaining_ = std::max(treeBasedRampDuration_ - 1, rampRemaining_);
-    } else if (rampRemaining_ > 0) {
-      rampRemaining_ -= 1;
+      rampRemaining_ = std::max(treeBasedRampDuration_ > steps ? treeBasedRampDuration_ - steps : 0, rampRemaining_);
+    } else {
+      rampRemaining_ -= std::min(steps, rampRemaining_);
     }
 
     return changed;
@@ -275,41 +542,268 @@ protected:
 
   os_log_t _Nonnull log_;
 
+#if DSPHEADERS_RENDER_LOG_ENABLED
+  /// Log for messages posted from the render thread via `DSPHEADERS_RENDER_LOG`. Only present in debug builds.
+  RenderLog renderLog_;
+#endif
+
 private:
 
   bool setPendingParameterValue(AUParameterAddress address, AUValue value) noexcept {
-    os_log_info(log_, "setPendingParameterValue - %llu %f", address, value);
+    DSPHEADERS_RENDER_LOG(renderLog_, "setPendingParameterValue - %" PRIu64 " %f", address, value);
     if constexpr (HasSetPendingParameterValue<KernelType>) return derived_.doSetPendingParameterValue(address, value);
-    auto pos = parameters_.find(address);
-    return pos != parameters_.end() ? pos->second.get().setPending(value), true : false;
+    auto param = parameters_.find(address);
+    return param != nullptr ? param->setPending(value), true : false;
   }
 
   bool setImmediateParameterValue(AUParameterAddress address, AUValue value, AUAudioFrameCount duration) noexcept {
-    os_log_info(log_, "setImmediateParameterValue - %llu %f", address, value);
+    DSPHEADERS_RENDER_LOG(renderLog_, "setImmediateParameterValue - %" PRIu64 " %f", address, value);
     if constexpr (HasSetImmediateParameterValue<KernelType>)
       return derived_.doSetImmediateParameterValue(address, value, duration);
-    auto pos = parameters_.find(address);
-    return pos != parameters_.end() ? pos->second.get().setImmediate(value, duration), true : false;
+    auto param = parameters_.find(address);
+    return param != nullptr ? param->setImmediate(value, duration), true : false;
   }
 
   AUValue getPendingParameterValue(AUParameterAddress address) const noexcept {
     if constexpr (HasGetPendingParameterValue<KernelType>) return derived_.doGetPendingParameterValue(address);
-    auto pos = parameters_.find(address);
-    return pos != parameters_.end() ? pos->second.get().getPending() : 0.0;
+    auto param = parameters_.find(address);
+    return param != nullptr ? param->getPending() : 0.0;
   }
 
   AUValue getImmediateParameterValue(AUParameterAddress address) const noexcept {
     if constexpr (HasGetImmediateParameterValue<KernelType>) return derived_.doGetImmediateParameterValue(address);
-    auto pos = parameters_.find(address);
-    return pos != parameters_.end() ? pos->second.get().getImmediate() : 0.0;
+    auto param = parameters_.find(address);
+    return param != nullptr ? param->getImmediate() : 0.0;
   }
 
   void renderingStateChanged() noexcept {
-    for (auto param : parameters_) param.second.get().stopRamping();
+    for (auto param : parameters_) param->stopRamping();
     rampRemaining_ = 0;
+    silentFrames_ = 0;
+    cacheValid_ = false;
+    oversampler_.reset();
     if constexpr (HasRenderingStateChangedT<KernelType>) derived_.doRenderingStateChanged(isRendering());
   }
 
+  /**
+   Determine if rendering can be skipped because the input is silent and has been for longer than the kernel's tail.
+   Keeps a count of the number of consecutive silent input frames.
+
+   @param pullFlags the flags returned from the pull input block
+   @param frameCount the number of frames being rendered
+   @param events the events to process during this render call
+   @returns true if the output will be silent
+   */
+  bool canSkipRendering(AudioUnitRenderActionFlags pullFlags, AUAudioFrameCount frameCount,
+                        AURenderEvent const* _Nullable events) noexcept {
+    if ((pullFlags & kAudioUnitRenderAction_OutputIsSilence) == 0 && !inputFacet_.isSilent(frameCount)) [[likely]] {
+      silentFrames_ = 0;
+      return false;
+    }
+
+    // MIDI events could cause the kernel to make sounds, so render them as usual.
+    for (auto event = events; event != nullptr; event = event->head.next) {
+      if (event->head.eventType == AURenderEventMIDI || event->head.eventType == AURenderEventMIDISysEx ||
+          event->head.eventType == AURenderEventMIDIEventList) {
+        silentFrames_ = 0;
+        return false;
+      }
+    }
+
+    // Output is delayed when rendering fixed-size blocks or oversampling, so the tail lasts that much longer.
+    auto delay = latency + uint64_t(std::ceil(oversampler_.latency()));
+    auto skip = uint64_t(silentFrames_) >= uint64_t(derived_.doTailFrameCount()) + delay;
+    silentFrames_ = std::max(silentFrames_, silentFrames_ + frameCount); // saturate instead of wrapping
+    return skip;
+  }
+
+  /**
+   Emit silence instead of rendering. Parameter changes are still applied so that they are in effect when the input
+   is no longer silent.
+
+   @param outputBusIndex the bus to render
+   @param timestamp the timestamp of the first sample or the first event
+   @param frameCount the number of frames to process
+   @param events the events to process during this render call
+   @param actionFlags optional render flags to update
+   */
+  void skipRendering(size_t outputBusIndex, AudioTimeStamp const* _Nonnull timestamp, AUAudioFrameCount frameCount,
+                     AURenderEvent const* _Nullable events,
+                     AudioUnitRenderActionFlags* _Nullable actionFlags) noexcept {
+    updateParameters(timestamp, frameCount);
+    if (events != nullptr) {
+      processEventsUntil(AUEventSampleTime(timestamp->mSampleTime) + AUEventSampleTime(frameCount) - 1, events);
+    }
+    outputFacets_[outputBusIndex].clear(frameCount);
+    if (actionFlags != nullptr) *actionFlags |= kAudioUnitRenderAction_OutputIsSilence;
+  }
+
+  /**
+   Obtain the samples for an output bus of a kernel that renders all of its output busses at once. Only the first
+   call for a given sample time and frame count renders anything. It pulls the samples of input bus 0 into a buffer of
+   their own and then renders all of the output busses into their internal buffers. This and all other calls then
+   serve the samples of the requested bus from these buffers.
+
+   @param timestamp the timestamp of the first sample or the first event
+   @param frameCount the number of frames to process
+   @param outputBusIndex the bus to render
+   @param output the buffer to hold the rendered samples
+   @param events the events to process during this render call
+   @param pullInputBlock the closure to call to obtain upstream samples
+   @param actionFlags optional render flags from the host
+   */
+  AUAudioUnitStatus processAndRenderAllBusses(const AudioTimeStamp* _Nonnull timestamp, AUAudioFrameCount frameCount,
+                                              size_t outputBusIndex, AudioBufferList* _Nonnull output,
+                                              const AURenderEvent* _Nullable events,
+                                              AURenderPullInputBlock _Nullable pullInputBlock,
+                                              AudioUnitRenderActionFlags* _Nullable actionFlags) noexcept {
+    static_assert(FixedBlockSize == 0, "rendering all output busses at once does not support fixed-size blocks");
+    auto source = outputBusses_.mutableAudioBufferList(outputBusIndex);
+    if constexpr (DefaultBufferValidation::enabled) {
+      if (output->mNumberBuffers != source->mNumberBuffers) [[unlikely]] {
+        return kAudioUnitErr_FormatNotSupported;
+      }
+    }
+
+    if (!cacheValid_ || cachedSampleTime_ != timestamp->mSampleTime || cachedFrameCount_ != frameCount) {
+      auto status = renderAllBusses(timestamp, frameCount, events, pullInputBlock);
+      if (status != noErr) [[unlikely]] {
+        cacheValid_ = false;
+        return status;
+      }
+      cacheValid_ = true;
+      cachedSampleTime_ = timestamp->mSampleTime;
+      cachedFrameCount_ = frameCount;
+    }
+
+    // Hand over the rendered samples. If the host did not provide any storage, just give it ours.
+    for (UInt32 channel = 0; channel < output->mNumberBuffers; ++channel) {
+      auto& buffer{output->mBuffers[channel]};
+      if (buffer.mData == nullptr) {
+        buffer.mData = source->mBuffers[channel].mData;
+      } else if (buffer.mData != source->mBuffers[channel].mData) {
+        std::copy_n(static_cast<const AUValue*>(source->mBuffers[channel].mData), frameCount,
+                    static_cast<AUValue*>(buffer.mData));
+      }
+      buffer.mDataByteSize = UInt32(frameCount * sizeof(AUValue));
+    }
+
+    if (cachedSilence_ && actionFlags != nullptr) *actionFlags |= kAudioUnitRenderAction_OutputIsSilence;
+    meterOutput(outputBusIndex, frameCount);
+    return noErr;
+  }
+
+  AUAudioUnitStatus renderAllBusses(const AudioTimeStamp* _Nonnull timestamp, AUAudioFrameCount frameCount,
+                                    const AURenderEvent* _Nullable events,
+                                    AURenderPullInputBlock _Nullable pullInputBlock) noexcept {
+    cachedSilence_ = false;
+    outputBusses_.setFrameCount(frameCount);
+
+    // Input goes into its own buffer so that no output bus aliases it. The last pull may have pointed that buffer at
+    // storage from upstream, which is fine to read from but must not be pulled into again, so restore our own.
+    inputBus_.reset(0);
+    inputBus_.setFrameCount(0, frameCount);
+    inputFacet_.assignBufferList(inputBus_.mutableAudioBufferList(0));
+
+    if (pullInputBlock) [[likely]] {
+      AudioUnitRenderActionFlags pullFlags = 0;
+      auto status = inputFacet_.pullInput(&pullFlags, timestamp, frameCount, 0, pullInputBlock);
+      if (status != noErr) [[unlikely]] {
+        return status;
+      }
+
+      inputPulled_ = true;
+
+      if constexpr (HasTailFrameCount<KernelType>) {
+        if (canSkipRendering(pullFlags, frameCount, events)) [[unlikely]] {
+          updateParameters(timestamp, frameCount);
+          if (events != nullptr) {
+            processEventsUntil(AUEventSampleTime(timestamp->mSampleTime) + AUEventSampleTime(frameCount) - 1, events);
+          }
+          for (auto& facet : outputFacets_) facet.clear(frameCount);
+          cachedSilence_ = true;
+          return noErr;
+        }
+      }
+    } else {
+      // Give the kernel silent input.
+      for (auto& facet : outputFacets_) facet.clear(frameCount);
+      inputFacet_.clear(frameCount);
+      inputPulled_ = true;
+    }
+
+#if DSPHEADERS_RENDER_METRICS_ENABLED
+    auto startTicks = RenderMetrics::now();
+    subBlockCount_ = 0;
+#endif
+
+    updateParameters(timestamp, frameCount);
+    render(0, timestamp, frameCount, events);
+
+#if DSPHEADERS_RENDER_METRICS_ENABLED
+    renderMetrics_.record(RenderMetrics::now() - startTicks, frameCount, subBlockCount_, sampleRate_);
+#endif
+
+    return noErr;
+  }
+
+  void allocateExtraInputs(AUAudioChannelCount channelCount, AUAudioFrameCount maxFramesToRender) {
+    static_assert(FixedBlockSize == 0, "multiple input busses do not support fixed-size blocks");
+    auto extraCount = inputBusCount_ - 1;
+    extraInputBusses_.allocate(extraCount, channelCount, maxFramesToRender);
+    extraInputFacets_.resize(extraCount);
+    inputBusBuffers_.clear();
+    inputBusBuffers_.push_back(inputFacet_.busBuffers());
+    for (size_t bus = 0; bus < extraCount; ++bus) {
+      extraInputFacets_[bus].setChannelCount(channelCount);
+      extraInputFacets_[bus].assignBufferList(extraInputBusses_.mutableAudioBufferList(bus));
+      inputBusBuffers_.push_back(extraInputFacets_[bus].busBuffers());
+    }
+  }
+
+  /**
+   Pull samples from input busses 1 and up. Each bus is pulled into its own buffer, but the upstream node is free to
+   replace the buffer pointers with its own to avoid a copy, so the pointers are restored before each pull. A bus that
+   fails to deliver samples (for instance, an unconnected side-chain) is treated as silent.
+
+   @param timestamp the timestamp of the first sample
+   @param frameCount the number of frames to pull
+   @param pullInputBlock the closure to call to obtain upstream samples
+   */
+  void pullExtraInputs(const AudioTimeStamp* _Nonnull timestamp, AUAudioFrameCount frameCount,
+                       AURenderPullInputBlock _Nonnull pullInputBlock) noexcept {
+    for (size_t bus = 0; bus < extraInputFacets_.size(); ++bus) {
+      resetExtraInput(bus, frameCount);
+      auto& facet{extraInputFacets_[bus]};
+      AudioUnitRenderActionFlags flags = 0;
+      auto status = facet.pullInput(&flags, timestamp, frameCount, NSInteger(bus + 1), pullInputBlock);
+      if (status != noErr) [[unlikely]] {
+        resetExtraInput(bus, frameCount);
+        facet.clear(frameCount);
+      } else {
+        facet.assignBufferList(extraInputBusses_.mutableAudioBufferList(bus));
+      }
+    }
+  }
+
+  /**
+   Point the buffers of an extra input bus back at its own storage, undoing any change made by an upstream node.
+
+   @param bus the index of the extra input bus (0 is input bus 1)
+   @param frameCount the number of frames to expect
+   */
+  void resetExtraInput(size_t bus, AUAudioFrameCount frameCount) noexcept {
+    extraInputBusses_.reset(bus);
+    extraInputBusses_.setFrameCount(bus, frameCount);
+    extraInputFacets_[bus].assignBufferList(extraInputBusses_.mutableAudioBufferList(bus));
+  }
+
+  void meterOutput(size_t outputBusIndex, AUAudioFrameCount frameCount) noexcept {
+    if (outputBusIndex < meters_.size() && metering_.load(std::memory_order_relaxed)) [[unlikely]] {
+      meters_[outputBusIndex]->process(outputFacets_[outputBusIndex], frameCount);
+    }
+  }
+
   void render(NSInteger outputBusNumber, AudioTimeStamp const* _Nonnull timestamp, AUAudioFrameCount frameCount,
               AURenderEvent const* _Nullable events) noexcept {
     auto& outputFacet{outputFacets_[size_t(outputBusNumber)]};
@@ -340,10 +834,135 @@ private:
     }
   }
 
+  /// Holds the samples going into and coming out of the kernel when rendering fixed-size blocks.
+  struct FixedBlockStage {
+    void allocate(AUAudioChannelCount channelCount) {
+      samples.assign(2 * size_t(channelCount) * FixedBlockSize, AUValue(0.0));
+      input.resize(channelCount);
+      output.resize(channelCount);
+      for (size_t channel = 0; channel < channelCount; ++channel) {
+        input[channel] = samples.data() + channel * FixedBlockSize;
+        output[channel] = samples.data() + (channelCount + channel) * FixedBlockSize;
+      }
+      fill = 0;
+    }
+
+    std::vector<AUValue> samples{};
+    std::vector<AUValue*> input{};
+    std::vector<AUValue*> output{};
+    AUAudioFrameCount fill{0};
+  };
+
+  void renderFixedBlocks(size_t outputBusIndex, AudioTimeStamp const* _Nonnull timestamp, AUAudioFrameCount frameCount,
+                         AURenderEvent const* _Nullable events, bool hasInput) noexcept {
+    auto& stage{blockStages_[outputBusIndex]};
+    auto ins{inputFacet_.busBuffers()};
+    auto outs{outputFacets_[outputBusIndex].busBuffers()};
+    auto now = AUEventSampleTime(timestamp->mSampleTime);
+    AUAudioFrameCount processed = 0;
+
+    while (processed < frameCount) {
+
+      // Move input samples into the stage, and move the output from the last block out of it. Input must be copied
+      // first since `ins` and `outs` may hold the same buffers when rendering in-place.
+      auto count = std::min(FixedBlockSize - stage.fill, frameCount - processed);
+      for (size_t channel = 0; channel < outs.size(); ++channel) {
+        auto stageIn = stage.input[channel] + stage.fill;
+        if (hasInput) {
+          std::copy_n(ins[channel] + processed, count, stageIn);
+        } else {
+          std::fill_n(stageIn, count, AUValue(0.0));
+        }
+        std::copy_n(stage.output[channel] + stage.fill, count, outs[channel] + processed);
+      }
+
+      processed += count;
+      stage.fill += count;
+      if (stage.fill == FixedBlockSize) {
+        if (events != nullptr) events = processEventsUntil(now + AUEventSampleTime(processed) - 1, events);
+        renderFixedBlock(stage);
+        stage.fill = 0;
+      }
+    }
+
+    // The remaining events belong to the block that is not yet full, so apply them now before it is rendered.
+    if (events != nullptr) processEventsUntil(std::numeric_limits<AUEventSampleTime>::max(), events);
+  }
+
+  void renderFixedBlock(FixedBlockStage& stage) noexcept {
+#if DSPHEADERS_RENDER_METRICS_ENABLED
+    ++subBlockCount_;
+#endif
+    if (isBypassed()) {
+      for (size_t channel = 0; channel < stage.input.size(); ++channel) {
+        std::copy_n(stage.input[channel], FixedBlockSize, stage.output[channel]);
+      }
+    } else {
+      derived_.doRendering(BusBuffers(stage.input), BusBuffers(stage.output), FixedBlockSize);
+    }
+  }
+
   void processEventParameterChange(const AUParameterEvent& event, AUAudioFrameCount duration) noexcept {
-    if (setImmediateParameterValue(event.parameterAddress, event.value, duration)) {
-      rampRemaining_ = std::max(duration - 1, rampRemaining_);
+    processParameterChange(event.parameterAddress, event.value, duration);
+  }
+
+  void processParameterChange(AUParameterAddress address, AUValue value, AUAudioFrameCount duration) noexcept {
+    // A duration of 0 or 1 is an immediate change, which leaves nothing to ramp.
+    if (setImmediateParameterValue(address, value, duration)) {
+      rampRemaining_ = std::max(duration > 0 ? duration - 1 : 0, rampRemaining_);
+    }
+  }
+
+  /**
+   Bring the parameters up to date for the frames about to be rendered. The commands from the UI that are due are
+   applied after the pending changes are checked, since a ramp that a command starts has already taken its first step
+   and must not be stepped again in this pass. Both happen before rendering so that they affect all of the frames.
+
+   @param timestamp the timestamp of the first frame
+   @param frameCount the number of frames to render
+   */
+  void updateParameters(const AudioTimeStamp* _Nonnull timestamp, AUAudioFrameCount frameCount) noexcept {
+    checkForParameterValueChanges();
+    applyCommands(AUEventSampleTime(timestamp->mSampleTime) + AUEventSampleTime(frameCount));
+  }
+
+  /**
+   Apply the queued commands whose sample times come before the given time. Commands are applied in the order they
+   were posted, so this stops at the first command that is not yet due.
+
+   @param end the sample time just after the last frame being rendered
+   */
+  void applyCommands(AUEventSampleTime end) noexcept {
+    while (auto command = commands_.peek()) {
+      if (command->sampleTime >= end) break;
+      if (command->kind == Command::Kind::parameter) {
+        if (!isSuperseded(*command, end)) {
+          DSPHEADERS_RENDER_LOG(renderLog_, "Command parameter - %" PRIu64 " %f", command->address, command->value);
+          processParameterChange(command->address, command->value,
+                                 command->rampDuration * AUAudioFrameCount(oversampler_.factor()));
+        }
+      } else {
+        if constexpr (HasCommand<KernelType>) derived_.doCommand(*command);
+      }
+      commands_.pop();
+    }
+  }
+
+  /**
+   Determine if a parameter command does not need to be applied because there is a later command for the same
+   parameter that is also due. Only looks `commandCoalesceWindow` commands ahead so the cost stays bounded.
+
+   @param command the parameter command to check
+   @param end the sample time just after the last frame being rendered
+   @returns true if the command can be skipped
+   */
+  bool isSuperseded(const Command& command, AUEventSampleTime end) noexcept {
+    for (size_t offset = 1; offset <= commandCoalesceWindow; ++offset) {
+      auto later = commands_.peek(offset);
+      if (later == nullptr || later->sampleTime >= end) return false;
+      if (later->kind == Command::Kind::parameter && later->address == command.address) return true;
     }
+    return false;
   }
 
   AURenderEvent const* _Nullable processEventsUntil(AUEventSampleTime now,
@@ -351,15 +970,17 @@ private:
     while (event != nullptr && event->head.eventSampleTime <= now) {
       switch (event->head.eventType) {
         case AURenderEventParameter:
-          os_log_info(log_, "AURenderEventParameter - %llu %f", event->parameter.parameterAddress,
-                      event->parameter.value);
+          DSPHEADERS_RENDER_LOG(renderLog_, "AURenderEventParameter - %" PRIu64 " %f",
+                                event->parameter.parameterAddress, event->parameter.value);
           processEventParameterChange(event->parameter, treeBasedRampDuration_);
           break;
 
         case AURenderEventParameterRamp:
-          os_log_info(log_, "AURenderEventParameterRamp - %llu %f %d", event->parameter.parameterAddress,
-                      event->parameter.value, event->parameter.rampDurationSampleFrames);
-          processEventParameterChange(event->parameter, event->parameter.rampDurationSampleFrames);
+          DSPHEADERS_RENDER_LOG(renderLog_, "AURenderEventParameterRamp - %" PRIu64 " %f %u",
+                                event->parameter.parameterAddress, event->parameter.value,
+                                event->parameter.rampDurationSampleFrames);
+          processEventParameterChange(event->parameter, event->parameter.rampDurationSampleFrames *
+                                      AUAudioFrameCount(oversampler_.factor()));
           break;
 
         case AURenderEventMIDI:
@@ -368,7 +989,10 @@ private:
           break;
 
         case AURenderEventMIDIEventList:
-          // TODO: handle MIDI v2 packets
+          if constexpr (HasMIDIEventV2<KernelType>) {
+            MIDI2::forEachEvent(event->MIDIEventsList.eventList,
+                                [this](const MIDI2::Event& midi) { derived_.doMIDI2Event(midi); });
+          }
           break;
 
         default:
@@ -385,27 +1009,95 @@ private:
     // one shot. As a result, we must adjust buffer pointers by the number of processed samples so far before we
     // let the kernel render into our buffers.
     for (auto& facet : outputFacets_) facet.setOffset(processed);
+    if (inputPulled_) {
+      inputFacet_.setOffset(processed);
+      for (auto& facet : extraInputFacets_) facet.setOffset(processed);
+    }
+#if DSPHEADERS_RENDER_METRICS_ENABLED
+    ++subBlockCount_;
+#endif
     isBypassed() ? bypassedFrames(outputFacet, frameCount, processed) : renderedFrames(outputFacet, frameCount);
   }
 
   inline void bypassedFrames(BusBufferFacet& outputFacet, AUAudioFrameCount frameCount, AUAudioFrameCount processed) {
     // If we have input samples from an upstream node, either use the sample buffers directly or copy samples over
     // to the output buffer. Otherwise, we have already zero'd out the output buffer, so we are done.
-    if (inputFacet_.isLinked()) {
+    if constexpr (HasMultiBusRendering<KernelType>) {
+      if (inputFacet_.isLinked()) {
+        for (auto& facet : outputFacets_) inputFacet_.copyInto(facet, processed, frameCount);
+      }
+    } else if (oversampler_.factor() > 1) {
+      bypassOversampled(outputFacet, frameCount);
+    } else if (inputFacet_.isLinked()) {
       inputFacet_.copyInto(outputFacet, processed, frameCount);
     }
   }
 
+  void bypassOversampled(BusBufferFacet& outputFacet, AUAudioFrameCount frameCount) {
+    // Send the input through the filters without rendering it, so that the bypassed signal has the same latency as
+    // the rendered one and toggling bypass does not make it jump.
+    auto input = inputPulled_ ? oversampler_.upsample(inputFacet_.busBuffers(), frameCount)
+                              : oversampler_.silence(frameCount);
+    oversampler_.output().copyFrom(input, frameCount * AUAudioFrameCount(oversampler_.factor()));
+    oversampler_.downsample(outputFacet.busBuffers(), frameCount);
+  }
+
   inline void renderedFrames(BusBufferFacet& outputFacet, AUAudioFrameCount frameCount) {
-    derived_.doRendering(inputFacet_.busBuffers(), outputFacet.busBuffers(), frameCount);
+    // `BusBuffers` values hold copies of the facet pointers, so refresh them to pick up the current offset.
+    if constexpr (HasMultiBusRendering<KernelType>) {
+      for (size_t bus = 0; bus < outputFacets_.size(); ++bus) outputBusBuffers_[bus] = outputFacets_[bus].busBuffers();
+      derived_.doRendering(inputFacet_.busBuffers(), std::span<BusBuffers>(outputBusBuffers_), frameCount);
+    } else if constexpr (HasMultiInputRendering<KernelType>) {
+      inputBusBuffers_[0] = inputFacet_.busBuffers();
+      for (size_t bus = 0; bus < extraInputFacets_.size(); ++bus) {
+        inputBusBuffers_[bus + 1] = extraInputFacets_[bus].busBuffers();
+      }
+      derived_.doRendering(std::span<BusBuffers>(inputBusBuffers_), outputFacet.busBuffers(), frameCount);
+    } else if (oversampler_.factor() > 1) {
+      renderOversampled(outputFacet, frameCount);
+    } else {
+      derived_.doRendering(inputFacet_.busBuffers(), outputFacet.busBuffers(), frameCount);
+    }
+  }
+
+  void renderOversampled(BusBufferFacet& outputFacet, AUAudioFrameCount frameCount) {
+    auto input = inputPulled_ ? oversampler_.upsample(inputFacet_.busBuffers(), frameCount)
+                              : oversampler_.silence(frameCount);
+    derived_.doRendering(input, oversampler_.output(), frameCount * AUAudioFrameCount(oversampler_.factor()));
+    oversampler_.downsample(outputFacet.busBuffers(), frameCount);
   }
 
   KernelType& derived_;
-  std::vector<BusSampleBuffer> outputBusses_{};
+  BufferArena outputBusses_{};
   std::vector<BusBufferFacet> outputFacets_{};
+  std::vector<FixedBlockStage> blockStages_{};
+  std::vector<BusBuffers> outputBusBuffers_{};
+  Float64 cachedSampleTime_{0.0};
+  AUAudioFrameCount cachedFrameCount_{0};
+  bool cacheValid_{false};
+  bool cachedSilence_{false};
   BusBufferFacet inputFacet_{};
+  BufferArena inputBus_{};
+  size_t inputBusCount_{1};
+  bool inputPulled_{false};
+  BufferArena extraInputBusses_{};
+  std::vector<BusBufferFacet> extraInputFacets_{};
+  std::vector<BusBuffers> inputBusBuffers_{};
+  size_t oversamplingFactor_{1};
+  Oversampler oversampler_{};
   AUAudioFrameCount treeBasedRampDuration_{0};
   AUAudioFrameCount rampRemaining_{0};
+  AUAudioFrameCount silentFrames_{0};
+
+#if DSPHEADERS_RENDER_METRICS_ENABLED
+  RenderMetrics renderMetrics_{};
+  uint64_t subBlockCount_{0};
+#endif
+
+  std::vector<std::unique_ptr<BusMeter>> meters_{};
+  double meterWindowSeconds_{0.0};
+  size_t scopeDecimation_{0};
+  std::atomic<bool> metering_{false};
 
   std::atomic<bool> bypassed_{false};
   std::atomic<bool> rendering_{false};
@@ -413,6 +1105,7 @@ private:
   double sampleRate_{};
 
   ParameterMap parameters_{};
+  SPSCQueue<Command, commandQueueCapacity> commands_{};
 };
 
 /**
@@ -0,0 +1,253 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <cstdint>
+
+#import "DSPHeaders/AudioTypes.hpp"
+
+/**
+ Decoding of the Universal MIDI Packet (UMP) messages found in a `MIDIEventList`. The decoder walks the packets in
+ place and hands each channel voice message to a handler as a small `Event` value, so nothing is copied or allocated.
+ MIDI 2.0 channel voice messages (message type 4) are delivered as-is. MIDI 1.0 channel voice messages (message type 2)
+ are converted to their MIDI 2.0 form with the min-center-max value scaling from the UMP specification so that a kernel
+ only needs to handle one form. All other message types are skipped.
+ */
+namespace DSPHeaders::MIDI2 {
+
+/// The channel voice messages that are decoded.
+enum class Kind : UInt8 {
+  registeredPerNoteController = 0x0,
+  assignablePerNoteController = 0x1,
+  registeredController = 0x2,
+  assignableController = 0x3,
+  relativeRegisteredController = 0x4,
+  relativeAssignableController = 0x5,
+  perNotePitchBend = 0x6,
+  noteOff = 0x8,
+  noteOn = 0x9,
+  polyPressure = 0xA,
+  controlChange = 0xB,
+  programChange = 0xC,
+  channelPressure = 0xD,
+  pitchBend = 0xE,
+  perNoteManagement = 0xF
+};
+
+/**
+ A decoded channel voice message. Fields that do not apply to a message kind are zero.
+ */
+struct Event {
+  Kind kind;
+  /// The UMP group (0-15) of the message
+  UInt8 group;
+  /// The MIDI channel (0-15) of the message
+  UInt8 channel;
+  /// Note number for note, poly pressure, and per-note messages
+  UInt8 note;
+  /// Controller number for controller messages, or program number for `programChange`
+  UInt8 index;
+  /// Option flags for `programChange` (bit 0 means `bank` is valid) and `perNoteManagement`
+  UInt8 flags;
+  /// Attribute type for note messages
+  UInt8 attributeType;
+  /// Bank for registered and assignable controllers, or 14-bit bank (MSB << 7 | LSB) for `programChange`
+  UInt16 bank;
+  /// Velocity for note messages
+  UInt16 velocity;
+  /// Attribute value for note messages
+  UInt16 attribute;
+  /// 32-bit data value for controller, pressure, and pitch bend messages. Pitch bends are centered at 0x80000000.
+  UInt32 value;
+};
+
+/**
+ Obtain the number of 32-bit words in a UMP message.
+
+ @param word the first word of the message
+ @returns number of words in the message (1-4)
+ */
+constexpr UInt32 messageWordCount(UInt32 word) noexcept {
+  constexpr UInt8 counts[16] = {1, 1, 1, 2, 2, 4, 1, 1, 2, 2, 2, 3, 3, 4, 4, 4};
+  return counts[word >> 28];
+}
+
+/**
+ Scale a value to a larger number of bits such that the minimum, center, and maximum values of the source map to the
+ minimum, center, and maximum values of the destination. This is the translation defined by the UMP specification for
+ converting MIDI 1.0 values into MIDI 2.0 ones.
+
+ @param value the value to scale
+ @param sourceBits the number of bits in `value`
+ @param destinationBits the number of bits to scale to
+ @returns scaled value
+ */
+constexpr UInt32 scaleUp(UInt32 value, UInt32 sourceBits, UInt32 destinationBits) noexcept {
+  auto scaleBits = destinationBits - sourceBits;
+  auto shifted = value << scaleBits;
+  if (value <= (1U << (sourceBits - 1))) return shifted;
+
+  // Above the center, fill in the low bits by repeating the bits of the value below its top bit.
+  auto repeatBits = sourceBits - 1;
+  auto repeatValue = value & ((1U << repeatBits) - 1);
+  repeatValue = scaleBits > repeatBits
+    ? repeatValue << (scaleBits - repeatBits)
+    : repeatValue >> (repeatBits - scaleBits);
+  while (repeatValue != 0) {
+    shifted |= repeatValue;
+    repeatValue >>= repeatBits;
+  }
+  return shifted;
+}
+
+/**
+ Decode a MIDI 2.0 channel voice message (message type 4).
+
+ @param words the two words of the message
+ @param event the event to fill in
+ @returns true if the message is a known channel voice message
+ */
+constexpr bool decodeMIDI2(const UInt32* _Nonnull words, Event& event) noexcept {
+  auto status = UInt8((words[0] >> 20) & 0x0F);
+  if (status == 0x7) return false;
+  auto byte3 = UInt8((words[0] >> 8) & 0xFF);
+  auto byte4 = UInt8(words[0] & 0xFF);
+  auto data = words[1];
+
+  event = Event{};
+  event.kind = Kind(status);
+  event.group = UInt8((words[0] >> 24) & 0x0F);
+  event.channel = UInt8((words[0] >> 16) & 0x0F);
+  switch (event.kind) {
+    case Kind::registeredPerNoteController:
+    case Kind::assignablePerNoteController:
+      event.note = byte3;
+      event.index = byte4;
+      event.value = data;
+      break;
+    case Kind::registeredController:
+    case Kind::assignableController:
+    case Kind::relativeRegisteredController:
+    case Kind::relativeAssignableController:
+      event.bank = byte3;
+      event.index = byte4;
+      event.value = data;
+      break;
+    case Kind::perNotePitchBend:
+    case Kind::polyPressure:
+      event.note = byte3;
+      event.value = data;
+      break;
+    case Kind::noteOff:
+    case Kind::noteOn:
+      event.note = byte3;
+      event.attributeType = byte4;
+      event.velocity = UInt16(data >> 16);
+      event.attribute = UInt16(data & 0xFFFF);
+      break;
+    case Kind::controlChange:
+      event.index = byte3;
+      event.value = data;
+      break;
+    case Kind::programChange:
+      event.flags = byte4;
+      event.index = UInt8(data >> 24);
+      event.bank = UInt16(((data >> 8) & 0x7F) << 7 | (data & 0x7F));
+      break;
+    case Kind::channelPressure:
+    case Kind::pitchBend:
+      event.value = data;
+      break;
+    case Kind::perNoteManagement:
+      event.note = byte3;
+      event.flags = byte4;
+      break;
+  }
+  return true;
+}
+
+/**
+ Decode a MIDI 1.0 channel voice message (message type 2) into its MIDI 2.0 form. A note on with zero velocity becomes
+ a note off with the default release velocity of 64.
+
+ @param word the message
+ @param event the event to fill in
+ @returns true if the message is a known channel voice message
+ */
+constexpr bool decodeMIDI1(UInt32 word, Event& event) noexcept {
+  auto status = UInt8((word >> 20) & 0x0F);
+  auto data1 = UInt8((word >> 8) & 0x7F);
+  auto data2 = UInt8(word & 0x7F);
+  if (status < 0x8 || status == 0xF) return false;
+
+  event = Event{};
+  event.kind = Kind(status);
+  event.group = UInt8((word >> 24) & 0x0F);
+  event.channel = UInt8((word >> 16) & 0x0F);
+  switch (event.kind) {
+    case Kind::noteOn:
+    case Kind::noteOff:
+      event.note = data1;
+      if (event.kind == Kind::noteOn && data2 == 0) {
+        event.kind = Kind::noteOff;
+        data2 = 64;
+      }
+      event.velocity = UInt16(scaleUp(data2, 7, 16));
+      break;
+    case Kind::polyPressure:
+      event.note = data1;
+      event.value = scaleUp(data2, 7, 32);
+      break;
+    case Kind::controlChange:
+      event.index = data1;
+      event.value = scaleUp(data2, 7, 32);
+      break;
+    case Kind::programChange:
+      event.index = data1;
+      break;
+    case Kind::channelPressure:
+      event.value = scaleUp(data1, 7, 32);
+      break;
+    case Kind::pitchBend:
+      event.value = scaleUp(UInt32(data2) << 7 | data1, 14, 32);
+      break;
+    default:
+      break;
+  }
+  return true;
+}
+
+/**
+ Visit the channel voice messages in a `MIDIEventList` in order. A message that runs past the end of its packet ends
+ the processing of that packet.
+
+ @param list the packets to decode
+ @param handler callable that takes a `const Event&`
+ @returns number of events given to the handler
+ */
+template <typename Handler>
+size_t forEachEvent(const MIDIEventList& list, Handler&& handler) noexcept {
+  size_t count = 0;
+  auto packet = &list.packet[0];
+  for (UInt32 packetIndex = 0; packetIndex < list.numPackets; ++packetIndex) {
+    auto words = packet->words;
+    auto end = packet->words + packet->wordCount;
+    while (words < end) {
+      auto wordCount = messageWordCount(words[0]);
+      if (words + wordCount > end) [[unlikely]] break;
+      Event event;
+      auto messageType = words[0] >> 28;
+      if ((messageType == 0x4 && decodeMIDI2(words, event)) || (messageType == 0x2 && decodeMIDI1(words[0], event))) {
+        handler(static_cast<const Event&>(event));
+        ++count;
+      }
+      words += wordCount;
+    }
+
+    // Same as CoreMIDI's `MIDIEventPacketNext` -- the next packet starts right after the last word of this one.
+    packet = reinterpret_cast<const MIDIEventPacket*>(end);
+  }
+  return count;
+}
+
+} // end namespace DSPHeaders::MIDI2
@@ -0,0 +1,258 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <algorithm>
+#import <array>
+#import <bit>
+#import <cassert>
+#import <cmath>
+#import <memory>
+#import <new>
+#import <span>
+#import <type_traits>
+
+#import "DSPHeaders/DelayInterpolation.hpp"
+
+namespace DSPHeaders {
+
+/**
+ Circular buffer of multichannel frames for delay kernels that treat all channels alike. It behaves like a
+ `DelayBuffer` for each channel, but the samples of a frame are stored next to each other. There is one write
+ position and one wrap mask for all channels, and a read computes its position and interpolation weights once for the
+ frame and then applies them to every channel.
+
+ Frames are padded to a power-of-two number of samples -- a stereo frame takes 2, a 5.1 frame 8 -- so that the
+ per-channel loops have a fixed width that the compiler turns into SIMD operations on the whole frame. The storage
+ starts on a 64-byte boundary, so a frame of up to 64 bytes never straddles a cache line. Padding samples are always
+ zero.
+
+ Only the stateless interpolators from `DelayInterpolation` may be used.
+
+ This buffer is not thread-safe. It is to be used in a the rendering flow of one bus of audio.
+
+ @tparam ValueType the type of sample to hold
+ @tparam ChannelCount the number of channels in a frame
+ @tparam InterpolatorType the interpolation policy
+ */
+template <typename ValueType, size_t ChannelCount, typename InterpolatorType = DelayInterpolation::Runtime>
+class MultiChannelDelayBuffer {
+public:
+  static_assert(ChannelCount > 0, "MultiChannelDelayBuffer needs at least one channel");
+
+  /// The number of samples held for each frame
+  static constexpr size_t frameStride = std::bit_ceil(ChannelCount);
+
+  /// The alignment of the sample storage in bytes
+  static constexpr size_t alignment = 64;
+
+  /// The samples of one frame
+  using Frame = std::array<ValueType, ChannelCount>;
+
+  /// Types of interpolation that can be chosen at runtime to generate sample values using floating-point indices.
+  using Interpolator = DelayInterpolation::Kind;
+
+  /**
+   Construct new buffer that can hold given number of frames.
+
+   @param sizeInSamples capacity of the buffer in frames
+   @param interpolator the interpolation to apply to the samples
+   */
+  MultiChannelDelayBuffer(double sizeInSamples, InterpolatorType interpolator = {}) noexcept :
+  writePos_{0}, wrapMask_{smallestPowerOf2For(sizeInSamples) - 1}, interpolator_{interpolator} {
+    buffer_.reset(static_cast<ValueType*>(::operator new(sampleCount() * sizeof(ValueType),
+                                                         std::align_val_t{alignment})));
+    clear();
+  }
+
+  MultiChannelDelayBuffer(MultiChannelDelayBuffer&&) noexcept = default;
+  MultiChannelDelayBuffer& operator=(MultiChannelDelayBuffer&&) noexcept = default;
+  MultiChannelDelayBuffer(const MultiChannelDelayBuffer&) = delete;
+  MultiChannelDelayBuffer& operator=(const MultiChannelDelayBuffer&) = delete;
+
+  /**
+   Wipe the buffer contents by filling it with zeros.
+   */
+  void clear() noexcept { std::fill_n(buffer_.get(), sampleCount(), ValueType{0.0}); }
+
+  /**
+   Physical size of the buffer in frames. This is always a power of 2 and may not match the value given in the
+   constructor.
+
+   @return buffer size
+   */
+  size_t size() const noexcept { return wrapMask_ + 1; }
+
+  /**
+   Write a frame to the end of the buffer, advancing the write position to the next location.
+
+   @param frame the samples to add
+   */
+  void write(const Frame& frame) noexcept {
+    std::copy_n(frame.begin(), ChannelCount, buffer_.get() + writePos_ * frameStride);
+    writePos_ = (writePos_ + 1) & wrapMask_;
+  }
+
+  /**
+   Write a block of frames from non-interleaved channels to the end of the buffer.
+
+   @param channels the samples of each channel. Must have `ChannelCount` entries.
+   @param frameCount the number of frames to write
+   */
+  void writeBlock(std::span<const ValueType* const> channels, size_t frameCount) noexcept {
+    assert(channels.size() == ChannelCount);
+    for (size_t index = 0; index < frameCount; ++index) {
+      auto dest = buffer_.get() + writePos_ * frameStride;
+      for (size_t channel = 0; channel < ChannelCount; ++channel) dest[channel] = channels[channel][index];
+      writePos_ = (writePos_ + 1) & wrapMask_;
+    }
+  }
+
+  /**
+   Obtain a frame from the buffer.
+
+   @param offset how many frames before the current write position to return
+   @return frame from buffer
+   */
+  Frame readFromOffset(ssize_t offset) const noexcept {
+    Frame frame;
+    std::copy_n(frameAt(writePos_ - 1 - offset), ChannelCount, frame.begin());
+    return frame;
+  }
+
+  /**
+   Obtain a frame from the buffer using interpolation method defined at construction.
+
+   @param delay distance from the current write position to return
+   @return interpolated frame from buffer
+   */
+  Frame read(ValueType delay) const noexcept {
+    auto whole = size_t(delay);
+    auto lanes = withInterpolator([&](const auto& policy) {
+      return interpolate(policy, writePos_ - 1 - whole, delay - whole);
+    });
+    Frame frame;
+    std::copy_n(lanes.begin(), ChannelCount, frame.begin());
+    return frame;
+  }
+
+  /**
+   Obtain a block of frames at a fixed delay, written to non-interleaved channels. The block lines up with the last
+   `frameCount` frames written, as with `DelayBuffer::readBlock`. The interpolation weights are computed once.
+
+   @param channels the place to write the samples of each channel. Must have `ChannelCount` entries.
+   @param frameCount the number of frames to read
+   @param delay distance from the write position of each frame to return
+   */
+  void readBlock(std::span<ValueType* const> channels, size_t frameCount, ValueType delay) const noexcept {
+    assert(channels.size() == ChannelCount && delay >= 0.0);
+    auto whole = size_t(delay);
+    ValueType partial = delay - whole;
+    auto first = writePos_ - frameCount - whole;
+    withInterpolator([&](const auto& policy) {
+      using Policy = std::decay_t<decltype(policy)>;
+      if (partial == 0.0) {
+        for (size_t index = 0; index < frameCount; ++index) store(channels, index, weighted<1>(first + index, {1.0}));
+      } else {
+        auto weights = Policy::weights(partial);
+        for (size_t index = 0; index < frameCount; ++index) {
+          store(channels, index, weighted(first + index + Policy::newer, weights));
+        }
+      }
+    });
+  }
+
+  /**
+   Obtain a block of frames with a separate delay for each one, written to non-interleaved channels. The block lines up
+   with the last `delays.size()` frames written. Each frame computes its position and weights once for all channels.
+
+   @param channels the place to write the samples of each channel. Must have `ChannelCount` entries.
+   @param delays distance from the write position of each frame to return
+   */
+  void readBlock(std::span<ValueType* const> channels, std::span<const ValueType> delays) const noexcept {
+    assert(channels.size() == ChannelCount);
+    auto last = writePos_ - delays.size();
+    withInterpolator([&](const auto& policy) {
+      for (size_t index = 0; index < delays.size(); ++index) {
+        auto whole = size_t(delays[index]);
+        store(channels, index, interpolate(policy, last + index - whole, delays[index] - whole));
+      }
+    });
+  }
+
+private:
+  using Lanes = std::array<ValueType, frameStride>;
+
+  struct Deleter {
+    void operator()(ValueType* pointer) const noexcept { ::operator delete(pointer, std::align_val_t{alignment}); }
+  };
+
+  static size_t smallestPowerOf2For(double value) noexcept {
+    return size_t(std::pow(2.0, std::ceil(std::log2(std::fmax(value, 1.0)))));
+  }
+
+  /**
+   Invoke a function with the interpolation policy to use. For the runtime adapter, this is the policy it selected.
+
+   @param proc the function to call
+   @returns the result of the function
+   */
+  template <typename Proc>
+  decltype(auto) withInterpolator(Proc&& proc) const noexcept {
+    if constexpr (std::is_same_v<InterpolatorType, DelayInterpolation::Runtime>) {
+      return interpolator_.visit(std::forward<Proc>(proc));
+    } else {
+      return proc(interpolator_);
+    }
+  }
+
+  /// @returns the number of samples in the buffer, including the padding
+  size_t sampleCount() const noexcept { return size() * frameStride; }
+
+  /// @returns pointer to the first sample of the frame at an unmasked position
+  const ValueType* frameAt(size_t pos) const noexcept { return buffer_.get() + (pos & wrapMask_) * frameStride; }
+
+  /**
+   Obtain an interpolated frame.
+
+   @param policy the interpolation to use
+   @param pos the unmasked frame index of the frame at the whole part of the delay
+   @param partial the non-integral part of the delay
+   @returns interpolated frame, including the padding
+   */
+  template <typename Policy>
+  Lanes interpolate(const Policy&, size_t pos, ValueType partial) const noexcept {
+    static_assert(DelayInterpolation::WeightedInterpolator<Policy, ValueType>,
+                  "MultiChannelDelayBuffer needs an interpolator without state");
+    if (partial == 0.0) return weighted<1>(pos, {1.0});
+    return weighted(pos + Policy::newer, Policy::weights(partial));
+  }
+
+  /**
+   Obtain the weighted sum of `Taps` consecutive frames.
+
+   @param newest the unmasked frame index of the newest frame to use
+   @param weights the weight to apply to each frame, newest first
+   @returns the sum, including the padding
+   */
+  template <size_t Taps>
+  Lanes weighted(size_t newest, const std::array<ValueType, Taps>& weights) const noexcept {
+    Lanes sum{};
+    for (size_t tap = 0; tap < Taps; ++tap) {
+      auto frame = frameAt(newest - tap);
+      for (size_t lane = 0; lane < frameStride; ++lane) sum[lane] += weights[tap] * frame[lane];
+    }
+    return sum;
+  }
+
+  static void store(std::span<ValueType* const> channels, size_t index, const Lanes& lanes) noexcept {
+    for (size_t channel = 0; channel < ChannelCount; ++channel) channels[channel][index] = lanes[channel];
+  }
+
+  std::unique_ptr<ValueType[], Deleter> buffer_;
+  size_t writePos_;
+  size_t wrapMask_;
+  InterpolatorType interpolator_;
+};
+
+} // end namespace DSPHeaders
@@ -0,0 +1,381 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <algorithm>
+#import <array>
+#import <chrono>
+#import <functional>
+#import <span>
+#import <stdexcept>
+#import <vector>
+
+#import "DSPHeaders/AudioTypes.hpp"
+#import "DSPHeaders/BusSampleBuffer.hpp"
+#import "DSPHeaders/SampleFormat.hpp"
+
+namespace DSPHeaders {
+
+/**
+ Headless driver that pushes audio through an `EventProcessor` kernel as fast as the CPU allows, without any
+ AVAudioEngine or `SimplePlayEngine` involvement. It plays the role of an AUv3 host: it owns the output buffers,
+ provides a pull-input block that serves samples from an in-memory source, builds `AURenderEvent` lists for each render
+ call, and then invokes `processAndRender` for a configurable sequence of block sizes. Time spent inside
+ `processAndRender` is accumulated so that the throughput of a kernel can be reported in frames per second and as a
+ real-time factor.
+
+ Input samples are held either as non-interleaved `AUValue` channels or as interleaved samples in any `SampleFormat`,
+ such as the contents of a WAV file. Interleaved samples are converted straight into the buffers given to the pull-input
+ block, so there is no separate conversion pass over the source. Input samples are looped when the render runs past
+ their end, so hours of audio can be pushed through a kernel from a short source. If the kernel produces more channels
+ than the source has, source channels are reused in round-robin order. Without an input source, no pull-input block is
+ given to the kernel.
+
+ Events are given in absolute sample time and are delivered in the render call that covers their time. The `render`
+ method may be called repeatedly to continue where the last call ended, which allows for events to be generated in
+ chunks instead of all up front.
+
+ This works on Apple platforms as well as on ones that only have the stand-in types from `AudioTypes.hpp`.
+ */
+template <typename KernelType>
+class OfflineRenderer {
+public:
+
+  /// Collection of figures gathered during rendering.
+  struct Statistics {
+    /// The sample rate used for rendering
+    double sampleRate{0.0};
+    /// The number of frames rendered
+    AUEventSampleTime framesRendered{0};
+    /// The number of `processAndRender` calls made
+    size_t renderCalls{0};
+    /// The number of events given to the kernel
+    size_t eventsDelivered{0};
+    /// The total wall-clock time spent in `processAndRender`
+    double renderSeconds{0.0};
+    /// The longest wall-clock time spent in one `processAndRender` call
+    double maxCallSeconds{0.0};
+
+    /// @returns the number of frames rendered per second of wall-clock time
+    double framesPerSecond() const noexcept {
+      return renderSeconds > 0.0 ? double(framesRendered) / renderSeconds : 0.0;
+    }
+
+    /// @returns the number of seconds of audio rendered per second of wall-clock time
+    double realTimeFactor() const noexcept { return sampleRate > 0.0 ? framesPerSecond() / sampleRate : 0.0; }
+  };
+
+  /// Function that is given the rendered output of each `processAndRender` call.
+  using OutputHandler = std::function<void(const AudioBufferList&, AUAudioFrameCount)>;
+
+  /**
+   Construct new instance. Configures the kernel for rendering with the given format.
+
+   @param kernel the `EventProcessor` kernel to drive
+   @param sampleRate the sample rate to render at
+   @param channelCount the number of channels to render
+   @param maxFramesToRender the largest block size that will be requested
+   @throws std::invalid_argument if the kernel does not support `channelCount` channels
+   */
+  OfflineRenderer(KernelType& kernel, double sampleRate, AUAudioChannelCount channelCount,
+                  AUAudioFrameCount maxFramesToRender)
+  : kernel_{kernel}, maxFramesToRender_{maxFramesToRender},
+  blockSizes_{maxFramesToRender} {
+    if (kernel_.setRenderingFormat(1, sampleRate, channelCount, maxFramesToRender) != noErr) {
+      throw std::invalid_argument("unsupported channel count");
+    }
+    statistics_.sampleRate = sampleRate;
+    output_.allocate(channelCount, maxFramesToRender);
+    auto bufferList = output_.mutableAudioBufferList();
+    for (UInt32 channel = 0; channel < bufferList->mNumberBuffers; ++channel) {
+      outputData_.push_back(bufferList->mBuffers[channel].mData);
+    }
+#if defined(__APPLE__)
+    pullInputBlock_ = ^AUAudioUnitStatus(AudioUnitRenderActionFlags* actionFlags, const AudioTimeStamp* timestamp,
+                                         AUAudioFrameCount frameCount, NSInteger, AudioBufferList* inputData) {
+      return this->pullInput(actionFlags, timestamp, frameCount, inputData);
+    };
+#else
+    pullInputBlock_ = [this](AudioUnitRenderActionFlags* actionFlags, const AudioTimeStamp* timestamp,
+                             AUAudioFrameCount frameCount, NSInteger, AudioBufferList* inputData) {
+      return this->pullInput(actionFlags, timestamp, frameCount, inputData);
+    };
+#endif
+  }
+
+  OfflineRenderer(const OfflineRenderer&) = delete;
+  OfflineRenderer(OfflineRenderer&&) = delete;
+  OfflineRenderer& operator =(const OfflineRenderer&) = delete;
+  OfflineRenderer& operator =(OfflineRenderer&&) = delete;
+
+  /**
+   Set the samples to feed to the kernel through its pull-input block.
+
+   @param channels the non-interleaved samples to use. All channels must have the same size.
+   */
+  void setInput(std::vector<std::vector<AUValue>> channels) {
+    for (const auto& channel : channels) {
+      if (channel.size() != channels.front().size()) throw std::invalid_argument("input channel sizes differ");
+    }
+    input_ = std::move(channels);
+    encoded_.clear();
+  }
+
+  /**
+   Set interleaved samples to feed to the kernel through its pull-input block. They are converted to `AUValue` values as
+   the kernel pulls them.
+
+   @param samples the interleaved samples to use
+   @param format the format of the samples. It must be interleaved unless there is only one channel.
+   */
+  void setInput(std::vector<std::byte> samples, StreamFormat format) {
+    if (format.channelCount == 0 || (!format.interleaved && format.channelCount > 1)) {
+      throw std::invalid_argument("input samples must be interleaved");
+    }
+    encodedFrames_ = samples.size() / (bytesPerSample(format.sampleFormat) * format.channelCount);
+    encoded_ = std::move(samples);
+    encodedFormat_ = format;
+    input_.clear();
+  }
+
+  /**
+   Set the sequence of block sizes to render with. The sequence is repeated until the requested number of frames has
+   been rendered. Hosts rarely use a constant size, so this allows for more realistic exercising of a kernel.
+
+   @param blockSizes the block sizes to use
+   */
+  void setBlockSizes(std::vector<AUAudioFrameCount> blockSizes) {
+    if (blockSizes.empty()) throw std::invalid_argument("no block sizes");
+    for (auto size : blockSizes) {
+      if (size == 0 || size > maxFramesToRender_) throw std::invalid_argument("invalid block size");
+    }
+    blockSizes_ = std::move(blockSizes);
+    blockSizeIndex_ = 0;
+  }
+
+  /**
+   Control whether the output buffer given to the kernel has its own storage or is empty, in which case the kernel must
+   render in-place into its own buffer (as some hosts request).
+
+   @param inPlace if true, give the kernel output buffers with nullptr data pointers
+   */
+  void setInPlace(bool inPlace) noexcept { inPlace_ = inPlace; }
+
+  /**
+   Install a function that will receive the output of each `processAndRender` call. The time spent here is not included
+   in the statistics.
+
+   @param handler the function to call
+   */
+  void setOutputHandler(OutputHandler handler) { outputHandler_ = std::move(handler); }
+
+  /**
+   Schedule an `AURenderEventParameter` or `AURenderEventParameterRamp` event.
+
+   @param sampleTime the absolute sample time of the event
+   @param address the address of the parameter to change
+   @param value the new value of the parameter
+   @param rampDuration if not zero, the number of frames to ramp over
+   */
+  void addParameterEvent(AUEventSampleTime sampleTime, AUParameterAddress address, AUValue value,
+                         AUAudioFrameCount rampDuration = 0) {
+    AURenderEvent event{};
+    event.parameter.eventSampleTime = sampleTime;
+    event.parameter.eventType = rampDuration > 0 ? AURenderEventParameterRamp : AURenderEventParameter;
+    event.parameter.rampDurationSampleFrames = rampDuration;
+    event.parameter.parameterAddress = address;
+    event.parameter.value = value;
+    addEvent(event);
+  }
+
+  /**
+   Schedule an `AURenderEventMIDI` event.
+
+   @param sampleTime the absolute sample time of the event
+   @param status the MIDI status byte
+   @param data1 the first MIDI data byte
+   @param data2 the second MIDI data byte
+   @param length the number of valid bytes in the message
+   */
+  void addMIDIEvent(AUEventSampleTime sampleTime, UInt8 status, UInt8 data1, UInt8 data2, UInt16 length = 3) {
+    AURenderEvent event{};
+    event.MIDI.eventSampleTime = sampleTime;
+    event.MIDI.eventType = AURenderEventMIDI;
+    event.MIDI.length = length;
+    event.MIDI.data[0] = status;
+    event.MIDI.data[1] = data1;
+    event.MIDI.data[2] = data2;
+    addEvent(event);
+  }
+
+  /**
+   Render the given number of frames, continuing from where the last `render` call stopped.
+
+   @param frameCount the number of frames to render
+   @returns `noErr` if successful or the first error returned by the kernel
+   */
+  AUAudioUnitStatus render(AUEventSampleTime frameCount) {
+    linkEvents();
+    auto end = now_ + frameCount;
+    while (now_ < end) {
+      auto frames = AUAudioFrameCount(std::min(AUEventSampleTime(nextBlockSize()), end - now_));
+      auto status = renderBlock(frames);
+      if (status != noErr) return status;
+    }
+    events_.erase(events_.begin(), events_.begin() + ptrdiff_t(nextEvent_));
+    nextEvent_ = 0;
+    linked_ = false;
+    return noErr;
+  }
+
+  /// @returns the sample time of the next frame to render
+  AUEventSampleTime sampleTime() const noexcept { return now_; }
+
+  /// @returns the statistics gathered so far
+  const Statistics& statistics() const noexcept { return statistics_; }
+
+  /// Clear the statistics gathered so far.
+  void resetStatistics() noexcept {
+    auto sampleRate = statistics_.sampleRate;
+    statistics_ = Statistics{};
+    statistics_.sampleRate = sampleRate;
+  }
+
+private:
+  using Clock = std::chrono::steady_clock;
+
+  void addEvent(const AURenderEvent& event) {
+    events_.push_back(event);
+    linked_ = false;
+  }
+
+  void linkEvents() noexcept {
+    if (linked_) return;
+    std::stable_sort(events_.begin(), events_.end(), [](const auto& lhs, const auto& rhs) {
+      return lhs.head.eventSampleTime < rhs.head.eventSampleTime;
+    });
+    for (size_t index = 0; index < events_.size(); ++index) {
+      events_[index].head.next = index + 1 < events_.size() ? &events_[index + 1] : nullptr;
+    }
+    linked_ = true;
+  }
+
+  AUAudioFrameCount nextBlockSize() noexcept {
+    auto size = blockSizes_[blockSizeIndex_];
+    blockSizeIndex_ = (blockSizeIndex_ + 1) % blockSizes_.size();
+    return size;
+  }
+
+  AUAudioUnitStatus renderBlock(AUAudioFrameCount frameCount) {
+
+    // Locate the events that fall within this block and temporarily terminate the list after the last one.
+    auto first = nextEvent_;
+    auto last = first;
+    while (last < events_.size() && events_[last].head.eventSampleTime < now_ + AUEventSampleTime(frameCount)) ++last;
+    AURenderEvent* head = first < last ? &events_[first] : nullptr;
+    if (first < last) events_[last - 1].head.next = nullptr;
+
+    auto bufferList = output_.mutableAudioBufferList();
+    for (UInt32 channel = 0; channel < bufferList->mNumberBuffers; ++channel) {
+      bufferList->mBuffers[channel].mData = inPlace_ ? nullptr : outputData_[channel];
+    }
+    output_.setFrameCount(frameCount);
+
+    AudioTimeStamp timestamp{};
+    timestamp.mSampleTime = double(now_);
+    timestamp.mFlags = kAudioTimeStampSampleTimeValid;
+
+    auto start = Clock::now();
+    auto status = kernel_.processAndRender(&timestamp, frameCount, 0, bufferList, head,
+                                           hasInput() ? pullInputBlock_ : nullptr);
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+
+    if (first < last && last < events_.size()) events_[last - 1].head.next = &events_[last];
+    if (status != noErr) return status;
+
+    statistics_.framesRendered += frameCount;
+    statistics_.renderCalls += 1;
+    statistics_.eventsDelivered += last - first;
+    statistics_.renderSeconds += elapsed.count();
+    statistics_.maxCallSeconds = std::max(statistics_.maxCallSeconds, elapsed.count());
+
+    if (outputHandler_) outputHandler_(*bufferList, frameCount);
+
+    nextEvent_ = last;
+    now_ += frameCount;
+    return noErr;
+  }
+
+  bool hasInput() const noexcept { return !input_.empty() || !encoded_.empty(); }
+
+  AUAudioUnitStatus pullInput(AudioUnitRenderActionFlags*, const AudioTimeStamp* timestamp,
+                              AUAudioFrameCount frameCount, AudioBufferList* inputData) noexcept {
+    if (!encoded_.empty()) return pullEncodedInput(timestamp, frameCount, inputData);
+    auto sourceSize = input_.front().size();
+    if (sourceSize == 0) return kAudioUnitErr_NoConnection;
+    for (UInt32 channel = 0; channel < inputData->mNumberBuffers; ++channel) {
+      const auto& source{input_[channel % input_.size()]};
+      auto dest = static_cast<AUValue*>(inputData->mBuffers[channel].mData);
+      auto position = size_t(timestamp->mSampleTime) % sourceSize;
+      for (AUAudioFrameCount frame = 0; frame < frameCount;) {
+        auto count = std::min(size_t(frameCount - frame), sourceSize - position);
+        std::copy_n(source.data() + position, count, dest + frame);
+        frame += AUAudioFrameCount(count);
+        position = 0;
+      }
+    }
+    return noErr;
+  }
+
+  AUAudioUnitStatus pullEncodedInput(const AudioTimeStamp* timestamp, AUAudioFrameCount frameCount,
+                                     AudioBufferList* inputData) noexcept {
+    if (encodedFrames_ == 0) return kAudioUnitErr_NoConnection;
+    auto format = encodedFormat_.sampleFormat;
+    auto stride = encodedFormat_.frameStride();
+    auto channelCount = inputData->mNumberBuffers;
+    auto matched = channelCount == encodedFormat_.channelCount && channelCount <= BusBuffers::maxChannelCount;
+    auto position = size_t(timestamp->mSampleTime) % encodedFrames_;
+    for (AUAudioFrameCount frame = 0; frame < frameCount;) {
+      auto count = std::min(size_t(frameCount - frame), encodedFrames_ - position);
+      auto source = encoded_.data() + position * stride;
+      if (matched) {
+        // Convert all of the channels in one pass over the source.
+        std::array<AUValue*, BusBuffers::maxChannelCount> destinations;
+        for (UInt32 channel = 0; channel < channelCount; ++channel) {
+          destinations[channel] = static_cast<AUValue*>(inputData->mBuffers[channel].mData) + frame;
+        }
+        SampleConversion::deinterleave(format, source, std::span(destinations.data(), channelCount), count);
+      } else {
+        for (UInt32 channel = 0; channel < channelCount; ++channel) {
+          auto offset = (channel % encodedFormat_.channelCount) * bytesPerSample(format);
+          SampleConversion::decode(format, source + offset, stride,
+                                   static_cast<AUValue*>(inputData->mBuffers[channel].mData) + frame, count);
+        }
+      }
+      frame += AUAudioFrameCount(count);
+      position = 0;
+    }
+    return noErr;
+  }
+
+  KernelType& kernel_;
+  AUAudioFrameCount maxFramesToRender_;
+  std::vector<AUAudioFrameCount> blockSizes_;
+  size_t blockSizeIndex_{0};
+  BusSampleBuffer output_{};
+  std::vector<void*> outputData_{};
+  std::vector<std::vector<AUValue>> input_{};
+  std::vector<std::byte> encoded_{};
+  StreamFormat encodedFormat_{};
+  size_t encodedFrames_{0};
+  std::vector<AURenderEvent> events_{};
+  size_t nextEvent_{0};
+  bool linked_{true};
+  bool inPlace_{false};
+  AUEventSampleTime now_{0};
+  OutputHandler outputHandler_{};
+  AURenderPullInputBlock pullInputBlock_{};
+  Statistics statistics_{};
+};
+
+} // end namespace DSPHeaders
@@ -0,0 +1,346 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <algorithm>
+#import <array>
+#import <cassert>
+#import <cmath>
+#import <numbers>
+#import <vector>
+
+#import "DSPHeaders/AudioTypes.hpp"
+#import "DSPHeaders/BusBuffers.hpp"
+
+namespace DSPHeaders {
+
+/**
+ Half-band low-pass FIR filter that changes the sample rate by a factor of 2 in either direction. A half-band filter has
+ a cutoff of 1/4 of the higher sample rate, and every other one of its taps is zero except for the center one which is
+ 1/2. The filter is run in its polyphase form: when upsampling, the even output samples come from the non-zero taps and
+ the odd ones are just delayed input samples; when decimating, only the even output samples are calculated. So the work
+ per sample at the lower rate is that of a `2 * K` tap filter.
+
+ The taps come from a Kaiser-windowed sinc with a stopband attenuation of about 80 dB. The number of taps sets the
+ width of the transition band, so the first stage of an `Oversampler` -- the one whose transition band sits at the
+ Nyquist frequency of the host -- uses more taps than the later ones.
+
+ An instance keeps the history of the samples it has seen, so it can only be used for one direction.
+
+ @param K half the number of non-zero taps, not counting the center one. The full filter has `4 * K - 1` taps.
+ */
+template <size_t K>
+class HalfBandFilter {
+public:
+  static_assert(K > 0, "K must be positive");
+
+  /// The number of taps in the full filter
+  static constexpr size_t tapCount = 4 * K - 1;
+
+  /// The delay of the filter in samples at the higher sample rate.
+  static constexpr AUAudioFrameCount delay = 2 * K - 1;
+
+  /// The Kaiser window shape for a stopband attenuation of 80 dB
+  static constexpr double kaiserBeta = 0.1102 * (80.0 - 8.7);
+
+  HalfBandFilter() noexcept : coefficients_{makeCoefficients()} {}
+
+  /**
+   Allocate the buffers for the filter. Must be called before rendering starts since it allocates memory.
+
+   @param channelCount the number of channels to support
+   @param maxFrameCount the max number of frames at the lower sample rate to process in one call
+   */
+  void allocate(AUAudioChannelCount channelCount, AUAudioFrameCount maxFrameCount) {
+    channels_.resize(channelCount);
+    for (auto& channel : channels_) {
+      channel.first.assign(historySize + maxFrameCount, 0.0);
+      channel.second.assign(historySize + maxFrameCount, 0.0);
+    }
+  }
+
+  /**
+   Forget all past samples.
+   */
+  void reset() noexcept {
+    for (auto& channel : channels_) {
+      std::fill(channel.first.begin(), channel.first.end(), 0.0);
+      std::fill(channel.second.begin(), channel.second.end(), 0.0);
+    }
+  }
+
+  /**
+   Double the sample rate of the samples of a channel.
+
+   @param channel the index of the channel being processed
+   @param input the samples to process
+   @param output the destination for `2 * frameCount` samples
+   @param frameCount the number of input samples
+   */
+  void upsample(size_t channel, const AUValue* input, AUValue* output, AUAudioFrameCount frameCount) noexcept {
+    auto& [samples, sums] = channels_[channel];
+    std::copy_n(input, frameCount, samples.data() + historySize);
+    std::fill_n(sums.begin(), frameCount, 0.0f);
+    accumulate(samples.data(), sums.data(), frameCount);
+
+    // The gain of 2 makes up for the zero samples that are implicitly inserted between the input samples.
+    const auto* delayed = samples.data() + K;
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+      output[2 * frame] = 2.0f * sums[frame];
+      output[2 * frame + 1] = delayed[frame];
+    }
+
+    std::copy_n(samples.data() + frameCount, historySize, samples.data());
+  }
+
+  /**
+   Halve the sample rate of the samples of a channel.
+
+   @param channel the index of the channel being processed
+   @param input the `2 * frameCount` samples to process
+   @param output the destination for the samples
+   @param frameCount the number of output samples
+   */
+  void downsample(size_t channel, const AUValue* input, AUValue* output, AUAudioFrameCount frameCount) noexcept {
+    auto& [evens, odds] = channels_[channel];
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+      evens[historySize + frame] = input[2 * frame];
+      odds[historySize + frame] = input[2 * frame + 1];
+    }
+
+    // The odd phase only has the center tap.
+    const auto* delayed = odds.data() + K - 1;
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+      output[frame] = 0.5f * delayed[frame];
+    }
+    accumulate(evens.data(), output, frameCount);
+
+    std::copy_n(evens.data() + frameCount, historySize, evens.data());
+    std::copy_n(odds.data() + frameCount, historySize, odds.data());
+  }
+
+private:
+  static constexpr size_t phaseTapCount = 2 * K;
+  static constexpr size_t historySize = phaseTapCount - 1;
+
+  /**
+   Add the output of the non-zero taps to `sums`. The loop over the frames is the inner one so that each step is a
+   scaled add of two contiguous blocks of samples, which the compiler turns into SIMD instructions.
+   */
+  void accumulate(const AUValue* samples, AUValue* sums, AUAudioFrameCount frameCount) const noexcept {
+    for (size_t tap = 0; tap < phaseTapCount; ++tap) {
+      auto coefficient = coefficients_[tap];
+      const auto* source = samples + tap;
+      for (size_t frame = 0; frame < frameCount; ++frame) {
+        sums[frame] += coefficient * source[frame];
+      }
+    }
+  }
+
+  static double besselI0(double x) noexcept {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 50 && term > sum * 1e-12; ++k) {
+      auto factor = x / (2.0 * k);
+      term *= factor * factor;
+      sum += term;
+    }
+    return sum;
+  }
+
+  /**
+   Create the even taps of the filter. These are symmetric, so they can be applied to the samples in ascending order
+   without reversing them.
+   */
+  static std::array<AUValue, phaseTapCount> makeCoefficients() noexcept {
+    std::array<double, phaseTapCount> taps;
+    double sum = 0.0;
+    for (size_t index = 0; index < phaseTapCount; ++index) {
+      auto tap = 2 * index;
+      auto offset = double(tap) - double(delay);
+      auto ideal = std::sin(std::numbers::pi * offset / 2.0) / (std::numbers::pi * offset);
+      auto position = 2.0 * double(tap) / double(tapCount - 1) - 1.0;
+      auto window = besselI0(kaiserBeta * std::sqrt(1.0 - position * position)) / besselI0(kaiserBeta);
+      taps[index] = ideal * window;
+      sum += taps[index];
+    }
+
+    // Scale so that together with the 1/2 center tap the filter has unity gain at DC.
+    std::array<AUValue, phaseTapCount> coefficients;
+    for (size_t index = 0; index < phaseTapCount; ++index) coefficients[index] = AUValue(taps[index] * 0.5 / sum);
+    return coefficients;
+  }
+
+  std::array<AUValue, phaseTapCount> coefficients_;
+  std::vector<std::pair<std::vector<AUValue>, std::vector<AUValue>>> channels_{};
+};
+
+/**
+ Raises the sample rate of a bus by a factor of 2, 4, or 8 and then lowers it back again, using a cascade of
+ `HalfBandFilter` stages in each direction. `EventProcessor` uses this to run a kernel's `doRendering` at the higher
+ rate (see `EventProcessor::setOversampling`), which keeps harmonics created by non-linear processing from aliasing.
+
+ The filters delay the signal -- see `latency`. All buffers are allocated by `allocate`, so nothing is allocated while
+ rendering. The `upsample`, `silence`, `output`, and `downsample` methods must only be called when `factor` is greater
+ than 1.
+ */
+class Oversampler {
+public:
+
+  /// The largest supported oversampling factor
+  static constexpr size_t maxFactor = 8;
+
+  Oversampler() noexcept = default;
+
+  Oversampler(const Oversampler&) = delete;
+  Oversampler& operator=(const Oversampler&) = delete;
+
+  /**
+   Allocate the buffers and filters for oversampling. Must be called before rendering starts since it allocates memory.
+
+   @param factor the oversampling factor. It is rounded down to a power of 2 and limited to `maxFactor`. A value of 1
+   disables oversampling.
+   @param channelCount the number of channels to support
+   @param maxFrameCount the max number of frames at the original sample rate to process in one call
+   */
+  void allocate(size_t factor, AUAudioChannelCount channelCount, AUAudioFrameCount maxFrameCount) {
+    stageCount_ = 0;
+    while (stageCount_ < maxStageCount && (size_t(2) << stageCount_) <= factor) ++stageCount_;
+
+    inputPointers_.assign(channelCount, nullptr);
+    outputPointers_.assign(channelCount, nullptr);
+    for (size_t stage = 0; stage < maxStageCount; ++stage) {
+      auto active = stage < stageCount_;
+      auto stageChannels = active ? channelCount : 0;
+      auto stageFrames = active ? (maxFrameCount << stage) : 0;
+      if (stage == 0) {
+        firstUp_.allocate(stageChannels, stageFrames);
+        firstDown_.allocate(stageChannels, stageFrames);
+      } else {
+        laterUp_[stage - 1].allocate(stageChannels, stageFrames);
+        laterDown_[stage - 1].allocate(stageChannels, stageFrames);
+      }
+      levels_[stage].assign(stageChannels, std::vector<AUValue>(stageFrames * 2));
+    }
+
+    output_.assign(stageCount_ > 0 ? channelCount : 0, std::vector<AUValue>(maxFrameCount << stageCount_));
+  }
+
+  /// @returns the oversampling factor in effect
+  size_t factor() const noexcept { return size_t(1) << stageCount_; }
+
+  /// @returns the delay added by the filters, in frames at the original sample rate.
+  double latency() const noexcept {
+    double frames = 0.0;
+    for (size_t stage = 0; stage < stageCount_; ++stage) {
+      auto delay = stage == 0 ? FirstStage::delay : LaterStage::delay;
+      frames += double(delay) / double(size_t(1) << stage);
+    }
+    return frames;
+  }
+
+  /**
+   Forget all past samples.
+   */
+  void reset() noexcept {
+    firstUp_.reset();
+    firstDown_.reset();
+    for (auto& filter : laterUp_) filter.reset();
+    for (auto& filter : laterDown_) filter.reset();
+  }
+
+  /**
+   Raise the sample rate of the given samples.
+
+   @param input the samples to process
+   @param frameCount the number of frames in `input`
+   @returns the buffers holding `frameCount * factor()` frames at the higher rate
+   */
+  BusBuffers upsample(BusBuffers input, AUAudioFrameCount frameCount) noexcept {
+    assert(stageCount_ > 0);
+    auto channelCount = std::min(input.size(), inputPointers_.size());
+    for (size_t channel = 0; channel < channelCount; ++channel) {
+      const AUValue* source = input[channel];
+      auto frames = frameCount;
+      for (size_t stage = 0; stage < stageCount_; ++stage) {
+        auto destination = levels_[stage][channel].data();
+        if (stage == 0) {
+          firstUp_.upsample(channel, source, destination, frames);
+        } else {
+          laterUp_[stage - 1].upsample(channel, source, destination, frames);
+        }
+        source = destination;
+        frames *= 2;
+      }
+    }
+    return inputBuffers();
+  }
+
+  /**
+   Obtain silent samples at the higher rate, for when there is no input to upsample.
+
+   @param frameCount the number of frames at the original sample rate
+   @returns the buffers holding `frameCount * factor()` zeros
+   */
+  BusBuffers silence(AUAudioFrameCount frameCount) noexcept {
+    assert(stageCount_ > 0);
+    for (auto& samples : levels_[stageCount_ - 1]) std::fill_n(samples.begin(), frameCount * factor(), 0.0f);
+    return inputBuffers();
+  }
+
+  /// @returns the buffers to hold the samples rendered at the higher rate
+  BusBuffers output() noexcept {
+    for (size_t channel = 0; channel < output_.size(); ++channel) outputPointers_[channel] = output_[channel].data();
+    return BusBuffers(outputPointers_);
+  }
+
+  /**
+   Lower the sample rate of the samples held in the `output` buffers and store them in the given buffers.
+
+   @param destination the buffers to write to
+   @param frameCount the number of frames to write at the original sample rate
+   */
+  void downsample(BusBuffers destination, AUAudioFrameCount frameCount) noexcept {
+    assert(stageCount_ > 0);
+    auto channelCount = std::min(destination.size(), output_.size());
+    for (size_t channel = 0; channel < channelCount; ++channel) {
+      const AUValue* source = output_[channel].data();
+      auto frames = frameCount << (stageCount_ - 1);
+      for (size_t stage = stageCount_; stage-- > 0;) {
+        auto target = stage == 0 ? destination[channel] : levels_[stage - 1][channel].data();
+        if (stage == 0) {
+          firstDown_.downsample(channel, source, target, frames);
+        } else {
+          laterDown_[stage - 1].downsample(channel, source, target, frames);
+        }
+        source = target;
+        frames /= 2;
+      }
+    }
+  }
+
+private:
+  using FirstStage = HalfBandFilter<12>;
+  using LaterStage = HalfBandFilter<4>;
+
+  static constexpr size_t maxStageCount = 3;
+
+  BusBuffers inputBuffers() noexcept {
+    for (size_t channel = 0; channel < inputPointers_.size(); ++channel) {
+      inputPointers_[channel] = levels_[stageCount_ - 1][channel].data();
+    }
+    return BusBuffers(inputPointers_);
+  }
+
+  size_t stageCount_{0};
+  FirstStage firstUp_{};
+  FirstStage firstDown_{};
+  std::array<LaterStage, maxStageCount - 1> laterUp_{};
+  std::array<LaterStage, maxStageCount - 1> laterDown_{};
+  std::array<std::vector<std::vector<AUValue>>, maxStageCount> levels_{};
+  std::vector<std::vector<AUValue>> output_{};
+  std::vector<AUValue*> inputPointers_{};
+  std::vector<AUValue*> outputPointers_{};
+};
+
+} // end namespace DSPHeaders
@@ -5,9 +5,11 @@
 #import <algorithm>
 #import <atomic>
 #import <cassert>
+#import <span>
 
-#import <AVFoundation/AVFoundation.h>
+#import "DSPHeaders/AudioTypes.hpp"
 #import "DSPHeaders/Concepts.hpp"
+#import "DSPHeaders/Parameters/DirtySet.hpp"
 #import "DSPHeaders/Parameters/Transformer.hpp"
 #import "DSPHeaders/Types.hpp"
 
@@ -55,6 +57,7 @@ public:
     pendingValue_.store(transformIn_(value), std::memory_order_relaxed);
     // Stop any active ramping to allow a new ramp to begin.
     rampRemaining_ = 0;
+    markDirty();
   }
 
   /**
@@ -75,6 +78,7 @@ public:
     value = transformIn_(value);
     pendingValue_.store(value, std::memory_order_relaxed);
     startRamp(value, duration);
+    markDirty();
   }
 
   /**
@@ -85,11 +89,13 @@ public:
   AUValue getImmediate() const noexcept { return transformOut_(pendingValue_.load(std::memory_order_relaxed)); }
 
   /**
-   Check if there is a new value to ramp to that was set via `setPending`.
+   Check if there is a new value to ramp to that was set via `setPending`. Each call moves a ramp `steps` frames
+   closer to its end.
 
    @param duration the number of frames to transition over
+   @param steps the number of ramp frames that one call covers
    */
-  bool checkForValueChange(AUAudioFrameCount duration) noexcept {
+  bool checkForValueChange(AUAudioFrameCount duration, AUAudioFrameCount steps = 1) noexcept {
     auto pending = pendingValue_.load(std::memory_order_relaxed);
 
     // Nothing changed.
@@ -99,11 +105,14 @@ public:
 
     // Ramping already in-progress
     if (rampRemaining_ > 0) [[unlikely]] {
-      value_ = --rampRemaining_ > 0 ? (value_ + rampDelta_) : pending;
+      // Ramp is being advanced per frame by `fillFrameValues`
+      if (rampingPerFrame_) return false;
+      advanceRamp(pending, steps);
       return false;
     }
 
     startRamp(pending, duration);
+    if (steps > 1 && rampRemaining_ > 0) advanceRamp(pending, steps - 1);
     return rampRemaining_ > 0;
   }
 
@@ -114,6 +123,49 @@ public:
    */
   AUValue frameValue() const noexcept { return value_; }
 
+  /**
+   Obtain the per-frame values of the parameter for the next `values.size()` frames, advancing any active ramp by
+   that many frames. Unlike `checkForValueChange`, which moves a ramp one step per render pass, this treats the ramp
+   duration as a count of frames, so a kernel that uses this will follow an `AURenderEventParameterRamp` with sample
+   accuracy. Once a ramp is advanced this way, `checkForValueChange` leaves it alone until a new ramp begins.
+
+   Nothing is written when the value is constant -- the common case -- so a kernel can use `frameValue()` in
+   that case:
+
+   ```
+   if (gain_.fillFrameValues(gains)) {
+     for (size_t frame = 0; frame < gains.size(); ++frame) out[frame] = in[frame] * gains[frame];
+   } else {
+     auto gain = gain_.frameValue();
+     for (size_t frame = 0; frame < gains.size(); ++frame) out[frame] = in[frame] * gain;
+   }
+   ```
+
+   @param values the span to fill, one value per frame
+   @returns true if `values` was filled because the parameter is ramping, false if the value is constant
+   */
+  bool fillFrameValues(std::span<AUValue> values) noexcept {
+    if (rampRemaining_ == 0) [[likely]] {
+      return false;
+    }
+
+    rampingPerFrame_ = true;
+    auto frameCount = values.size();
+    auto rampFrames = std::min(frameCount, size_t(rampRemaining_));
+    auto start = value_;
+    auto delta = rampDelta_;
+    for (size_t frame = 0; frame < rampFrames; ++frame) {
+      values[frame] = start + delta * AUValue(frame);
+    }
+
+    auto pending = pendingValue_.load(std::memory_order_relaxed);
+    std::fill(values.begin() + rampFrames, values.end(), pending);
+
+    rampRemaining_ -= AUAudioFrameCount(rampFrames);
+    value_ = rampRemaining_ > 0 ? start + delta * AUValue(rampFrames) : pending;
+    return true;
+  }
+
 protected:
 
   /**
@@ -133,6 +185,23 @@ protected:
   }
 
 private:
+  friend class Registry;
+
+  /**
+   Record changes to the pending value in a `DirtySet`. Done by `Registry` when the parameter is registered.
+
+   @param dirtySet the set to update when the pending value changes
+   @param index the index of the flag to set
+   */
+  void trackChanges(DirtySet* dirtySet, size_t index) noexcept {
+    dirtySet_ = dirtySet;
+    dirtyIndex_ = index;
+    markDirty();
+  }
+
+  void markDirty() noexcept {
+    if (dirtySet_ != nullptr) dirtySet_->mark(dirtyIndex_);
+  }
 
   void startRamp(AUValue pendingValue, AUAudioFrameCount duration) noexcept {
     if (canRamp_ && duration > 1) {
@@ -142,9 +211,16 @@ private:
       rampDelta_ = pendingValue - value_;
     }
     rampRemaining_ = duration - 1;
+    rampingPerFrame_ = false;
     value_ += rampDelta_;
   }
 
+  void advanceRamp(AUValue pendingValue, AUAudioFrameCount steps) noexcept {
+    steps = std::min(steps, rampRemaining_);
+    rampRemaining_ -= steps;
+    value_ = rampRemaining_ > 0 ? (value_ + rampDelta_ * AUValue(steps)) : pendingValue;
+  }
+
   /// The address of the parameter.
   AUParameterAddress address_;
 
@@ -171,6 +247,15 @@ private:
 
   /// Holds `true` if the parameter supports ramping. Boolean values do not, for instance.
   bool canRamp_;
+
+  /// Holds `true` if the active ramp is being advanced by `fillFrameValues` instead of `checkForValueChange`.
+  bool rampingPerFrame_{false};
+
+  /// The set to update when the pending value changes. Only valid if the parameter has been registered.
+  DirtySet* dirtySet_{nullptr};
+
+  /// The index of the flag for this parameter in `dirtySet_`.
+  size_t dirtyIndex_{0};
 };
 
 } // end namespace DSPHeaders::Parameters
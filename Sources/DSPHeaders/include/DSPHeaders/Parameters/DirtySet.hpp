@@ -0,0 +1,75 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <atomic>
+#import <cstdint>
+#import <memory>
+
+namespace DSPHeaders::Parameters {
+
+/**
+ Lock-free set of flags, one per registered parameter, that records which parameters have had a new value posted to
+ them. Any thread may mark an entry, but only the render thread may take the flags out of the set. The flags are
+ packed 64 to a word so that the render thread can skip over 64 unchanged parameters with one atomic load.
+
+ Storage is only allocated in `resize`, which must be done before rendering starts.
+ */
+class DirtySet {
+public:
+  using Word = uint64_t;
+
+  static constexpr size_t bitsPerWord = 64;
+
+  DirtySet() = default;
+
+  DirtySet(const DirtySet&) = delete;
+  DirtySet& operator=(const DirtySet&) = delete;
+
+  /**
+   Make sure that there is room for the given number of flags. Existing flags are preserved.
+
+   @param count the number of flags to hold
+   */
+  void resize(size_t count) {
+    auto wordCount = (count + bitsPerWord - 1) / bitsPerWord;
+    if (wordCount <= wordCount_) return;
+    auto words = std::make_unique<std::atomic<Word>[]>(wordCount);
+    for (size_t index = 0; index < wordCount; ++index) {
+      words[index].store(index < wordCount_ ? words_[index].load(std::memory_order_relaxed) : 0,
+                         std::memory_order_relaxed);
+    }
+    words_ = std::move(words);
+    wordCount_ = wordCount;
+  }
+
+  /// @returns the number of words holding the flags
+  size_t wordCount() const noexcept { return wordCount_; }
+
+  /**
+   Flag an entry as changed. Safe to call from any thread.
+
+   @param index the index of the entry to mark
+   */
+  void mark(size_t index) noexcept {
+    words_[index / bitsPerWord].fetch_or(Word{1} << (index % bitsPerWord), std::memory_order_release);
+  }
+
+  /**
+   Obtain and clear the flags held in a word. Only the render thread should do this.
+
+   @param word the index of the word to take
+   @returns the flags that were set
+   */
+  Word take(size_t word) noexcept {
+    // Most of the time nothing has changed, so avoid the read-modify-write in that case.
+    if (words_[word].load(std::memory_order_relaxed) == 0) [[likely]] return 0;
+    return words_[word].exchange(0, std::memory_order_acquire);
+  }
+
+private:
+  std::unique_ptr<std::atomic<Word>[]> words_{};
+  size_t wordCount_{0};
+};
+
+} // end namespace DSPHeaders::Parameters
@@ -3,7 +3,7 @@
 #pragma once
 
 #import <cmath>
-#import <AVFoundation/AVFoundation.h>
+#import "DSPHeaders/AudioTypes.hpp"
 
 #import "DSPHeaders/Parameters/Base.hpp"
 
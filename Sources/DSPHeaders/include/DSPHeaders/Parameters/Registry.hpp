@@ -0,0 +1,127 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <algorithm>
+#import <bit>
+#import <vector>
+
+#import "DSPHeaders/AudioTypes.hpp"
+#import "DSPHeaders/Parameters/Base.hpp"
+#import "DSPHeaders/Parameters/DirtySet.hpp"
+
+namespace DSPHeaders::Parameters {
+
+/**
+ Collection of the parameters registered by a kernel. Kernels normally use small, contiguous parameter addresses
+ (often the values of an enumeration), so lookups are done by indexing directly into a table of parameter pointers
+ using the address. Addresses that are too large for the table are kept in a sorted vector that is searched using a
+ binary search. The parameters themselves are also held in registration order in a contiguous vector so that visiting
+ all of them is a simple linear walk.
+
+ Registered parameters flag themselves in a `DirtySet` when a new value is posted to them. This allows
+ `checkForValueChanges` to only visit those parameters that have changed or that are still ramping to a new value
+ instead of all of them.
+
+ All storage is allocated while registering parameters, which should happen when the kernel is constructed. Lookups
+ and iteration do not allocate and are safe to do in the render thread.
+ */
+class Registry {
+public:
+
+  /// Addresses below this value are looked up by direct indexing.
+  static constexpr AUParameterAddress maxDirectAddress = 1024;
+
+  using const_iterator = std::vector<Base*>::const_iterator;
+
+  Registry() = default;
+
+  // Registered parameters hold a pointer to `dirty_` so a registry must stay put.
+  Registry(const Registry&) = delete;
+  Registry& operator=(const Registry&) = delete;
+
+  /**
+   Add a parameter to the registry.
+
+   @param parameter the parameter to add
+   @returns false if there is already a parameter registered with the same address
+   */
+  bool add(Base& parameter) {
+    auto address = parameter.address();
+    if (find(address) != nullptr) return false;
+    if (address < maxDirectAddress) {
+      if (address >= direct_.size()) direct_.resize(size_t(address) + 1, nullptr);
+      direct_[size_t(address)] = &parameter;
+    } else {
+      sparse_.insert(std::upper_bound(sparse_.begin(), sparse_.end(), address, [](auto lhs, auto rhs) {
+        return lhs < rhs->address();
+      }), &parameter);
+    }
+    auto index = all_.size();
+    all_.push_back(&parameter);
+    dirty_.resize(all_.size());
+    ramping_.resize(dirty_.wordCount(), 0);
+    parameter.trackChanges(&dirty_, index);
+    return true;
+  }
+
+  /**
+   Locate the parameter registered with the given address.
+
+   @param address the address to look for
+   @returns pointer to the parameter or nullptr if not found
+   */
+  Base* find(AUParameterAddress address) const noexcept {
+    if (address < direct_.size()) [[likely]] return direct_[size_t(address)];
+    auto pos = std::lower_bound(sparse_.begin(), sparse_.end(), address, [](auto lhs, auto rhs) {
+      return lhs->address() < rhs;
+    });
+    return pos != sparse_.end() && (*pos)->address() == address ? *pos : nullptr;
+  }
+
+  /**
+   Visit the parameters that have a new value posted to them or that are still ramping, and let them update their
+   rendering value. This must only be called from the render thread, or when rendering is not taking place.
+
+   @param duration the number of frames to ramp over when there is a new value
+   @param steps the number of ramp frames that one call covers
+   @returns true if any parameter started ramping to a new value
+   */
+  bool checkForValueChanges(AUAudioFrameCount duration, AUAudioFrameCount steps = 1) noexcept {
+    bool changed = false;
+    for (size_t word = 0; word < ramping_.size(); ++word) {
+      auto pending = dirty_.take(word) | ramping_[word];
+      DirtySet::Word ramping = 0;
+      while (pending != 0) {
+        auto bit = size_t(std::countr_zero(pending));
+        pending &= pending - 1;
+        auto param = all_[word * DirtySet::bitsPerWord + bit];
+        changed |= param->checkForValueChange(duration, steps);
+        if (param->isRamping()) ramping |= DirtySet::Word{1} << bit;
+      }
+      ramping_[word] = ramping;
+    }
+    return changed;
+  }
+
+  /// @returns number of registered parameters
+  size_t size() const noexcept { return all_.size(); }
+
+  /// @returns true if no parameters are registered
+  bool empty() const noexcept { return all_.empty(); }
+
+  /// @returns iterator to the first registered parameter
+  const_iterator begin() const noexcept { return all_.begin(); }
+
+  /// @returns iterator past the last registered parameter
+  const_iterator end() const noexcept { return all_.end(); }
+
+private:
+  std::vector<Base*> direct_{};
+  std::vector<Base*> sparse_{};
+  std::vector<Base*> all_{};
+  DirtySet dirty_{};
+  std::vector<DirtySet::Word> ramping_{};
+};
+
+} // end namespace DSPHeaders::Parameters
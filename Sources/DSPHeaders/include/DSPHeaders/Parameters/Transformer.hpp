@@ -4,8 +4,9 @@
 
 #import <algorithm>
 #import <atomic>
+#import <cmath>
 
-#import <AVFoundation/AVFoundation.h>
+#import "DSPHeaders/AudioTypes.hpp"
 
 namespace DSPHeaders::Parameters {
 
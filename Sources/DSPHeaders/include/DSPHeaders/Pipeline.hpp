@@ -0,0 +1,340 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <array>
+#import <concepts>
+#import <functional>
+#import <optional>
+#import <type_traits>
+#import <utility>
+
+#import "DSPHeaders/AudioTypes.hpp"
+#import "DSPHeaders/BusBuffers.hpp"
+
+/**
+ Lazy expression templates that fuse per-sample processing steps into one loop. Kernels often chain several passes
+ over a block of samples -- generate LFO values, read from a delay line, mix with the input, apply a gain -- and each
+ pass writes out and then reloads the whole block. With a pipeline the steps are composed into a single expression
+ that `render` evaluates once per frame, so every sample is loaded once and stored once and nothing else is written
+ to memory. For example, a simple stereo flanger:
+
+ ```
+ using namespace DSPHeaders::Pipeline;
+ render(outs, frameCount, lfo(lfo_) * depth + offset, [&](size_t channel, auto delay) {
+   auto wet = delayLine(delays_[channel], delay, input(ins[channel]), feedback);
+   return mix(input(ins[channel]), wet, wetLevel) * gain;
+ });
+ ```
+
+ Each node produces one value per frame from its `next` method, and operands are always evaluated from left to right.
+ Nodes that refer to objects with state -- `LFO`, `DelayBuffer` and biquad filters -- hold a reference to them and
+ update them as they go. Objects used in the pipeline of a channel must therefore be unique to it. Values that all of
+ the channels use, such as the output of an LFO, come from a separate pipeline that is evaluated once per frame and
+ then given to the channel pipelines as a `Shared` node.
+ */
+namespace DSPHeaders::Pipeline {
+
+/// Base class of all pipeline nodes, used to enable the operators below.
+struct Node {};
+
+/// Concept for a pipeline node.
+template <typename T>
+concept IsNode = std::derived_from<std::remove_cvref_t<T>, Node> && requires(std::remove_cvref_t<T>& node) {
+  { node.next() } -> std::convertible_to<AUValue>;
+};
+
+/// Concept for something that can be an operand of a pipeline operator.
+template <typename T>
+concept IsOperand = IsNode<T> || std::is_arithmetic_v<std::remove_cvref_t<T>>;
+
+/**
+ Node that emits samples from a buffer, one after the other.
+ */
+struct Samples : Node {
+  explicit Samples(const AUValue* samples) noexcept : samples_{samples} {}
+  AUValue next() noexcept { return *samples_++; }
+private:
+  const AUValue* samples_;
+};
+
+/**
+ Node that always emits the same value.
+ */
+struct Constant : Node {
+  explicit Constant(AUValue value) noexcept : value_{value} {}
+  AUValue next() const noexcept { return value_; }
+private:
+  AUValue value_;
+};
+
+/**
+ Node that emits values that change linearly, starting with `start` and changing by `step` for each frame.
+ */
+struct Ramp : Node {
+  Ramp(AUValue start, AUValue step) noexcept : start_{start}, step_{step} {}
+  AUValue next() noexcept { return start_ + step_ * AUValue(index_++); }
+private:
+  AUValue start_;
+  AUValue step_;
+  size_t index_{0};
+};
+
+/**
+ Node that emits the value of the current frame from the shared pipeline given to `render`.
+ */
+struct Shared : Node {
+  explicit Shared(const AUValue& value) noexcept : value_{value} {}
+  AUValue next() const noexcept { return value_; }
+private:
+  const AUValue& value_;
+};
+
+/**
+ Node that emits the values of an oscillator such as `LFO`, advancing it after each one.
+ */
+template <typename OscillatorType>
+struct Oscillator : Node {
+  explicit Oscillator(OscillatorType& oscillator) noexcept : oscillator_{oscillator} {}
+  AUValue next() noexcept {
+    auto value = AUValue(oscillator_.value());
+    oscillator_.increment();
+    return value;
+  }
+private:
+  OscillatorType& oscillator_;
+};
+
+/**
+ Node that applies a function to the values of another node.
+ */
+template <typename Operand, typename Function>
+struct Map : Node {
+  Map(Operand operand, Function function) noexcept : operand_{std::move(operand)}, function_{std::move(function)} {}
+  AUValue next() noexcept { return AUValue(function_(operand_.next())); }
+private:
+  Operand operand_;
+  Function function_;
+};
+
+/**
+ Node that combines the values of two other nodes.
+ */
+template <typename Lhs, typename Rhs, typename Function>
+struct Binary : Node {
+  Binary(Lhs lhs, Rhs rhs) noexcept : lhs_{std::move(lhs)}, rhs_{std::move(rhs)} {}
+  AUValue next() noexcept {
+    auto lhs = lhs_.next();
+    return Function{}(lhs, rhs_.next());
+  }
+private:
+  Lhs lhs_;
+  Rhs rhs_;
+};
+
+/**
+ Node that sends the values of another node through a filter with a `transform` method, such as `Biquad::Filter`.
+ */
+template <typename FilterType, typename Operand>
+struct Filtered : Node {
+  Filtered(FilterType& filter, Operand operand) noexcept : filter_{filter}, operand_{std::move(operand)} {}
+  AUValue next() noexcept { return AUValue(filter_.transform(operand_.next())); }
+private:
+  FilterType& filter_;
+  Operand operand_;
+};
+
+/**
+ Node that reads from a `DelayBuffer` at a delay given by one node, and then writes the value of another node to it
+ along with some of the value that was read.
+ */
+template <typename DelayType, typename Delay, typename Operand>
+struct DelayLine : Node {
+  DelayLine(DelayType& buffer, Delay delay, Operand operand, AUValue feedback) noexcept
+  : buffer_{buffer}, delay_{std::move(delay)}, operand_{std::move(operand)}, feedback_{feedback} {}
+  AUValue next() noexcept {
+    auto delayed = AUValue(buffer_.read(delay_.next()));
+    buffer_.write(operand_.next() + feedback_ * delayed);
+    return delayed;
+  }
+private:
+  DelayType& buffer_;
+  Delay delay_;
+  Operand operand_;
+  AUValue feedback_;
+};
+
+/// @returns the node for an operand, turning numbers into `Constant` nodes
+template <IsOperand T>
+auto asNode(T&& value) noexcept {
+  if constexpr (IsNode<T>) {
+    return std::remove_cvref_t<T>(std::forward<T>(value));
+  } else {
+    return Constant(AUValue(value));
+  }
+}
+
+/// Type of the node for an operand
+template <typename T>
+using NodeType = decltype(asNode(std::declval<T>()));
+
+/**
+ Obtain a node that emits samples from a buffer.
+
+ @param samples pointer to the first sample
+ @returns new node
+ */
+inline Samples input(const AUValue* samples) noexcept { return Samples(samples); }
+
+/**
+ Obtain a node that emits values that change linearly from `start` towards `end`, reaching it at frame `frameCount`.
+
+ @param start the first value
+ @param end the value to reach
+ @param frameCount the number of frames to take to reach `end`
+ @returns new node
+ */
+inline Ramp ramp(AUValue start, AUValue end, AUAudioFrameCount frameCount) noexcept {
+  return Ramp(start, frameCount > 0 ? (end - start) / AUValue(frameCount) : AUValue(0.0));
+}
+
+/**
+ Obtain a node that emits the values of an oscillator.
+
+ @param oscillator the oscillator to use. It must outlive the node.
+ @returns new node
+ */
+template <typename OscillatorType>
+auto lfo(OscillatorType& oscillator) noexcept { return Oscillator<OscillatorType>(oscillator); }
+
+/**
+ Obtain a node that applies a function to the values of another node.
+
+ @param operand the node that provides the values
+ @param function the function to apply
+ @returns new node
+ */
+template <IsOperand Operand, typename Function>
+auto map(Operand&& operand, Function function) noexcept {
+  return Map<NodeType<Operand>, Function>(asNode(std::forward<Operand>(operand)), std::move(function));
+}
+
+/**
+ Obtain a node that filters the values of another node.
+
+ @param filter the filter to use. It must outlive the node.
+ @param operand the node that provides the values
+ @returns new node
+ */
+template <typename FilterType, IsOperand Operand>
+auto filter(FilterType& filter, Operand&& operand) noexcept {
+  return Filtered<FilterType, NodeType<Operand>>(filter, asNode(std::forward<Operand>(operand)));
+}
+
+/**
+ Obtain a node that reads delayed samples from a `DelayBuffer` and then writes new ones to it.
+
+ @param buffer the delay buffer to use. It must outlive the node.
+ @param delay the node that provides the delay in samples for each read
+ @param operand the node that provides the samples to write
+ @param feedback the amount of the delayed sample to add to each sample that is written
+ @returns new node that emits the delayed samples
+ */
+template <typename DelayType, IsOperand Delay, IsOperand Operand>
+auto delayLine(DelayType& buffer, Delay&& delay, Operand&& operand, AUValue feedback = 0.0) noexcept {
+  return DelayLine<DelayType, NodeType<Delay>, NodeType<Operand>>(buffer, asNode(std::forward<Delay>(delay)),
+                                                                  asNode(std::forward<Operand>(operand)), feedback);
+}
+
+template <IsOperand Lhs, IsOperand Rhs> requires (IsNode<Lhs> || IsNode<Rhs>)
+auto operator+(Lhs&& lhs, Rhs&& rhs) noexcept {
+  return Binary<NodeType<Lhs>, NodeType<Rhs>, std::plus<AUValue>>(asNode(std::forward<Lhs>(lhs)),
+                                                                  asNode(std::forward<Rhs>(rhs)));
+}
+
+template <IsOperand Lhs, IsOperand Rhs> requires (IsNode<Lhs> || IsNode<Rhs>)
+auto operator-(Lhs&& lhs, Rhs&& rhs) noexcept {
+  return Binary<NodeType<Lhs>, NodeType<Rhs>, std::minus<AUValue>>(asNode(std::forward<Lhs>(lhs)),
+                                                                   asNode(std::forward<Rhs>(rhs)));
+}
+
+template <IsOperand Lhs, IsOperand Rhs> requires (IsNode<Lhs> || IsNode<Rhs>)
+auto operator*(Lhs&& lhs, Rhs&& rhs) noexcept {
+  return Binary<NodeType<Lhs>, NodeType<Rhs>, std::multiplies<AUValue>>(asNode(std::forward<Lhs>(lhs)),
+                                                                        asNode(std::forward<Rhs>(rhs)));
+}
+
+/**
+ Obtain a node that cross-fades between two others: `dry * (1 - wetLevel) + wet * wetLevel`.
+
+ @param dry the node that provides the unprocessed samples
+ @param wet the node that provides the processed samples
+ @param wetLevel the amount of `wet` in the result, from 0 to 1
+ @returns new node
+ */
+template <IsOperand Dry, IsOperand Wet>
+auto mix(Dry&& dry, Wet&& wet, AUValue wetLevel) noexcept {
+  return asNode(std::forward<Dry>(dry)) * (1.0f - wetLevel) + asNode(std::forward<Wet>(wet)) * wetLevel;
+}
+
+/**
+ Evaluate a pipeline, storing its values. The destination may be the same buffer as one given to `input`.
+
+ @param destination where to store the values
+ @param frameCount the number of values to store
+ @param node the pipeline to evaluate
+ */
+template <IsNode NodeT>
+void render(AUValue* destination, AUAudioFrameCount frameCount, NodeT&& node) noexcept {
+  auto pipeline = asNode(std::forward<NodeT>(node));
+  for (AUAudioFrameCount frame = 0; frame < frameCount; ++frame) {
+    destination[frame] = pipeline.next();
+  }
+}
+
+/**
+ Evaluate a pipeline for each channel of a bus. The channels are rendered one after the other.
+
+ @param destination the buffers to store the values in
+ @param frameCount the number of values to store in each channel
+ @param factory function that takes a channel index and returns the pipeline to evaluate for it
+ */
+template <typename Factory>
+void render(BusBuffers destination, AUAudioFrameCount frameCount, Factory&& factory) noexcept {
+  destination.withChannelCount([&](auto channelCount) {
+    for (size_t channel = 0; channel < channelCount; ++channel) {
+      render(destination[channel], frameCount, factory(channel));
+    }
+  });
+}
+
+/**
+ Evaluate a pipeline for each channel of a bus, with values shared by all channels coming from another pipeline. For
+ each frame the shared pipeline is evaluated once, and then the pipeline of each channel.
+
+ @param destination the buffers to store the values in
+ @param frameCount the number of values to store in each channel
+ @param shared the pipeline that provides the shared values
+ @param factory function that takes a channel index and a `Shared` node that emits the shared values, and returns the
+ pipeline to evaluate for the channel. The pipeline must have the same type for all channels.
+ */
+template <IsNode SharedNode, typename Factory>
+void render(BusBuffers destination, AUAudioFrameCount frameCount, SharedNode&& shared, Factory&& factory) noexcept {
+  auto source = asNode(std::forward<SharedNode>(shared));
+  AUValue value{0.0};
+  using Channel = NodeType<decltype(factory(size_t(0), Shared(value)))>;
+  std::array<std::optional<Channel>, BusBuffers::maxChannelCount> channels;
+  destination.withChannelCount([&](auto channelCount) {
+    for (size_t channel = 0; channel < channelCount; ++channel) {
+      channels[channel].emplace(factory(channel, Shared(value)));
+    }
+    for (AUAudioFrameCount frame = 0; frame < frameCount; ++frame) {
+      value = source.next();
+      for (size_t channel = 0; channel < channelCount; ++channel) {
+        destination[channel][frame] = channels[channel]->next();
+      }
+    }
+  });
+}
+
+} // end namespace DSPHeaders::Pipeline
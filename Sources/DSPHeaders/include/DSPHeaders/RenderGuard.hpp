@@ -0,0 +1,160 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <array>
+#import <atomic>
+#import <cstdint>
+#import <string>
+
+/// Controls if `EventProcessor` watches for memory allocations and lock use while rendering. Since this replaces the
+/// global `operator new` and `operator delete` of the whole program, it is off unless set to 1 at compile time, which
+/// must be done for both the DSPHeaders library and the code that includes this header. See `Package.swift`.
+#if !defined(DSPHEADERS_RENDER_GUARD_ENABLED)
+#define DSPHEADERS_RENDER_GUARD_ENABLED 0
+#endif
+
+/// Controls if the C library `malloc` family and `pthread_mutex_lock` are watched as well as `operator new`. This is
+/// only possible with glibc, and it is disabled when a sanitizer is active since they intercept the same functions.
+#if !defined(DSPHEADERS_RENDER_GUARD_C_HOOKS)
+#if defined(__has_feature)
+#if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer)
+#define DSPHEADERS_RENDER_GUARD_SANITIZED 1
+#endif
+#endif
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#define DSPHEADERS_RENDER_GUARD_SANITIZED 1
+#endif
+#if DSPHEADERS_RENDER_GUARD_ENABLED && defined(__GLIBC__) && !defined(DSPHEADERS_RENDER_GUARD_SANITIZED)
+#define DSPHEADERS_RENDER_GUARD_C_HOOKS 1
+#else
+#define DSPHEADERS_RENDER_GUARD_C_HOOKS 0
+#endif
+#endif
+
+namespace DSPHeaders {
+
+/**
+ Detector of memory allocations and lock use on a render thread. A thread is watched while a `RenderGuard::Scope`
+ exists on it -- `EventProcessor::processAndRender` creates one when `DSPHEADERS_RENDER_GUARD_ENABLED` is set. The
+ replacements of the global `operator new` and `operator delete` in `RenderGuard.mm` report to `check`, as do wrappers
+ of `malloc`, `calloc`, `realloc`, `free`, and `pthread_mutex_lock` when `DSPHEADERS_RENDER_GUARD_C_HOOKS` is set.
+
+ Each violation is counted, and the first `maxViolations` ones are kept along with the call stack that led to them in
+ storage that is set aside up front, so recording one does not itself allocate. Tests can then check `violationCount`
+ after rendering and use `describe` to show where the problem came from.
+ */
+class RenderGuard {
+public:
+
+  /// The kinds of things that are not allowed on a render thread
+  enum class Kind : uint8_t {
+    allocation,
+    deallocation,
+    lock
+  };
+
+  /// The number of violations for which details are kept
+  static constexpr size_t maxViolations = 16;
+
+  /// The max number of stack frames kept for a violation
+  static constexpr size_t maxStackFrames = 32;
+
+  /// True if lock use is detected
+  static constexpr bool detectsLocks = DSPHEADERS_RENDER_GUARD_C_HOOKS;
+
+  /**
+   Details of one violation.
+   */
+  struct Violation {
+    Kind kind{Kind::allocation};
+    /// The number of bytes requested for an allocation
+    size_t size{0};
+    /// The number of valid entries in `stack`
+    size_t stackDepth{0};
+    /// The return addresses of the call stack at the time of the violation
+    std::array<void*, maxStackFrames> stack{};
+  };
+
+  /**
+   Watches the current thread for as long as it exists. Scopes can be nested.
+   */
+  class Scope {
+  public:
+    Scope() noexcept { ++depth_; }
+    ~Scope() noexcept { --depth_; }
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+  };
+
+  /**
+   Stops watching the current thread for as long as it exists. This is for code that runs inside a `Scope` but which
+   is not under the control of the kernel, such as the upstream rendering done by a `pullInputBlock`.
+   */
+  class Suspend {
+  public:
+    Suspend() noexcept { ++suspended_; }
+    ~Suspend() noexcept { --suspended_; }
+    Suspend(const Suspend&) = delete;
+    Suspend& operator=(const Suspend&) = delete;
+  };
+
+  /**
+   Make sure that recording a violation will not allocate memory. Capturing a call stack loads support code the first
+   time it is done, so this does that outside of a render thread. `EventProcessor::setRenderingFormat` calls this.
+   */
+  static void prepare() noexcept;
+
+  /// @returns true if the current thread is being watched
+  static bool isWatching() noexcept { return depth_ > 0 && suspended_ == 0; }
+
+  /**
+   Record a violation if the current thread is being watched. Called by the interceptors.
+
+   @param kind the kind of violation
+   @param size the number of bytes requested for an allocation
+   */
+  static void check(Kind kind, size_t size = 0) noexcept {
+    if (isWatching()) [[unlikely]] record(kind, size);
+  }
+
+  /// @returns the number of violations seen since the last `reset`
+  static size_t violationCount() noexcept { return count_.load(std::memory_order_acquire); }
+
+  /**
+   Obtain the details of a violation.
+
+   @param index the index of the violation to get. Must be less than `maxViolations` and `violationCount`.
+   @returns the violation details
+   */
+  static const Violation& violation(size_t index) noexcept { return violations_[index]; }
+
+  /**
+   Obtain a description of a violation with the symbols of its call stack. This allocates memory, so it must not be
+   called from a render thread.
+
+   @param index the index of the violation to describe
+   @returns the description
+   */
+  static std::string describe(size_t index);
+
+  /**
+   Forget the recorded violations. Must not be called while a render thread could be recording one.
+   */
+  static void reset() noexcept { count_.store(0, std::memory_order_release); }
+
+private:
+  static void record(Kind kind, size_t size) noexcept;
+
+  static thread_local int depth_;
+  static thread_local int suspended_;
+  static std::atomic<size_t> count_;
+  static std::array<Violation, maxViolations> violations_;
+};
+
+inline thread_local int RenderGuard::depth_{0};
+inline thread_local int RenderGuard::suspended_{0};
+inline std::atomic<size_t> RenderGuard::count_{0};
+inline std::array<RenderGuard::Violation, RenderGuard::maxViolations> RenderGuard::violations_{};
+
+} // end namespace DSPHeaders
@@ -0,0 +1,280 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <algorithm>
+#import <atomic>
+#import <bit>
+#import <chrono>
+#import <condition_variable>
+#import <cstddef>
+#import <cstdio>
+#import <cstring>
+#import <memory>
+#import <mutex>
+#import <thread>
+#import <tuple>
+#import <type_traits>
+#import <vector>
+
+#import "DSPHeaders/AudioTypes.hpp"
+
+/// Controls if `DSPHEADERS_RENDER_LOG` records anything. By default, logging is only enabled in debug builds.
+#if !defined(DSPHEADERS_RENDER_LOG_ENABLED)
+#if defined(NDEBUG)
+#define DSPHEADERS_RENDER_LOG_ENABLED 0
+#else
+#define DSPHEADERS_RENDER_LOG_ENABLED 1
+#endif
+#endif
+
+/**
+ Post a log message to a `RenderLog` instance. The format string must be a string literal, and the arguments must be
+ trivially-copyable values such as numbers. In release builds (or whenever `DSPHEADERS_RENDER_LOG_ENABLED` is 0) this
+ expands to nothing, and the arguments are not evaluated.
+ */
+#if DSPHEADERS_RENDER_LOG_ENABLED
+#define DSPHEADERS_RENDER_LOG(log, format, ...) (log).post(format __VA_OPT__(,) __VA_ARGS__)
+#else
+#define DSPHEADERS_RENDER_LOG(log, format, ...) static_cast<void>(0)
+#endif
+
+namespace DSPHeaders {
+
+/**
+ Logging facility that is safe to use in a render thread. Posting a message does not format anything, make any system
+ calls, allocate memory, or take a lock -- it just copies a pointer to the format string and the raw argument values
+ into a preallocated ring of fixed-size records. Another thread drains the ring, formats the messages, and sends them
+ to `os_log`. If the ring is full, the message is dropped and counted.
+
+ The ring is a bounded multi-producer, single-consumer queue, so it is fine for both the render thread and a UI thread
+ to post messages to the same instance. It is not allocated until `allocate` is called, and messages posted before
+ then are dropped. One background thread drains all of the instances that have called `startDraining`.
+ */
+class RenderLog {
+public:
+
+  /// The space available in a record for argument values.
+  static constexpr size_t payloadSize = 40;
+
+  /// The amount of time the background thread waits between drain operations.
+  static constexpr std::chrono::milliseconds drainInterval{50};
+
+  /**
+   Construct new instance. No memory is allocated for the ring until `allocate` is called.
+
+   @param log the `os_log` to send formatted messages to
+   @param capacity the number of records to hold. This will be rounded up to a power of 2.
+   */
+  explicit RenderLog(os_log_t _Nonnull log, size_t capacity = 1024) noexcept :
+  log_{log}, capacity_{std::bit_ceil(std::max<size_t>(capacity, 2))}, mask_{capacity_ - 1} {}
+
+  RenderLog(const RenderLog&) = delete;
+  RenderLog& operator=(const RenderLog&) = delete;
+
+  ~RenderLog() noexcept { stopDraining(); }
+
+  /**
+   Allocate the ring. Does nothing if it already exists. Must not be called while another thread posts or drains.
+   */
+  void allocate() {
+    if (records_) return;
+    records_ = std::make_unique<Record[]>(capacity_);
+    for (size_t index = 0; index < capacity_; ++index) records_[index].sequence.store(index, std::memory_order_relaxed);
+  }
+
+  /// @returns true if the ring has been allocated
+  bool isAllocated() const noexcept { return records_ != nullptr; }
+
+  /**
+   Record a message for later formatting. Safe to call from the render thread.
+
+   @param format the `printf` format string to use. Must be a string literal.
+   @param args the values to format
+   @returns true if the message was recorded, false if it was dropped because the ring is full
+   */
+  template <typename... Args>
+  bool post(const char* _Nonnull format, Args... args) noexcept {
+    static_assert((std::is_trivially_copyable_v<Args> && ...), "RenderLog arguments must be trivially copyable");
+    static_assert((sizeof(Args) + ... + 0) <= payloadSize, "RenderLog arguments are too large");
+
+    if (!records_) [[unlikely]] {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+
+    auto pos = writeIndex_.load(std::memory_order_relaxed);
+    Record* record;
+    while (true) {
+      record = &records_[pos & mask_];
+      auto sequence = record->sequence.load(std::memory_order_acquire);
+      auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(pos);
+      if (diff == 0) {
+        if (writeIndex_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+      } else if (diff < 0) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        pos = writeIndex_.load(std::memory_order_relaxed);
+      }
+    }
+
+    record->format = format;
+    record->formatter = &formatRecord<Args...>;
+    auto payload = record->payload;
+    ((std::memcpy(payload, &args, sizeof(Args)), payload += sizeof(Args)), ...);
+    record->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   Format all pending messages and hand them to a sink. Only one thread should drain at a time.
+
+   @param sink callable that takes a `const char*` holding the formatted message
+   @returns number of messages drained
+   */
+  template <typename Sink>
+  size_t drain(Sink&& sink) {
+    size_t count = 0;
+    if (!records_) return count;
+    char buffer[256];
+    while (true) {
+      auto& record{records_[readIndex_ & mask_]};
+      if (record.sequence.load(std::memory_order_acquire) != readIndex_ + 1) break;
+      record.formatter(buffer, sizeof(buffer), record.format, record.payload);
+      record.sequence.store(readIndex_ + capacity_, std::memory_order_release);
+      ++readIndex_;
+      ++count;
+      sink(static_cast<const char*>(buffer));
+    }
+    return count;
+  }
+
+  /**
+   Format all pending messages and send them to `os_log`.
+
+   @returns number of messages drained
+   */
+  size_t drain() {
+    return drain([this](const char* message) {
+      os_log_info(log_, "%{public}s", message);
+      static_cast<void>(message);
+    });
+  }
+
+  /**
+   Have the background thread drain the ring every `drainInterval`. The thread is shared by all instances and is
+   started by the first call. Does nothing if this instance is already being drained.
+
+   @returns false if the background thread could not be started
+   */
+  bool startDraining() noexcept { return Drainer::shared().add(this); }
+
+  /**
+   Stop the background draining of this instance and format any remaining messages.
+   */
+  void stopDraining() noexcept {
+    if (Drainer::shared().remove(this)) drain();
+  }
+
+  /// @returns number of records the ring can hold
+  size_t capacity() const noexcept { return capacity_; }
+
+  /// @returns number of messages dropped because the ring was full
+  size_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+  using Formatter = void (*)(char* _Nonnull, size_t, const char* _Nonnull, const std::byte* _Nonnull);
+
+  /**
+   The background thread that drains all of the instances that want it. It sleeps while there are none.
+   */
+  class Drainer {
+  public:
+
+    /// @returns the one instance. It is never destroyed, so instances with static storage can use it at exit.
+    static Drainer& shared() noexcept {
+      static auto drainer = new Drainer();
+      return *drainer;
+    }
+
+    bool add(RenderLog* _Nonnull log) noexcept {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (std::find(logs_.begin(), logs_.end(), log) != logs_.end()) return true;
+      try {
+        logs_.push_back(log);
+        if (!thread_.joinable()) thread_ = std::thread([this]() { run(); });
+      } catch (...) {
+        logs_.pop_back();
+        return false;
+      }
+      wake_.notify_one();
+      return true;
+    }
+
+    bool remove(RenderLog* _Nonnull log) noexcept {
+      // Draining happens with the lock held, so once this returns the thread is done with `log`.
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto pos = std::find(logs_.begin(), logs_.end(), log);
+      if (pos == logs_.end()) return false;
+      logs_.erase(pos);
+      return true;
+    }
+
+  private:
+    Drainer() = default;
+
+    [[noreturn]] void run() {
+      std::unique_lock<std::mutex> lock(mutex_);
+      while (true) {
+        wake_.wait(lock, [this]() { return !logs_.empty(); });
+        for (auto log : logs_) log->drain();
+        wake_.wait_for(lock, drainInterval);
+      }
+    }
+
+    std::mutex mutex_{};
+    std::condition_variable wake_{};
+    std::vector<RenderLog*> logs_{};
+    std::thread thread_{};
+  };
+
+  struct Record {
+    std::atomic<size_t> sequence{0};
+    Formatter _Nullable formatter{nullptr};
+    const char* _Nullable format{nullptr};
+    std::byte payload[payloadSize];
+  };
+
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wformat-nonliteral"
+#pragma GCC diagnostic ignored "-Wformat-security"
+
+  template <typename T>
+  static T read(const std::byte* _Nonnull& payload) noexcept {
+    T value;
+    std::memcpy(&value, payload, sizeof(T));
+    payload += sizeof(T);
+    return value;
+  }
+
+  template <typename... Args>
+  static void formatRecord(char* _Nonnull buffer, size_t size, const char* _Nonnull format,
+                           const std::byte* _Nonnull payload) noexcept {
+    // Braced initialization guarantees that the values are read in order.
+    std::tuple<Args...> values{read<Args>(payload)...};
+    std::apply([&](auto... args) { std::snprintf(buffer, size, format, args...); }, values);
+  }
+
+#pragma GCC diagnostic pop
+
+  os_log_t _Nonnull log_;
+  size_t capacity_;
+  size_t mask_;
+  std::unique_ptr<Record[]> records_;
+  std::atomic<size_t> writeIndex_{0};
+  size_t readIndex_{0};
+  std::atomic<size_t> dropped_{0};
+};
+
+} // end namespace DSPHeaders
@@ -0,0 +1,179 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <algorithm>
+#import <array>
+#import <atomic>
+#import <chrono>
+#import <cstdint>
+
+#if defined(__APPLE__)
+#import <mach/mach_time.h>
+#endif
+
+#import "DSPHeaders/AudioTypes.hpp"
+
+/// Controls if `EventProcessor` records `RenderMetrics` values. Disabled by default, in which case there is no cost.
+#if !defined(DSPHEADERS_RENDER_METRICS_ENABLED)
+#define DSPHEADERS_RENDER_METRICS_ENABLED 0
+#endif
+
+namespace DSPHeaders {
+
+/**
+ Collection of timing measurements for render calls. For each call, the writer records the time spent, the number of
+ frames rendered, and the number of sub-blocks the frames were rendered in (due to interleaved events). From these, it
+ computes the fraction of the real-time budget that was used -- the time spent divided by `frameCount / sampleRate` --
+ and counts it in a histogram.
+
+ There must only be one writer (the render thread), but any other thread may read the values at any time without
+ blocking the writer. All values are held in atomics that are updated with relaxed ordering, so a reader may see a
+ snapshot that is a render call or so out of date.
+ */
+class RenderMetrics {
+public:
+
+  /// Width of each budget histogram bucket as a fraction of the budget.
+  static constexpr double bucketWidth = 0.02;
+
+  /// Number of histogram buckets. The last one counts calls that used the whole budget or more.
+  static constexpr size_t bucketCount = 51;
+
+  /**
+   Copy of the values at one point in time.
+   */
+  struct Snapshot {
+    uint64_t calls{0};
+    uint64_t frames{0};
+    uint64_t subBlocks{0};
+    uint64_t totalTicks{0};
+    uint64_t maxTicks{0};
+    uint64_t overruns{0};
+    double maxBudget{0.0};
+    std::array<uint64_t, bucketCount> histogram{};
+
+    /// @returns the average time spent in a render call in seconds
+    double averageSeconds() const noexcept { return calls > 0 ? seconds(totalTicks) / double(calls) : 0.0; }
+
+    /// @returns the largest time spent in a render call in seconds
+    double maxSeconds() const noexcept { return seconds(maxTicks); }
+
+    /**
+     Obtain an upper bound of the budget usage of the given percentile of render calls, as determined by the
+     histogram buckets. It is never more than the largest usage seen.
+
+     @param percentile the percentile to locate in range [0, 1]
+     @returns budget usage
+     */
+    double budgetPercentile(double percentile) const noexcept {
+      auto threshold = uint64_t(std::clamp(percentile, 0.0, 1.0) * double(calls));
+      uint64_t seen = 0;
+      for (size_t bucket = 0; bucket < bucketCount - 1; ++bucket) {
+        seen += histogram[bucket];
+        if (seen >= threshold && seen > 0) return std::min(double(bucket + 1) * bucketWidth, maxBudget);
+      }
+      return maxBudget;
+    }
+  };
+
+  /// @returns current time in clock ticks
+  static uint64_t now() noexcept {
+#if defined(__APPLE__)
+    return mach_absolute_time();
+#else
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+  }
+
+  /**
+   Convert clock ticks into seconds.
+
+   @param ticks the value to convert
+   @returns number of seconds
+   */
+  static double seconds(uint64_t ticks) noexcept { return double(ticks) * secondsPerTick(); }
+
+  /**
+   Record the measurements for a render call. Only one thread must do this.
+
+   @param ticks the number of clock ticks spent rendering
+   @param frameCount the number of frames rendered
+   @param subBlocks the number of sub-blocks the frames were rendered in
+   @param sampleRate the sample rate in effect
+   */
+  void record(uint64_t ticks, AUAudioFrameCount frameCount, uint64_t subBlocks, double sampleRate) noexcept {
+    increment(calls_, 1);
+    increment(frames_, frameCount);
+    increment(subBlocks_, subBlocks);
+    increment(totalTicks_, ticks);
+    if (ticks > maxTicks_.load(std::memory_order_relaxed)) maxTicks_.store(ticks, std::memory_order_relaxed);
+    if (frameCount == 0 || sampleRate <= 0.0) return;
+
+    auto budget = seconds(ticks) * sampleRate / double(frameCount);
+    if (budget > maxBudget_.load(std::memory_order_relaxed)) maxBudget_.store(budget, std::memory_order_relaxed);
+    if (budget >= 1.0) increment(overruns_, 1);
+    auto bucket = std::min(size_t(budget / bucketWidth), bucketCount - 1);
+    increment(histogram_[bucket], 1);
+  }
+
+  /// @returns copy of the current values
+  Snapshot snapshot() const noexcept {
+    Snapshot snapshot;
+    snapshot.calls = calls_.load(std::memory_order_relaxed);
+    snapshot.frames = frames_.load(std::memory_order_relaxed);
+    snapshot.subBlocks = subBlocks_.load(std::memory_order_relaxed);
+    snapshot.totalTicks = totalTicks_.load(std::memory_order_relaxed);
+    snapshot.maxTicks = maxTicks_.load(std::memory_order_relaxed);
+    snapshot.overruns = overruns_.load(std::memory_order_relaxed);
+    snapshot.maxBudget = maxBudget_.load(std::memory_order_relaxed);
+    for (size_t bucket = 0; bucket < bucketCount; ++bucket) {
+      snapshot.histogram[bucket] = histogram_[bucket].load(std::memory_order_relaxed);
+    }
+    return snapshot;
+  }
+
+  /**
+   Clear all values. This should be done when the writer is not active, otherwise a value from a render call in
+   progress may survive.
+   */
+  void reset() noexcept {
+    for (auto counter : {&calls_, &frames_, &subBlocks_, &totalTicks_, &maxTicks_, &overruns_}) {
+      counter->store(0, std::memory_order_relaxed);
+    }
+    maxBudget_.store(0.0, std::memory_order_relaxed);
+    for (auto& count : histogram_) count.store(0, std::memory_order_relaxed);
+  }
+
+private:
+
+  static double secondsPerTick() noexcept {
+#if defined(__APPLE__)
+    static const double value = [] {
+      mach_timebase_info_data_t info;
+      mach_timebase_info(&info);
+      return double(info.numer) / double(info.denom) * 1.0e-9;
+    }();
+    return value;
+#else
+    return 1.0e-9;
+#endif
+  }
+
+  // There is only one writer, so there is no need for an atomic read-modify-write operation.
+  static void increment(std::atomic<uint64_t>& counter, uint64_t amount) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> calls_{0};
+  std::atomic<uint64_t> frames_{0};
+  std::atomic<uint64_t> subBlocks_{0};
+  std::atomic<uint64_t> totalTicks_{0};
+  std::atomic<uint64_t> maxTicks_{0};
+  std::atomic<uint64_t> overruns_{0};
+  std::atomic<double> maxBudget_{0.0};
+  std::array<std::atomic<uint64_t>, bucketCount> histogram_{};
+};
+
+} // end namespace DSPHeaders
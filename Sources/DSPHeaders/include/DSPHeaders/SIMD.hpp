@@ -0,0 +1,348 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <algorithm>
+#import <array>
+#import <cstddef>
+#import <cstdint>
+#import <cstring>
+#import <functional>
+
+/// Set to 1 to use the portable scalar version of `SIMD::Float` instead of the native vector instructions.
+#if !defined(DSPHEADERS_SIMD_SCALAR)
+#define DSPHEADERS_SIMD_SCALAR 0
+#endif
+
+#if !DSPHEADERS_SIMD_SCALAR && defined(__AVX__)
+#import <immintrin.h>
+#define DSPHEADERS_SIMD_AVX 1
+#elif !DSPHEADERS_SIMD_SCALAR && (defined(__SSE2__) || defined(_M_X64))
+#import <emmintrin.h>
+#define DSPHEADERS_SIMD_SSE 1
+#elif !DSPHEADERS_SIMD_SCALAR && defined(__ARM_NEON) && defined(__aarch64__)
+#import <arm_neon.h>
+#define DSPHEADERS_SIMD_NEON 1
+#endif
+
+/**
+ Block operations on runs of samples that use SIMD instructions: AVX or SSE on Intel and NEON on Apple silicon, with a
+ scalar fallback for everything else. The operations are written in terms of `SIMD::Float`, a few lanes of `float`
+ values that support basic arithmetic, and each one finishes off any samples that do not fill a vector one at a time.
+
+ Sample pointers do not need to be aligned. A destination may be the same as a source, but they must not otherwise
+ overlap.
+ */
+namespace DSPHeaders::SIMD {
+
+/**
+ A vector of `width` float values. Only the operations needed by the block operations below are provided. Besides
+ `load`, a vector can be made from `width` integer or double values with `convert`, and `deinterleave` splits two
+ vectors of interleaved stereo samples into left and right ones.
+ */
+struct Float {
+#if defined(DSPHEADERS_SIMD_AVX)
+  static constexpr size_t width = 8;
+  using Native = __m256;
+
+  static Float load(const float* source) noexcept { return {_mm256_loadu_ps(source)}; }
+  static Float broadcast(float value) noexcept { return {_mm256_set1_ps(value)}; }
+  static Float convert(const int16_t* source) noexcept {
+    auto narrow = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+    auto low = _mm_srai_epi32(_mm_unpacklo_epi16(narrow, narrow), 16);
+    auto high = _mm_srai_epi32(_mm_unpackhi_epi16(narrow, narrow), 16);
+    return {_mm256_cvtepi32_ps(_mm256_insertf128_si256(_mm256_castsi128_si256(low), high, 1))};
+  }
+  static Float convert(const int32_t* source) noexcept {
+    return {_mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(source)))};
+  }
+  static Float convert(const double* source) noexcept {
+    auto low = _mm256_cvtpd_ps(_mm256_loadu_pd(source));
+    auto high = _mm256_cvtpd_ps(_mm256_loadu_pd(source + 4));
+    return {_mm256_insertf128_ps(_mm256_castps128_ps256(low), high, 1)};
+  }
+  static void deinterleave(Float first, Float second, Float& even, Float& odd) noexcept {
+    auto low = _mm256_permute2f128_ps(first.value, second.value, 0x20);
+    auto high = _mm256_permute2f128_ps(first.value, second.value, 0x31);
+    even = {_mm256_shuffle_ps(low, high, _MM_SHUFFLE(2, 0, 2, 0))};
+    odd = {_mm256_shuffle_ps(low, high, _MM_SHUFFLE(3, 1, 3, 1))};
+  }
+  void store(float* destination) const noexcept { _mm256_storeu_ps(destination, value); }
+
+  friend Float operator+(Float lhs, Float rhs) noexcept { return {_mm256_add_ps(lhs.value, rhs.value)}; }
+  friend Float operator-(Float lhs, Float rhs) noexcept { return {_mm256_sub_ps(lhs.value, rhs.value)}; }
+  friend Float operator*(Float lhs, Float rhs) noexcept { return {_mm256_mul_ps(lhs.value, rhs.value)}; }
+#elif defined(DSPHEADERS_SIMD_SSE)
+  static constexpr size_t width = 4;
+  using Native = __m128;
+
+  static Float load(const float* source) noexcept { return {_mm_loadu_ps(source)}; }
+  static Float broadcast(float value) noexcept { return {_mm_set1_ps(value)}; }
+  static Float convert(const int16_t* source) noexcept {
+    auto narrow = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(source));
+    return {_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(narrow, narrow), 16))};
+  }
+  static Float convert(const int32_t* source) noexcept {
+    return {_mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source)))};
+  }
+  static Float convert(const double* source) noexcept {
+    return {_mm_movelh_ps(_mm_cvtpd_ps(_mm_loadu_pd(source)), _mm_cvtpd_ps(_mm_loadu_pd(source + 2)))};
+  }
+  static void deinterleave(Float first, Float second, Float& even, Float& odd) noexcept {
+    even = {_mm_shuffle_ps(first.value, second.value, _MM_SHUFFLE(2, 0, 2, 0))};
+    odd = {_mm_shuffle_ps(first.value, second.value, _MM_SHUFFLE(3, 1, 3, 1))};
+  }
+  void store(float* destination) const noexcept { _mm_storeu_ps(destination, value); }
+
+  friend Float operator+(Float lhs, Float rhs) noexcept { return {_mm_add_ps(lhs.value, rhs.value)}; }
+  friend Float operator-(Float lhs, Float rhs) noexcept { return {_mm_sub_ps(lhs.value, rhs.value)}; }
+  friend Float operator*(Float lhs, Float rhs) noexcept { return {_mm_mul_ps(lhs.value, rhs.value)}; }
+#elif defined(DSPHEADERS_SIMD_NEON)
+  static constexpr size_t width = 4;
+  using Native = float32x4_t;
+
+  static Float load(const float* source) noexcept { return {vld1q_f32(source)}; }
+  static Float broadcast(float value) noexcept { return {vdupq_n_f32(value)}; }
+  static Float convert(const int16_t* source) noexcept { return {vcvtq_f32_s32(vmovl_s16(vld1_s16(source)))}; }
+  static Float convert(const int32_t* source) noexcept { return {vcvtq_f32_s32(vld1q_s32(source))}; }
+  static Float convert(const double* source) noexcept {
+    return {vcombine_f32(vcvt_f32_f64(vld1q_f64(source)), vcvt_f32_f64(vld1q_f64(source + 2)))};
+  }
+  static void deinterleave(Float first, Float second, Float& even, Float& odd) noexcept {
+    even = {vuzp1q_f32(first.value, second.value)};
+    odd = {vuzp2q_f32(first.value, second.value)};
+  }
+  void store(float* destination) const noexcept { vst1q_f32(destination, value); }
+
+  friend Float operator+(Float lhs, Float rhs) noexcept { return {vaddq_f32(lhs.value, rhs.value)}; }
+  friend Float operator-(Float lhs, Float rhs) noexcept { return {vsubq_f32(lhs.value, rhs.value)}; }
+  friend Float operator*(Float lhs, Float rhs) noexcept { return {vmulq_f32(lhs.value, rhs.value)}; }
+#else
+  static constexpr size_t width = 4;
+  using Native = std::array<float, width>;
+
+  static Float load(const float* source) noexcept {
+    Float result;
+    std::copy_n(source, width, result.value.begin());
+    return result;
+  }
+  static Float broadcast(float value) noexcept {
+    Float result;
+    result.value.fill(value);
+    return result;
+  }
+  template <typename T>
+  static Float convert(const T* source) noexcept {
+    // Samples in a byte stream may not be aligned for T.
+    std::array<T, width> values;
+    std::memcpy(values.data(), source, sizeof(values));
+    Float result;
+    for (size_t lane = 0; lane < width; ++lane) result.value[lane] = float(values[lane]);
+    return result;
+  }
+  static void deinterleave(Float first, Float second, Float& even, Float& odd) noexcept {
+    for (size_t lane = 0; lane < width / 2; ++lane) {
+      even.value[lane] = first.value[lane * 2];
+      odd.value[lane] = first.value[lane * 2 + 1];
+      even.value[lane + width / 2] = second.value[lane * 2];
+      odd.value[lane + width / 2] = second.value[lane * 2 + 1];
+    }
+  }
+  void store(float* destination) const noexcept { std::copy_n(value.begin(), width, destination); }
+
+  friend Float operator+(Float lhs, Float rhs) noexcept { return combine(lhs, rhs, std::plus<float>()); }
+  friend Float operator-(Float lhs, Float rhs) noexcept { return combine(lhs, rhs, std::minus<float>()); }
+  friend Float operator*(Float lhs, Float rhs) noexcept { return combine(lhs, rhs, std::multiplies<float>()); }
+
+  template <typename Op>
+  static Float combine(Float lhs, Float rhs, Op op) noexcept {
+    Float result;
+    for (size_t lane = 0; lane < width; ++lane) result.value[lane] = op(lhs.value[lane], rhs.value[lane]);
+    return result;
+  }
+#endif
+
+  friend Float operator+(Float lhs, float rhs) noexcept { return lhs + broadcast(rhs); }
+  friend Float operator-(Float lhs, float rhs) noexcept { return lhs - broadcast(rhs); }
+  friend Float operator*(Float lhs, float rhs) noexcept { return lhs * broadcast(rhs); }
+
+  /// @returns vector holding the lane indices 0, 1, 2, ...
+  static Float laneIndices() noexcept {
+    std::array<float, width> indices;
+    for (size_t lane = 0; lane < width; ++lane) indices[lane] = float(lane);
+    return load(indices.data());
+  }
+
+  Native value;
+};
+
+/// @returns the number of samples that fill whole vectors
+inline constexpr size_t vectorEnd(size_t count) noexcept { return count - count % Float::width; }
+
+/**
+ Replace each destination sample with the result of an operation on it. The operation is given either a `Float` or a
+ `float` value, so it must work with both.
+
+ @param destination the samples to update
+ @param count the number of samples to update
+ @param op the operation to perform
+ */
+template <typename Op>
+inline void transform(float* destination, size_t count, Op op) noexcept {
+  size_t index = 0;
+  for (auto end = vectorEnd(count); index < end; index += Float::width) {
+    op(Float::load(destination + index)).store(destination + index);
+  }
+  for (; index < count; ++index) destination[index] = op(destination[index]);
+}
+
+/**
+ Replace each destination sample with the result of an operation on it and the corresponding source sample. The
+ operation is given either `Float` or `float` values, so it must work with both.
+
+ @param source the samples to read
+ @param destination the samples to update
+ @param count the number of samples to update
+ @param op the operation to perform, called with the source value first
+ */
+template <typename Op>
+inline void transform(const float* source, float* destination, size_t count, Op op) noexcept {
+  size_t index = 0;
+  for (auto end = vectorEnd(count); index < end; index += Float::width) {
+    op(Float::load(source + index), Float::load(destination + index)).store(destination + index);
+  }
+  for (; index < count; ++index) destination[index] = op(source[index], destination[index]);
+}
+
+/**
+ Add samples to another set of samples.
+
+ @param source the samples to add
+ @param destination the samples to add to
+ @param count the number of samples to process
+ */
+inline void add(const float* source, float* destination, size_t count) noexcept {
+  transform(source, destination, count, [](auto in, auto out) { return out + in; });
+}
+
+/**
+ Add scaled samples to another set of samples.
+
+ @param source the samples to add
+ @param gain the scaling to apply to the source samples
+ @param destination the samples to add to
+ @param count the number of samples to process
+ */
+inline void addScaled(const float* source, float gain, float* destination, size_t count) noexcept {
+  transform(source, destination, count, [gain](auto in, auto out) { return out + in * gain; });
+}
+
+/**
+ Add samples scaled by per-sample gains to another set of samples.
+
+ @param source the samples to add
+ @param gains the scaling to apply to each source sample
+ @param destination the samples to add to
+ @param count the number of samples to process
+ */
+inline void addProduct(const float* source, const float* gains, float* destination, size_t count) noexcept {
+  size_t index = 0;
+  for (auto end = vectorEnd(count); index < end; index += Float::width) {
+    auto in = Float::load(source + index) * Float::load(gains + index);
+    (Float::load(destination + index) + in).store(destination + index);
+  }
+  for (; index < count; ++index) destination[index] += source[index] * gains[index];
+}
+
+/**
+ Scale samples by a gain.
+
+ @param destination the samples to scale
+ @param gain the scaling to apply
+ @param count the number of samples to process
+ */
+inline void scale(float* destination, float gain, size_t count) noexcept {
+  transform(destination, count, [gain](auto out) { return out * gain; });
+}
+
+/**
+ Scale samples by per-sample gains.
+
+ @param gains the scaling to apply to each sample
+ @param destination the samples to scale
+ @param count the number of samples to process
+ */
+inline void multiply(const float* gains, float* destination, size_t count) noexcept {
+  transform(gains, destination, count, [](auto gain, auto out) { return out * gain; });
+}
+
+/**
+ Scale samples by a gain that changes linearly, starting with `start` and changing by `step` for each sample.
+
+ @param destination the samples to scale
+ @param start the gain to apply to the first sample
+ @param step the change in gain from one sample to the next
+ @param count the number of samples to process
+ */
+inline void scaleRamp(float* destination, float start, float step, size_t count) noexcept {
+  auto steps = Float::laneIndices() * step;
+  size_t index = 0;
+  for (auto end = vectorEnd(count); index < end; index += Float::width) {
+    // Compute from the start each time so that rounding errors do not accumulate.
+    auto gains = steps + (start + step * float(index));
+    (Float::load(destination + index) * gains).store(destination + index);
+  }
+  for (; index < count; ++index) destination[index] *= start + step * float(index);
+}
+
+/**
+ Write mono samples to a left and a right channel with a different gain for each.
+
+ @param source the samples to read
+ @param leftGain the scaling to apply for the left channel
+ @param rightGain the scaling to apply for the right channel
+ @param left the left channel samples to write
+ @param right the right channel samples to write
+ @param count the number of samples to process
+ */
+inline void pan(const float* source, float leftGain, float rightGain, float* left, float* right,
+                size_t count) noexcept {
+  size_t index = 0;
+  for (auto end = vectorEnd(count); index < end; index += Float::width) {
+    auto in = Float::load(source + index);
+    (in * leftGain).store(left + index);
+    (in * rightGain).store(right + index);
+  }
+  for (; index < count; ++index) {
+    auto in = source[index];
+    left[index] = in * leftGain;
+    right[index] = in * rightGain;
+  }
+}
+
+/**
+ Convert a pair of channels in place, replacing them with their scaled sum and difference. With a `gain` of 0.5 this
+ converts left/right to mid/side, and with 1.0 it converts mid/side back to left/right.
+
+ @param first the left or mid samples
+ @param second the right or side samples
+ @param gain the scaling to apply to the sum and difference
+ @param count the number of samples to process
+ */
+inline void sumAndDifference(float* first, float* second, float gain, size_t count) noexcept {
+  size_t index = 0;
+  for (auto end = vectorEnd(count); index < end; index += Float::width) {
+    auto a = Float::load(first + index);
+    auto b = Float::load(second + index);
+    ((a + b) * gain).store(first + index);
+    ((a - b) * gain).store(second + index);
+  }
+  for (; index < count; ++index) {
+    auto a = first[index];
+    auto b = second[index];
+    first[index] = (a + b) * gain;
+    second[index] = (a - b) * gain;
+  }
+}
+
+} // end namespace DSPHeaders::SIMD
@@ -0,0 +1,96 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <array>
+#import <atomic>
+#import <bit>
+#import <cstddef>
+#import <new>
+#import <type_traits>
+
+namespace DSPHeaders {
+
+/**
+ Bounded single-producer, single-consumer queue. Both sides are wait-free: `push` fails right away when the queue is
+ full, and `peek` returns `nullptr` when there is nothing to consume. The storage is held inside the instance, so there
+ is no allocation after construction.
+
+ The consumer may look ahead at any of the pushed values before popping them, which is how `EventProcessor` finds and
+ skips redundant commands.
+
+ @param T the type of value to hold. Must be trivially copyable.
+ @param Capacity the number of values the queue can hold. Must be a power of 2.
+ */
+template <typename T, size_t Capacity>
+class SPSCQueue {
+public:
+  static_assert(std::is_trivially_copyable_v<T>, "SPSCQueue values must be trivially copyable");
+  static_assert(std::has_single_bit(Capacity), "SPSCQueue capacity must be a power of 2");
+
+  SPSCQueue() noexcept = default;
+
+  SPSCQueue(const SPSCQueue&) = delete;
+  SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+  /// @returns number of values the queue can hold
+  static constexpr size_t capacity() noexcept { return Capacity; }
+
+  /**
+   Add a value to the end of the queue. Only call from the producer thread.
+
+   @param value the value to add
+   @returns true if added, false if the queue is full
+   */
+  bool push(const T& value) noexcept {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cachedHead_ == Capacity) {
+      cachedHead_ = head_.load(std::memory_order_acquire);
+      if (tail - cachedHead_ == Capacity) return false;
+    }
+    slots_[tail & mask] = value;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   Obtain a value in the queue without removing it. Only call from the consumer thread.
+
+   @param offset the position of the value to return, where 0 is the front of the queue
+   @returns pointer to the value or `nullptr` if there are not enough values in the queue
+   */
+  const T* peek(size_t offset = 0) noexcept {
+    auto head = head_.load(std::memory_order_relaxed);
+    if (cachedTail_ - head <= offset) {
+      cachedTail_ = tail_.load(std::memory_order_acquire);
+      if (cachedTail_ - head <= offset) return nullptr;
+    }
+    return &slots_[(head + offset) & mask];
+  }
+
+  /**
+   Remove the value at the front of the queue. Only call from the consumer thread after `peek` has shown that there is
+   a value to remove.
+   */
+  void pop() noexcept { head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+  /// @returns approximate number of values in the queue. Exact when called from either side while the other is idle.
+  size_t size() const noexcept { return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire); }
+
+  /// @returns true if the queue appears to be empty
+  bool empty() const noexcept { return size() == 0; }
+
+private:
+  static constexpr size_t mask = Capacity - 1;
+
+  // Keep the producer and consumer indices on separate cache lines so that the two threads do not fight over them.
+  static constexpr size_t cacheLineSize = 64;
+
+  alignas(cacheLineSize) std::atomic<size_t> head_{0};
+  size_t cachedTail_{0};
+  alignas(cacheLineSize) std::atomic<size_t> tail_{0};
+  size_t cachedHead_{0};
+  alignas(cacheLineSize) std::array<T, Capacity> slots_{};
+};
+
+} // end namespace DSPHeaders
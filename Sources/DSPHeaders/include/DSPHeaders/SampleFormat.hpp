@@ -0,0 +1,424 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <algorithm>
+#import <array>
+#import <cassert>
+#import <cstddef>
+#import <cstdint>
+#import <cstring>
+#import <span>
+#import <type_traits>
+#import <vector>
+
+#import "DSPHeaders/AudioTypes.hpp"
+#import "DSPHeaders/BusBufferFacet.hpp"
+#import "DSPHeaders/BusBuffers.hpp"
+#import "DSPHeaders/SIMD.hpp"
+
+namespace DSPHeaders {
+
+/**
+ The sample encodings that can be converted into `AUValue` samples. Integer samples are signed, little-endian and
+ packed, so a 24-bit sample takes up 3 bytes.
+ */
+enum class SampleFormat {
+  float32,
+  float64,
+  int16,
+  int24,
+  int32
+};
+
+/**
+ @param format the sample format to query
+ @returns the number of bytes used by one sample
+ */
+inline constexpr size_t bytesPerSample(SampleFormat format) noexcept {
+  switch (format) {
+    case SampleFormat::float32: return 4;
+    case SampleFormat::float64: return 8;
+    case SampleFormat::int16: return 2;
+    case SampleFormat::int24: return 3;
+    case SampleFormat::int32: return 4;
+  }
+  return 0;
+}
+
+/**
+ Description of a stream of samples: how they are encoded, how many channels there are, and if the channels are
+ interleaved in one buffer or held in their own buffers.
+ */
+struct StreamFormat {
+  SampleFormat sampleFormat{SampleFormat::float32};
+  AUAudioChannelCount channelCount{1};
+  bool interleaved{false};
+
+  /// @returns the number of bytes between a sample and the next one of the same channel
+  size_t frameStride() const noexcept { return bytesPerSample(sampleFormat) * (interleaved ? channelCount : 1); }
+
+  /// @returns true if the samples can be used as-is for `AUValue` samples, though perhaps with a stride
+  bool isNative() const noexcept { return sampleFormat == SampleFormat::float32; }
+
+  /// @returns true if each channel is a contiguous run of `AUValue` samples
+  bool isContiguous() const noexcept { return isNative() && (!interleaved || channelCount == 1); }
+
+  friend bool operator==(const StreamFormat&, const StreamFormat&) = default;
+};
+
+/**
+ Read-only view of the samples of one channel, where consecutive samples are `stride` values apart. For interleaved
+ samples, the stride is the number of channels.
+ */
+class StridedSamples {
+public:
+  StridedSamples() noexcept = default;
+
+  /**
+   Construct new view.
+
+   @param samples pointer to the first sample
+   @param stride the distance between samples
+   */
+  StridedSamples(const AUValue* samples, size_t stride) noexcept : samples_{samples}, stride_{stride} {}
+
+  /// @returns the sample at the given frame
+  const AUValue& operator[](size_t frame) const noexcept { return samples_[frame * stride_]; }
+
+  /// @returns pointer to the first sample
+  const AUValue* data() const noexcept { return samples_; }
+
+  /// @returns the distance between samples
+  size_t stride() const noexcept { return stride_; }
+
+  /// @returns true if the samples are contiguous
+  bool isContiguous() const noexcept { return stride_ == 1; }
+
+private:
+  const AUValue* samples_{nullptr};
+  size_t stride_{1};
+};
+
+namespace SampleConversion {
+
+namespace Detail {
+
+template <typename T>
+inline T read(const std::byte* source) noexcept {
+  T value;
+  std::memcpy(&value, source, sizeof(T));
+  return value;
+}
+
+inline int32_t readInt24(const std::byte* source) noexcept {
+  auto bytes = reinterpret_cast<const uint8_t*>(source);
+  return int32_t(uint32_t(bytes[0]) << 8 | uint32_t(bytes[1]) << 16 | uint32_t(bytes[2]) << 24) >> 8;
+}
+
+/// Sample type with a `SIMD::Float` conversion, and the scaling that brings its values into [-1.0, 1.0].
+template <typename T>
+struct Codec {
+  static constexpr float scale = std::is_floating_point_v<T> ? 1.0f : 1.0f / float(1LL << (sizeof(T) * 8 - 1));
+
+  static AUValue read(const std::byte* source) noexcept { return AUValue(Detail::read<T>(source)) * scale; }
+
+  static SIMD::Float load(const std::byte* source) noexcept {
+    auto samples = reinterpret_cast<const T*>(source);
+    if constexpr (std::is_same_v<T, float>) {
+      return SIMD::Float::load(samples);
+    } else if constexpr (std::is_floating_point_v<T>) {
+      return SIMD::Float::convert(samples);
+    } else {
+      return SIMD::Float::convert(samples) * scale;
+    }
+  }
+};
+
+/// Packed 24-bit samples have no vector conversion.
+struct Int24Codec {
+  static AUValue read(const std::byte* source) noexcept { return AUValue(readInt24(source)) * (1.0f / 8388608.0f); }
+};
+
+template <typename Codec, typename T>
+inline void decodeContiguous(const std::byte* source, AUValue* destination, size_t count) noexcept {
+  size_t index = 0;
+  for (auto end = SIMD::vectorEnd(count); index < end; index += SIMD::Float::width) {
+    Codec::load(source + index * sizeof(T)).store(destination + index);
+  }
+  for (; index < count; ++index) destination[index] = Codec::read(source + index * sizeof(T));
+}
+
+template <typename Codec, typename T>
+inline void deinterleaveStereo(const std::byte* source, AUValue* left, AUValue* right, size_t count) noexcept {
+  constexpr auto width = SIMD::Float::width;
+  size_t index = 0;
+  for (auto end = SIMD::vectorEnd(count); index < end; index += width) {
+    auto frames = source + index * 2 * sizeof(T);
+    SIMD::Float even;
+    SIMD::Float odd;
+    SIMD::Float::deinterleave(Codec::load(frames), Codec::load(frames + width * sizeof(T)), even, odd);
+    even.store(left + index);
+    odd.store(right + index);
+  }
+  for (; index < count; ++index) {
+    left[index] = Codec::read(source + index * 2 * sizeof(T));
+    right[index] = Codec::read(source + (index * 2 + 1) * sizeof(T));
+  }
+}
+
+template <typename Codec>
+inline void decodeStrided(const std::byte* source, size_t stride, AUValue* destination, size_t count) noexcept {
+  for (size_t index = 0; index < count; ++index) destination[index] = Codec::read(source + index * stride);
+}
+
+template <typename Codec>
+inline void deinterleaveFrames(const std::byte* source, size_t sampleSize, std::span<AUValue* const> destinations,
+                               size_t count) noexcept {
+  auto channelCount = destinations.size();
+  for (size_t index = 0; index < count; ++index) {
+    for (size_t channel = 0; channel < channelCount; ++channel) {
+      destinations[channel][index] = Codec::read(source + (index * channelCount + channel) * sampleSize);
+    }
+  }
+}
+
+/// Invoke `proc` with the codec for a format and the sample type it reads, if there is one
+template <typename Proc>
+inline void withCodec(SampleFormat format, Proc&& proc) noexcept {
+  switch (format) {
+    case SampleFormat::float32: proc(Codec<float>(), float()); break;
+    case SampleFormat::float64: proc(Codec<double>(), double()); break;
+    case SampleFormat::int16: proc(Codec<int16_t>(), int16_t()); break;
+    case SampleFormat::int24: proc(Int24Codec(), nullptr); break;
+    case SampleFormat::int32: proc(Codec<int32_t>(), int32_t()); break;
+  }
+}
+
+} // end namespace Detail
+
+/**
+ Convert the samples of one channel into `AUValue` samples. Contiguous samples are converted `SIMD::Float::width` at a
+ time, except for packed 24-bit ones which are always done one at a time.
+
+ @param format the encoding of the source samples
+ @param source pointer to the first sample to convert
+ @param stride the number of bytes from one source sample to the next
+ @param destination where to store the converted samples
+ @param count the number of samples to convert
+ */
+inline void decode(SampleFormat format, const std::byte* source, size_t stride, AUValue* destination,
+                   size_t count) noexcept {
+  if (format == SampleFormat::float32 && stride == sizeof(AUValue)) {
+    std::memcpy(destination, source, count * sizeof(AUValue));
+    return;
+  }
+  Detail::withCodec(format, [&](auto codec, auto sample) {
+    using Codec = decltype(codec);
+    using T = decltype(sample);
+    if constexpr (!std::is_null_pointer_v<T>) {
+      if (stride == sizeof(T)) return Detail::decodeContiguous<Codec, T>(source, destination, count);
+    }
+    Detail::decodeStrided<Codec>(source, stride, destination, count);
+  });
+}
+
+/**
+ Convert interleaved samples into `AUValue` samples, one destination per channel. Stereo samples are converted and split
+ apart `SIMD::Float::width` frames at a time with vector shuffles (except for packed 24-bit ones). Other channel counts
+ are done one frame at a time, which reads the source once from start to end.
+
+ @param format the encoding of the source samples
+ @param source pointer to the first sample of the first frame
+ @param destinations where to store the converted samples of each channel
+ @param count the number of frames to convert
+ */
+inline void deinterleave(SampleFormat format, const std::byte* source, std::span<AUValue* const> destinations,
+                         size_t count) noexcept {
+  if (destinations.size() == 1) return decode(format, source, bytesPerSample(format), destinations[0], count);
+  Detail::withCodec(format, [&](auto codec, auto sample) {
+    using Codec = decltype(codec);
+    using T = decltype(sample);
+    if constexpr (!std::is_null_pointer_v<T>) {
+      if (destinations.size() == 2) {
+        return Detail::deinterleaveStereo<Codec, T>(source, destinations[0], destinations[1], count);
+      }
+    }
+    Detail::deinterleaveFrames<Codec>(source, bytesPerSample(format), destinations, count);
+  });
+}
+
+} // end namespace SampleConversion
+
+/**
+ Provides `AUValue` views of the channels of a buffer of samples in any `StreamFormat`. When the format allows it, the
+ views refer to the original samples: non-interleaved `float32` channels become `BusBuffers` pointers as-is, and
+ interleaved `float32` channels are available as `StridedSamples` views. Otherwise, the samples are converted and
+ deinterleaved into scratch buffers that are allocated by `setFormat`, so nothing is allocated while rendering.
+
+ The facet is meant for the input side of a kernel, so a kernel can take samples in the format they come in without a
+ separate conversion stage in front of it. Kernels that can work with strided samples should use `channel`, which never
+ copies `float32` samples. Those that need contiguous samples should use `busBuffers`, which only copies when needed.
+
+ As with `BasicBusBufferFacet`, problems are reported with `AUAudioUnitStatus` codes when the `Validation` policy is
+ `BufferValidation::Strict`.
+ */
+template <typename Validation = DefaultBufferValidation>
+class BasicFormatFacet {
+public:
+
+  /**
+   Construct a new instance.
+   */
+  BasicFormatFacet() noexcept {}
+
+  /**
+   Set the format of the samples to expect and allocate the scratch buffers for them. This must be called before
+   rendering is started.
+
+   @param format the format of the samples
+   @param maxFrames the maximum number of frames to be given to `assign`
+   @returns `kAudioUnitErr_FormatNotSupported` if the format has more than `BusBuffers::maxChannelCount` channels, in
+   which case the facet is left unchanged, `noErr` otherwise
+   */
+  AUAudioUnitStatus setFormat(StreamFormat format, AUAudioFrameCount maxFrames) {
+    if (format.channelCount > BusBuffers::maxChannelCount) return kAudioUnitErr_FormatNotSupported;
+    format_ = format;
+    maxFrames_ = maxFrames;
+    scratch_.assign(format.isContiguous() ? 0 : size_t(format.channelCount) * maxFrames, AUValue(0.0));
+    sources_.fill(nullptr);
+    pointers_.fill(nullptr);
+    frameCount_ = 0;
+    deinterleaved_ = false;
+    return noErr;
+  }
+
+  /**
+   Use the samples of an `AudioBufferList`. For an interleaved format, the list must have one buffer that holds all of
+   the channels. Otherwise, there must be one buffer per channel.
+
+   @param bufferList the buffers that hold the samples
+   @param frameCount the number of frames in each buffer
+   @returns `kAudioUnitErr_InvalidParameter` if there are no samples, `kAudioUnitErr_FormatNotSupported` if the number
+   of buffers does not match the format, `kAudioUnitErr_TooManyFramesToProcess` if `frameCount` is more than the
+   `maxFrames` value given to `setFormat`, or `noErr`
+   */
+  AUAudioUnitStatus assignBufferList(AudioBufferList* bufferList, AUAudioFrameCount frameCount) noexcept {
+    if constexpr (Validation::enabled) {
+      if (bufferList == nullptr) [[unlikely]] return kAudioUnitErr_InvalidParameter;
+      if (bufferList->mNumberBuffers != (format_.interleaved ? 1 : format_.channelCount)) [[unlikely]] {
+        return kAudioUnitErr_FormatNotSupported;
+      }
+      for (UInt32 buffer = 0; buffer < bufferList->mNumberBuffers; ++buffer) {
+        if (bufferList->mBuffers[buffer].mData == nullptr) [[unlikely]] return kAudioUnitErr_InvalidParameter;
+      }
+    }
+
+    if (format_.interleaved) return assign(bufferList->mBuffers[0].mData, frameCount);
+    for (UInt32 channel = 0; channel < format_.channelCount; ++channel) {
+      sources_[channel] = static_cast<std::byte*>(bufferList->mBuffers[channel].mData);
+    }
+    return update(frameCount);
+  }
+
+  /**
+   Use the samples of an interleaved buffer.
+
+   @param samples pointer to the first sample of the first frame
+   @param frameCount the number of frames in the buffer
+   @returns `kAudioUnitErr_InvalidParameter` if there are no samples, `kAudioUnitErr_FormatNotSupported` if the format
+   is not interleaved, `kAudioUnitErr_TooManyFramesToProcess` if `frameCount` is more than the `maxFrames` value given
+   to `setFormat`, or `noErr`
+   */
+  AUAudioUnitStatus assign(void* samples, AUAudioFrameCount frameCount) noexcept {
+    if constexpr (Validation::enabled) {
+      if (samples == nullptr) [[unlikely]] return kAudioUnitErr_InvalidParameter;
+      if (!format_.interleaved && format_.channelCount > 1) [[unlikely]] return kAudioUnitErr_FormatNotSupported;
+    }
+    auto bytes = bytesPerSample(format_.sampleFormat);
+    for (UInt32 channel = 0; channel < format_.channelCount; ++channel) {
+      sources_[channel] = static_cast<std::byte*>(samples) + channel * bytes;
+    }
+    return update(frameCount);
+  }
+
+  /**
+   Obtain a view of the samples of a channel. This never copies `float32` samples.
+
+   @param channel the channel to access
+   @returns view of the samples
+   */
+  StridedSamples channel(size_t channel) const noexcept {
+    if (format_.isNative()) {
+      return {reinterpret_cast<const AUValue*>(sources_[channel]), format_.frameStride() / sizeof(AUValue)};
+    }
+    return {pointers_[channel], 1};
+  }
+
+  /**
+   Obtain contiguous samples for all of the channels. Interleaved `float32` samples are deinterleaved into the scratch
+   buffers the first time this is called after an `assign`; all other formats were already converted by `assign`.
+
+   @returns new BusBuffers instance that holds the sample pointers of the channels
+   */
+  BusBuffers busBuffers() noexcept {
+    if (format_.isNative() && !format_.isContiguous() && !deinterleaved_) {
+      convert();
+      deinterleaved_ = true;
+    }
+    return BusBuffers(std::span<AUValue* const>(pointers_.data(), format_.channelCount));
+  }
+
+  /// @returns the format of the samples
+  const StreamFormat& format() const noexcept { return format_; }
+
+  /// @returns the number of frames given to the last `assign` call
+  AUAudioFrameCount frameCount() const noexcept { return frameCount_; }
+
+  /// @returns the number of channels
+  size_t channelCount() const noexcept { return format_.channelCount; }
+
+  /// @returns true if the current samples are used without copying them
+  bool isZeroCopy() const noexcept { return format_.isContiguous(); }
+
+private:
+
+  AUAudioUnitStatus update(AUAudioFrameCount frameCount) noexcept {
+    if constexpr (Validation::enabled) {
+      if (frameCount > maxFrames_) [[unlikely]] return kAudioUnitErr_TooManyFramesToProcess;
+    }
+    frameCount_ = frameCount;
+    deinterleaved_ = false;
+    for (UInt32 channel = 0; channel < format_.channelCount; ++channel) {
+      pointers_[channel] = format_.isContiguous() ? reinterpret_cast<AUValue*>(sources_[channel])
+                                                  : scratch_.data() + size_t(channel) * maxFrames_;
+    }
+    if (!format_.isNative()) convert();
+    return noErr;
+  }
+
+  void convert() noexcept {
+    if (format_.interleaved) {
+      SampleConversion::deinterleave(format_.sampleFormat, sources_[0],
+                                     std::span<AUValue* const>(pointers_.data(), format_.channelCount), frameCount_);
+    } else {
+      for (UInt32 channel = 0; channel < format_.channelCount; ++channel) {
+        SampleConversion::decode(format_.sampleFormat, sources_[channel], bytesPerSample(format_.sampleFormat),
+                                 pointers_[channel], frameCount_);
+      }
+    }
+  }
+
+  StreamFormat format_{};
+  AUAudioFrameCount maxFrames_{0};
+  AUAudioFrameCount frameCount_{0};
+  bool deinterleaved_{false};
+  std::vector<AUValue> scratch_{};
+  std::array<std::byte*, BusBuffers::maxChannelCount> sources_{};
+  std::array<AUValue*, BusBuffers::maxChannelCount> pointers_{};
+};
+
+/// The format facet with validation set by `DSPHEADERS_BUFFER_VALIDATION_STRICT`.
+using FormatFacet = BasicFormatFacet<>;
+
+} // end namespace DSPHeaders
@@ -0,0 +1,70 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#import <array>
+#import <atomic>
+#import <cstdint>
+
+namespace DSPHeaders {
+
+/**
+ Wait-free hand-off of the latest value of something from one writer thread to one reader thread. There are three
+ copies of the value: one that the writer owns, one that the reader owns, and one in the middle. Publishing swaps the
+ writer's copy with the middle one, and reading swaps the middle one with the reader's copy if it holds something
+ newer. Neither side ever waits for the other, and the reader always sees a complete value.
+
+ Values that are published before the reader gets to them are replaced, so this is only suitable for things such as
+ meter levels where the most recent value is all that matters.
+
+ @param T the type of value to hold
+ */
+template <typename T>
+class TripleBuffer {
+public:
+
+  TripleBuffer() noexcept = default;
+
+  TripleBuffer(const TripleBuffer&) = delete;
+  TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+  /// @returns the value for the writer to fill before calling `publish`. Only call from the writer thread.
+  T& writeValue() noexcept { return slots_[writeIndex_]; }
+
+  /**
+   Make the value from `writeValue` available to the reader. The writer then gets a different value to fill, one
+   which holds stale contents. Only call from the writer thread.
+   */
+  void publish() noexcept {
+    auto previous = middle_.exchange(uint8_t(writeIndex_ | freshFlag), std::memory_order_acq_rel);
+    writeIndex_ = previous & indexMask;
+  }
+
+  /// @returns true if there is a newly-published value for the reader.
+  bool hasUpdate() const noexcept { return (middle_.load(std::memory_order_relaxed) & freshFlag) != 0; }
+
+  /**
+   Obtain the latest published value. Only call from the reader thread. The returned reference remains valid and
+   unchanged until the next call to `read`.
+
+   @returns reference to the latest value
+   */
+  const T& read() noexcept {
+    if (hasUpdate()) {
+      auto previous = middle_.exchange(readIndex_, std::memory_order_acq_rel);
+      readIndex_ = previous & indexMask;
+    }
+    return slots_[readIndex_];
+  }
+
+private:
+  static constexpr uint8_t indexMask = 0x03;
+  static constexpr uint8_t freshFlag = 0x04;
+
+  std::array<T, 3> slots_{};
+  uint8_t writeIndex_{0};
+  std::atomic<uint8_t> middle_{1};
+  uint8_t readIndex_{2};
+};
+
+} // end namespace DSPHeaders
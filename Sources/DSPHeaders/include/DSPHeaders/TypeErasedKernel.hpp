@@ -17,12 +17,25 @@ struct TypeErasedKernel
                                                            AudioBufferList*,
                                                            const AURenderEvent*,
                                                            AURenderPullInputBlock)>;
+  /// Variant that also receives the render action flags so that a kernel can report silent output.
+  using ProcessAndRenderWithFlags = std::function<AUAudioUnitStatus(const AudioTimeStamp*,
+                                                                    UInt32,
+                                                                    NSInteger,
+                                                                    AudioBufferList*,
+                                                                    const AURenderEvent*,
+                                                                    AURenderPullInputBlock,
+                                                                    AudioUnitRenderActionFlags*)>;
+
   TypeErasedKernel() : processAndRender{} {}
 
   TypeErasedKernel(ProcessAndRender par) : processAndRender{par} {}
 
+  TypeErasedKernel(ProcessAndRenderWithFlags par) : processAndRenderWithFlags{par} {}
+
   std::function<AUAudioUnitStatus(const AudioTimeStamp*, UInt32, NSInteger, AudioBufferList*, const AURenderEvent*,
                                   AURenderPullInputBlock)> processAndRender;
+
+  ProcessAndRenderWithFlags processAndRenderWithFlags;
 };
 
 struct RenderBlockShim
@@ -30,7 +43,18 @@ struct RenderBlockShim
   RenderBlockShim(TypeErasedKernel kernel) : kernel_{kernel} {}
 
   AUInternalRenderBlock internalRenderBlock() {
-    if (kernel_.processAndRender) {
+    if (kernel_.processAndRenderWithFlags) {
+      return ^AUAudioUnitStatus(AudioUnitRenderActionFlags         *actionFlags,
+                                const AudioTimeStamp               *timestamp,
+                                AVAudioFrameCount                   frameCount,
+                                NSInteger                           outputBusNumber,
+                                AudioBufferList                    *outputData,
+                                const AURenderEvent                *realtimeEventListHead,
+                                AURenderPullInputBlock __unsafe_unretained pullInputBlock) {
+        return kernel_.processAndRenderWithFlags(timestamp, frameCount, outputBusNumber, outputData,
+                                                 realtimeEventListHead, pullInputBlock, actionFlags);
+      };
+    } else if (kernel_.processAndRender) {
       return ^AUAudioUnitStatus(AudioUnitRenderActionFlags         *actionFlags,
                                 const AudioTimeStamp               *timestamp,
                                 AVAudioFrameCount                   frameCount,
@@ -0,0 +1,103 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <cstdint>
+
+#import "DSPHeaders/BufferArena.hpp"
+
+using namespace DSPHeaders;
+
+@interface BufferArenaTests : XCTestCase
+@end
+
+@implementation BufferArenaTests
+
+- (void)testChannelStride {
+  // Rounded up to whole cache lines
+  XCTAssertEqual(BufferArena::channelStride(0), 16);
+  XCTAssertEqual(BufferArena::channelStride(1), 16);
+  XCTAssertEqual(BufferArena::channelStride(100), 112);
+  // Padded by a cache line when a multiple of 1 KiB
+  XCTAssertEqual(BufferArena::channelStride(256), 272);
+  XCTAssertEqual(BufferArena::channelStride(512), 528);
+  XCTAssertEqual(BufferArena::channelStride(4096), 4112);
+  XCTAssertEqual(BufferArena::channelStride(384), 384);
+}
+
+- (void)testInit {
+  BufferArena arena;
+  XCTAssertEqual(arena.busCount(), 0);
+  XCTAssertEqual(arena.channelCount(), 0);
+  XCTAssertEqual(arena.capacity(), 0);
+
+  arena.allocate(3, 2, 512);
+  XCTAssertEqual(arena.busCount(), 3);
+  XCTAssertEqual(arena.channelCount(), 2);
+  XCTAssertEqual(arena.capacity(), 512);
+  XCTAssertEqual(arena.stride(), 528);
+
+  arena.release();
+  XCTAssertEqual(arena.busCount(), 0);
+  XCTAssertEqual(arena.capacity(), 0);
+}
+
+- (void)testLayout {
+  BufferArena arena;
+  arena.allocate(3, 2, 100);
+  AUValue* last = nullptr;
+  for (size_t bus = 0; bus < arena.busCount(); ++bus) {
+    auto bufferList = arena.mutableAudioBufferList(bus);
+    XCTAssertEqual(bufferList->mNumberBuffers, 2);
+    for (size_t channel = 0; channel < arena.channelCount(); ++channel) {
+      auto& buffer{bufferList->mBuffers[channel]};
+      XCTAssertEqual(buffer.mNumberChannels, 1);
+      XCTAssertEqual(buffer.mDataByteSize, 100 * sizeof(AUValue));
+      XCTAssertEqual(buffer.mData, arena.samples(bus, channel));
+      XCTAssertEqual(reinterpret_cast<uintptr_t>(buffer.mData) % BufferArena::alignment, 0);
+
+      // Channels follow each other without overlap, and the buffer lists come before all of them.
+      auto samples = static_cast<AUValue*>(buffer.mData);
+      if (last != nullptr) XCTAssertEqual(samples - last, ptrdiff_t(arena.stride()));
+      XCTAssertTrue(reinterpret_cast<std::byte*>(samples) >=
+                    reinterpret_cast<std::byte*>(arena.mutableAudioBufferList(2)->mBuffers + 2));
+      for (size_t frame = 0; frame < arena.capacity(); ++frame) XCTAssertEqual(samples[frame], 0.0);
+      last = samples;
+    }
+  }
+}
+
+- (void)testFrameCountAndReset {
+  BufferArena arena;
+  arena.allocate(2, 2, 64);
+  arena.setFrameCount(32);
+  XCTAssertEqual(arena.mutableAudioBufferList(0)->mBuffers[1].mDataByteSize, 32 * sizeof(AUValue));
+  XCTAssertEqual(arena.mutableAudioBufferList(1)->mBuffers[0].mDataByteSize, 32 * sizeof(AUValue));
+  arena.setFrameCount(1, 16);
+  XCTAssertEqual(arena.mutableAudioBufferList(0)->mBuffers[0].mDataByteSize, 32 * sizeof(AUValue));
+  XCTAssertEqual(arena.mutableAudioBufferList(1)->mBuffers[1].mDataByteSize, 16 * sizeof(AUValue));
+
+  // A host is free to swap in its own buffers
+  AUValue other[64];
+  arena.mutableAudioBufferList(1)->mBuffers[0].mData = other;
+  arena.reset(1);
+  XCTAssertEqual(arena.mutableAudioBufferList(1)->mBuffers[0].mData, arena.samples(1, 0));
+}
+
+- (void)testReallocate {
+  BufferArena arena;
+  arena.allocate(1, 1, 16);
+  arena.samples(0, 0)[0] = 1.0;
+  arena.allocate(2, 4, 32);
+  XCTAssertEqual(arena.busCount(), 2);
+  XCTAssertEqual(arena.mutableAudioBufferList(1)->mNumberBuffers, 4);
+  XCTAssertEqual(arena.samples(0, 0)[0], 0.0);
+
+  // Storage is reused when the new layout fits
+  auto samples = arena.samples(1, 3);
+  samples[0] = 1.0;
+  arena.allocate(2, 4, 32);
+  XCTAssertEqual(arena.samples(1, 3), samples);
+  XCTAssertEqual(samples[0], 0.0);
+}
+
+@end
@@ -53,15 +53,23 @@ static AUAudioFrameCount maxFrames = 100;
   BusSampleBuffer stereoBuffer;
   stereoBuffer.allocate(stereoFormat, maxFrames);
 
-  BusBufferFacet facet;
+  BasicBusBufferFacet<BufferValidation::Strict> facet;
   facet.setChannelCount(1);
-  XCTAssertNoThrow(facet.assignBufferList(monoBuffer.mutableAudioBufferList()));
+  XCTAssertEqual(noErr, facet.assignBufferList(monoBuffer.mutableAudioBufferList()));
 
   facet.setChannelCount(2);
-  XCTAssertNoThrow(facet.assignBufferList(stereoBuffer.mutableAudioBufferList()));
+  XCTAssertEqual(noErr, facet.assignBufferList(stereoBuffer.mutableAudioBufferList()));
 
   facet.setChannelCount(1);
-  XCTAssertThrows(facet.assignBufferList(stereoBuffer.mutableAudioBufferList()));
+  XCTAssertEqual(kAudioUnitErr_FormatNotSupported, facet.assignBufferList(stereoBuffer.mutableAudioBufferList()));
+}
+
+- (void)testTooManyChannels {
+  BusBufferFacet facet;
+  XCTAssertEqual(noErr, facet.setChannelCount(BusBuffers::maxChannelCount));
+  XCTAssertEqual(BusBuffers::maxChannelCount, facet.channelCount());
+  XCTAssertEqual(kAudioUnitErr_FormatNotSupported, facet.setChannelCount(10));
+  XCTAssertEqual(BusBuffers::maxChannelCount, facet.channelCount());
 }
 
 - (void)testFrameCount {
@@ -117,8 +125,69 @@ static AUAudioFrameCount maxFrames = 100;
 }
 
 - (void)testUnlinked {
-  BusBufferFacet facet;
-  XCTAssertThrows(facet.unlink());
+  BasicBusBufferFacet<BufferValidation::Strict> facet;
+  facet.setChannelCount(1);
+  XCTAssertEqual(kAudioUnitErr_Uninitialized, facet.unlink());
+  XCTAssertEqual(kAudioUnitErr_Uninitialized, facet.setOffset(1));
+  XCTAssertEqual(kAudioUnitErr_Uninitialized, facet.setFrameCount(1));
+
+  BusSampleBuffer monoBuffer;
+  monoBuffer.allocate(monoFormat, maxFrames);
+  BasicBusBufferFacet<BufferValidation::Strict> destination;
+  destination.setChannelCount(1);
+  destination.assignBufferList(monoBuffer.mutableAudioBufferList());
+  XCTAssertEqual(kAudioUnitErr_Uninitialized, facet.copyInto(destination, 0, 1));
+  XCTAssertEqual(kAudioUnitErr_Uninitialized, destination.copyInto(facet, 0, 1));
+  XCTAssertEqual(noErr, destination.unlink());
+  XCTAssertFalse(destination.isLinked());
+}
+
+- (void)testInPlace {
+  BusSampleBuffer stereoBuffer;
+  stereoBuffer.allocate(stereoFormat, maxFrames);
+  BusSampleBuffer monoBuffer;
+  monoBuffer.allocate(monoFormat, maxFrames);
+
+  // A buffer list without storage from the host
+  BusSampleBuffer hostBuffer;
+  hostBuffer.allocate(stereoFormat, maxFrames);
+  auto hostList = hostBuffer.mutableAudioBufferList();
+  hostList->mBuffers[0].mData = nullptr;
+  hostList->mBuffers[1].mData = nullptr;
+
+  BasicBusBufferFacet<BufferValidation::Strict> facet;
+  facet.setChannelCount(2);
+  XCTAssertEqual(kAudioUnitErr_InvalidParameter, facet.assignBufferList(nullptr));
+  XCTAssertEqual(kAudioUnitErr_InvalidParameter, facet.assignBufferList(hostList));
+  XCTAssertFalse(facet.isLinked());
+  XCTAssertEqual(kAudioUnitErr_FormatNotSupported,
+                 facet.assignBufferList(hostList, monoBuffer.mutableAudioBufferList()));
+  XCTAssertFalse(facet.isLinked());
+
+  XCTAssertEqual(noErr, facet.assignBufferList(hostList, stereoBuffer.mutableAudioBufferList()));
+  XCTAssertTrue(facet.isLinked());
+  XCTAssertEqual(hostList->mBuffers[1].mData, stereoBuffer.mutableAudioBufferList()->mBuffers[1].mData);
+  XCTAssertEqual(facet.busBuffers()[1], stereoBuffer.mutableAudioBufferList()->mBuffers[1].mData);
+}
+
+- (void)testWithoutValidation {
+  static_assert(noexcept(BasicBusBufferFacet<BufferValidation::None>().setOffset(0)));
+  static_assert(noexcept(BasicBusBufferFacet<BufferValidation::Strict>().setOffset(0)));
+
+  BusSampleBuffer stereoBuffer;
+  stereoBuffer.allocate(stereoFormat, maxFrames);
+
+  // Nothing is checked -- the facet simply uses the channels it was told to expect.
+  BasicBusBufferFacet<BufferValidation::None> facet;
+  facet.setChannelCount(1);
+  XCTAssertEqual(noErr, facet.assignBufferList(stereoBuffer.mutableAudioBufferList()));
+  XCTAssertEqual(1, facet.channelCount());
+  XCTAssertEqual(noErr, facet.setOffset(3));
+  auto left = static_cast<AUValue*>(stereoBuffer.mutableAudioBufferList()->mBuffers[0].mData);
+  XCTAssertEqual(facet.busBuffers()[0], left + 3);
+  XCTAssertEqual(noErr, facet.setFrameCount(13));
+  XCTAssertEqual(13 * sizeof(float), stereoBuffer.mutableAudioBufferList()->mBuffers[1].mDataByteSize);
+  XCTAssertEqual(noErr, facet.unlink());
 }
 
 @end
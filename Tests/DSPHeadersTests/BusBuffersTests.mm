@@ -1,12 +1,32 @@
 // Copyright © 2021-2024 Brad Howes. All rights reserved.
 
 #import <XCTest/XCTest.h>
+#import <cmath>
+#import <memory>
+#import <span>
+#import <type_traits>
 #import <vector>
 
 #import "DSPHeaders/EventProcessor.hpp"
 
 using namespace DSPHeaders;
 
+namespace {
+
+/// Holds the sample buffers for a bus
+struct Bus {
+  Bus(size_t channelCount, size_t frameCount) : samples(channelCount, std::vector<AUValue>(frameCount)) {
+    for (auto& channel : samples) pointers.push_back(channel.data());
+  }
+
+  BusBuffers busBuffers() { return BusBuffers(pointers); }
+
+  std::vector<std::vector<AUValue>> samples;
+  std::vector<AUValue*> pointers{};
+};
+
+}
+
 @interface BufferFacetsTests : XCTestCase
 
 @end
@@ -53,15 +73,15 @@ static AUAudioFrameCount maxFrames = 100;
   BusSampleBuffer stereoBuffer;
   stereoBuffer.allocate(stereoFormat, maxFrames);
 
-  BusBufferFacet facet;
+  BasicBusBufferFacet<BufferValidation::Strict> facet;
   facet.setChannelCount(1);
-  XCTAssertNoThrow(facet.assignBufferList(monoBuffer.mutableAudioBufferList()));
+  XCTAssertEqual(noErr, facet.assignBufferList(monoBuffer.mutableAudioBufferList()));
 
   facet.setChannelCount(2);
-  XCTAssertNoThrow(facet.assignBufferList(stereoBuffer.mutableAudioBufferList()));
+  XCTAssertEqual(noErr, facet.assignBufferList(stereoBuffer.mutableAudioBufferList()));
 
   facet.setChannelCount(1);
-  XCTAssertThrows(facet.assignBufferList(stereoBuffer.mutableAudioBufferList()));
+  XCTAssertEqual(kAudioUnitErr_FormatNotSupported, facet.assignBufferList(stereoBuffer.mutableAudioBufferList()));
 }
 
 - (void)testFrameCount {
@@ -133,6 +153,191 @@ static AUAudioFrameCount maxFrames = 100;
   XCTAssertEqual(a.size(), d.size());
   BusBuffers e = d;
   XCTAssertEqual(a.size(), e.size());
+
+  BusBuffers f;
+  XCTAssertFalse(f.isValid());
+  f = a;
+  XCTAssertTrue(f.isStereo());
+  XCTAssertEqual(f[1], a[1]);
+}
+
+- (void)testValueSemantics {
+  BusSampleBuffer stereoBuffer;
+  stereoBuffer.allocate(stereoFormat, maxFrames);
+  BusBufferFacet facet;
+  facet.setChannelCount(2);
+  facet.assignBufferList(stereoBuffer.mutableAudioBufferList());
+
+  // Changes to a copy do not affect the facet or other copies.
+  BusBuffers a{facet.busBuffers()};
+  BusBuffers b{a};
+  b.shiftOver(3);
+  XCTAssertEqual(b[0], a[0] + 3);
+  XCTAssertEqual(facet.busBuffers()[0], a[0]);
+
+  // Nor do later changes to the facet affect existing copies.
+  facet.setOffset(5);
+  XCTAssertEqual(facet.busBuffers()[1], a[1] + 5);
+  XCTAssertEqual(b[1], a[1] + 3);
+}
+
+- (void)testWithChannelCount {
+  std::vector<AUValue> samples(8 * 4, 0.0);
+  std::vector<AUValue*> pointers;
+  for (size_t channel = 0; channel < 8; ++channel) pointers.push_back(samples.data() + channel * 4);
+
+  BusBuffers mono{std::span(pointers).first(1)};
+  XCTAssertFalse(mono.withChannelCount([](auto count) { return std::is_same_v<decltype(count), size_t>; }));
+  XCTAssertEqual(mono.withChannelCount([](auto count) { return size_t(count); }), 1);
+
+  BusBuffers stereo{std::span(pointers).first(2)};
+  XCTAssertFalse(stereo.withChannelCount([](auto count) { return std::is_same_v<decltype(count), size_t>; }));
+  XCTAssertEqual(stereo.withChannelCount([](auto count) { return size_t(count); }), 2);
+
+  BusBuffers surround{pointers};
+  XCTAssertEqual(surround.size(), BusBuffers::maxChannelCount);
+  XCTAssertTrue(surround.withChannelCount([](auto count) { return std::is_same_v<decltype(count), size_t>; }));
+  XCTAssertEqual(surround.withChannelCount([](auto count) { return size_t(count); }), 8);
+
+  surround.addAlternating(1, 1.0, 2.0);
+  for (size_t channel = 0; channel < 8; ++channel) XCTAssertEqual(surround[channel][1], channel % 2 ? 2.0 : 1.0);
+  stereo.addAll(2, 3.0);
+  XCTAssertEqual(samples[2], 3.0);
+  XCTAssertEqual(samples[6], 3.0);
+  XCTAssertEqual(samples[10], 0.0);
+}
+
+- (void)testBlockOperations {
+  auto source = std::make_shared<Bus>(3, 19);
+  auto destination = std::make_shared<Bus>(3, 19);
+  for (size_t channel = 0; channel < 3; ++channel) std::fill_n(source->samples[channel].begin(), 19, channel + 1.0f);
+  auto ins = source->busBuffers();
+  auto outs = destination->busBuffers();
+
+  outs.copyFrom(ins, 16, 2);
+  outs.addFrom(ins, 4);
+  outs.mixFrom(ins, 0.5, 2, 17);
+  for (size_t channel = 0; channel < 3; ++channel) {
+    auto& samples{destination->samples[channel]};
+    auto value = channel + 1.0f;
+    XCTAssertEqual(samples[0], value);
+    XCTAssertEqual(samples[1], value);
+    XCTAssertEqual(samples[2], value * 2);
+    XCTAssertEqual(samples[3], value * 2);
+    XCTAssertEqual(samples[4], value);
+    XCTAssertEqual(samples[17], value * 1.5f);
+    XCTAssertEqual(samples[18], value * 0.5f);
+  }
+
+  std::vector<AUValue> gains{1.0, 2.0, 3.0};
+  outs.applyGain(2.0, 1);
+  outs.applyGain(gains, 4);
+  outs.mixFrom(ins, gains, 8);
+  for (size_t channel = 0; channel < 3; ++channel) {
+    auto& samples{destination->samples[channel]};
+    auto value = channel + 1.0f;
+    XCTAssertEqual(samples[0], value * 2);
+    XCTAssertEqual(samples[1], value);
+    XCTAssertEqual(samples[4], value);
+    XCTAssertEqual(samples[5], value * 2);
+    XCTAssertEqual(samples[6], value * 3);
+    XCTAssertEqual(samples[8], value * 2);
+    XCTAssertEqual(samples[9], value * 3);
+    XCTAssertEqual(samples[10], value * 4);
+  }
+}
+
+- (void)testGainRamp {
+  auto bus = std::make_shared<Bus>(2, 20);
+  for (auto& channel : bus->samples) std::fill(channel.begin(), channel.end(), 1.0f);
+  auto outs = bus->busBuffers();
+  outs.applyGainRamp(1.0, 0.0, 10);
+  outs.applyGainRamp(0.0, 0.5, 10, 10);
+  for (auto& channel : bus->samples) {
+    for (size_t frame = 0; frame < 10; ++frame) {
+      XCTAssertEqualWithAccuracy(channel[frame], 1.0 - frame / 10.0, 1.0e-6);
+      XCTAssertEqualWithAccuracy(channel[frame + 10], 0.05 * frame, 1.0e-6);
+    }
+  }
+}
+
+- (void)testPanAndMidSide {
+  auto bus = std::make_shared<Bus>(2, 9);
+  auto outs = bus->busBuffers();
+  std::vector<AUValue> mono(9, 1.0);
+
+  outs.panFrom(mono.data(), 0.0, 9);
+  XCTAssertEqualWithAccuracy(bus->samples[0][8], std::sqrt(0.5), 1.0e-6);
+  XCTAssertEqualWithAccuracy(bus->samples[1][8], std::sqrt(0.5), 1.0e-6);
+  outs.panFrom(mono.data(), -1.0, 9);
+  XCTAssertEqualWithAccuracy(bus->samples[0][0], 1.0, 1.0e-6);
+  XCTAssertEqualWithAccuracy(bus->samples[1][0], 0.0, 1.0e-6);
+  outs.panFrom(mono.data(), 1.0, 4, 5);
+  XCTAssertEqualWithAccuracy(bus->samples[0][5], 0.0, 1.0e-6);
+  XCTAssertEqualWithAccuracy(bus->samples[1][5], 1.0, 1.0e-6);
+  XCTAssertEqualWithAccuracy(bus->samples[0][4], 1.0, 1.0e-6);
+
+  for (size_t frame = 0; frame < 9; ++frame) {
+    bus->samples[0][frame] = 1.0f + frame;
+    bus->samples[1][frame] = 0.5f * frame;
+  }
+  outs.encodeMidSide(9);
+  XCTAssertEqual(bus->samples[0][2], (3.0 + 1.0) / 2);
+  XCTAssertEqual(bus->samples[1][2], (3.0 - 1.0) / 2);
+  outs.decodeMidSide(9);
+  for (size_t frame = 0; frame < 9; ++frame) {
+    XCTAssertEqual(bus->samples[0][frame], 1.0f + frame);
+    XCTAssertEqual(bus->samples[1][frame], 0.5f * frame);
+  }
+}
+
+- (void)testPerFrameMixSpeed {
+  auto source = std::make_shared<Bus>(2, 512);
+  auto destination = std::make_shared<Bus>(2, 512);
+  [self measureBlock:^{
+    auto ins = source->busBuffers();
+    auto outs = destination->busBuffers();
+    for (int iteration = 0; iteration < 10'000; ++iteration) {
+      for (AUAudioFrameCount frame = 0; frame < 512; ++frame) {
+        outs.addStereo(frame, ins[0][frame] * 0.5f, ins[1][frame] * 0.5f);
+      }
+    }
+  }];
+}
+
+- (void)testBlockMixSpeed {
+  auto source = std::make_shared<Bus>(2, 512);
+  auto destination = std::make_shared<Bus>(2, 512);
+  [self measureBlock:^{
+    auto ins = source->busBuffers();
+    auto outs = destination->busBuffers();
+    for (int iteration = 0; iteration < 10'000; ++iteration) {
+      outs.mixFrom(ins, 0.5, 512);
+    }
+  }];
+}
+
+- (void)testPerFrameGainRampSpeed {
+  auto bus = std::make_shared<Bus>(2, 512);
+  [self measureBlock:^{
+    auto outs = bus->busBuffers();
+    for (int iteration = 0; iteration < 10'000; ++iteration) {
+      for (AUAudioFrameCount frame = 0; frame < 512; ++frame) {
+        auto gain = 1.0f - frame / 512.0f;
+        outs.addStereo(frame, outs[0][frame] * (gain - 1.0f), outs[1][frame] * (gain - 1.0f));
+      }
+    }
+  }];
+}
+
+- (void)testBlockGainRampSpeed {
+  auto bus = std::make_shared<Bus>(2, 512);
+  [self measureBlock:^{
+    auto outs = bus->busBuffers();
+    for (int iteration = 0; iteration < 10'000; ++iteration) {
+      outs.applyGainRamp(1.0, 0.0, 512);
+    }
+  }];
 }
 
 @end
@@ -0,0 +1,118 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <cmath>
+#import <memory>
+
+#import "DSPHeaders/BusMeter.hpp"
+#import "DSPHeaders/BusSampleBuffer.hpp"
+
+using namespace DSPHeaders;
+
+@interface BusMeterTests : XCTestCase
+@end
+
+namespace {
+
+// Stereo buffer to measure. The left channel alternates between +/- a level, and the right channel holds a ramp.
+struct Fixture {
+  Fixture() {
+    AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:1000.0 channels:2];
+    buffer.allocate(format, 512);
+    facet.setChannelCount(2);
+    facet.assignBufferList(buffer.mutableAudioBufferList());
+  }
+
+  void fill(AUAudioFrameCount frameCount, AUValue left, AUValue right) {
+    auto bufferList = buffer.mutableAudioBufferList();
+    auto leftSamples = static_cast<AUValue*>(bufferList->mBuffers[0].mData);
+    auto rightSamples = static_cast<AUValue*>(bufferList->mBuffers[1].mData);
+    for (AUAudioFrameCount frame = 0; frame < frameCount; ++frame) {
+      leftSamples[frame] = frame % 2 ? left : -left;
+      rightSamples[frame] = right * AUValue(frame);
+    }
+  }
+
+  BusSampleBuffer buffer;
+  BusBufferFacet facet;
+};
+
+}
+
+@implementation BusMeterTests
+
+- (void)testPeakAndRMS {
+  Fixture fixture;
+  BusMeter meter;
+  meter.configure(1000.0, 2, 0.1);
+  fixture.fill(64, 0.5, 0.0);
+  meter.process(fixture.facet, 64);
+  XCTAssertEqual(meter.read().sequence, 0);
+  XCTAssertEqual(meter.read().channelCount, 0);
+
+  // Window of 100 frames is done after the second buffer
+  fixture.fill(64, 0.25, 0.0);
+  meter.process(fixture.facet, 64);
+  auto& reading = meter.read();
+  XCTAssertEqual(reading.channelCount, 2);
+  XCTAssertEqual(reading.sequence, 0);
+  XCTAssertEqualWithAccuracy(reading.peak[0], 0.5, 1.0e-6);
+  XCTAssertEqualWithAccuracy(reading.rms[0], std::sqrt((64 * 0.25 + 64 * 0.0625) / 128.0), 1.0e-6);
+  XCTAssertEqual(reading.peak[1], 0.0);
+  XCTAssertEqual(reading.rms[1], 0.0);
+  XCTAssertEqual(reading.scopeLength, 0);
+
+  // Next window starts from scratch
+  fixture.fill(100, 0.125, 0.0);
+  meter.process(fixture.facet, 100);
+  XCTAssertEqual(meter.read().sequence, 1);
+  XCTAssertEqualWithAccuracy(meter.read().peak[0], 0.125, 1.0e-6);
+  XCTAssertEqualWithAccuracy(meter.read().rms[0], 0.125, 1.0e-6);
+}
+
+- (void)testScope {
+  Fixture fixture;
+  BusMeter meter;
+  meter.configure(1000.0, 2, 0.001, 4);
+  fixture.fill(10, 0.0, 1.0);
+  meter.process(fixture.facet, 10);
+  auto& reading = meter.read();
+  XCTAssertEqual(reading.scopeLength, 3);
+  XCTAssertEqual(reading.scope[1][0], 0.0);
+  XCTAssertEqual(reading.scope[1][1], 4.0);
+  XCTAssertEqual(reading.scope[1][2], 8.0);
+
+  // Decimation continues across buffers: next sample is the 2nd one of the next buffer.
+  fixture.fill(10, 0.0, 1.0);
+  meter.process(fixture.facet, 10);
+  XCTAssertEqual(meter.read().scopeLength, 5);
+  XCTAssertEqual(meter.read().scope[1][3], 2.0);
+  XCTAssertEqual(meter.read().scope[1][4], 6.0);
+}
+
+- (void)testScopeWraps {
+  Fixture fixture;
+  BusMeter meter;
+  meter.configure(1000.0, 2, 0.5, 1);
+  for (int pass = 0; pass < 2; ++pass) {
+    fixture.fill(300, 0.0, 1.0);
+    meter.process(fixture.facet, 300);
+  }
+  auto& reading = meter.read();
+  XCTAssertEqual(reading.scopeLength, BusMeter::scopeSize);
+  for (size_t index = 0; index < BusMeter::scopeSize; ++index) {
+    XCTAssertEqual(reading.scope[1][index], AUValue(300 - BusMeter::scopeSize + index));
+  }
+}
+
+- (void)testProcessSpeed {
+  auto fixture = std::make_shared<Fixture>();
+  auto meter = std::make_shared<BusMeter>();
+  meter->configure(48000.0, 2, 0.05);
+  fixture->fill(512, 0.5, 0.001);
+  [self measureBlock:^{
+    for (int iteration = 0; iteration < 100'000; ++iteration) meter->process(fixture->facet, 512);
+  }];
+}
+
+@end
@@ -3,6 +3,7 @@
 #import <XCTest/XCTest.h>
 #import <cmath>
 #import <iostream>
+#import <vector>
 #import "DSPHeaders/DSP.hpp"
 
 using namespace DSPHeaders;
@@ -139,6 +140,43 @@ using namespace DSPHeaders;
   XCTAssertEqualWithAccuracy(-0.000487328, w4[3], 1.0E-6);
 }
 
+- (void)testIsSilent {
+  std::vector<float> samples(1000, 0.0);
+  XCTAssertTrue(DSP::isSilent(samples.data(), 0));
+  XCTAssertTrue(DSP::isSilent(samples.data(), samples.size()));
+  samples[3] = -0.0;
+  XCTAssertTrue(DSP::isSilent(samples.data(), samples.size()));
+  samples[999] = 1.0e-30f;
+  XCTAssertFalse(DSP::isSilent(samples.data(), samples.size()));
+  XCTAssertTrue(DSP::isSilent(samples.data(), 999));
+  samples[17] = -1.0;
+  XCTAssertFalse(DSP::isSilent(samples.data(), 18));
+  XCTAssertTrue(DSP::isSilent(samples.data(), 17));
+}
+
+- (void)testIsSilentSpeed {
+  std::vector<float> samples(512, 0.0);
+  [self measureBlock:^{
+    bool silent = true;
+    for (int iteration = 0; iteration < 100'000; ++iteration) {
+      silent = DSP::isSilent(samples.data(), samples.size()) && silent;
+    }
+    XCTAssertTrue(silent);
+  }];
+}
+
+- (void)testPeakAndSumOfSquares {
+  std::vector<float> samples(21, 0.5);
+  samples[13] = -0.75;
+  auto [peak, sum] = DSP::peakAndSumOfSquares(samples.data(), samples.size());
+  XCTAssertEqual(peak, 0.75);
+  XCTAssertEqualWithAccuracy(sum, 20 * 0.25 + 0.5625, 1.0e-6);
+
+  auto [emptyPeak, emptySum] = DSP::peakAndSumOfSquares(samples.data(), 0);
+  XCTAssertEqual(emptyPeak, 0.0);
+  XCTAssertEqual(emptySum, 0.0);
+}
+
 //- (void)testZZZ {
 //  for (float modulator = -1.0; modulator <= 1.0; modulator += 0.1) {
 //    auto a = DSP::unipolarModulation<float>(DSP::bipolarToUnipolar<float>(modulator), 0.0, 10.0);
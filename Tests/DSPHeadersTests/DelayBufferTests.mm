@@ -3,12 +3,26 @@
 #import <XCTest/XCTest.h>
 #import <iomanip>
 #import <iostream>
+#import <memory>
 #import <vector>
 
 #import "DSPHeaders/DelayBuffer.hpp"
 
 using namespace DSPHeaders;
 
+namespace {
+
+std::vector<float> makeInput(size_t count) {
+  std::vector<float> input(count);
+  for (size_t index = 0; index < count; ++index) input[index] = std::sin(index * 0.1f) + 0.01f * index;
+  return input;
+}
+
+/// Number of frames to use in the speed tests.
+constexpr size_t blockSize = 512;
+
+}
+
 @interface DelayBufferTests : XCTestCase
 @end
 
@@ -110,4 +124,111 @@ static float epsilon = 1.0E-7;
   XCTAssertEqualWithAccuracy(buffer.read(1.9), 0.995195654919, epsilon);
 }
 
+- (void)testWriteBlock {
+  auto input = makeInput(50);
+  for (size_t blockSize : {1, 3, 7, 16, 40}) {
+    DelayBuffer<float> blocked(16);
+    DelayBuffer<float> single(16);
+    for (size_t start = 0; start < input.size(); start += blockSize) {
+      auto count = std::min(blockSize, input.size() - start);
+      blocked.writeBlock(std::span(input).subspan(start, count));
+      for (size_t index = 0; index < count; ++index) single.write(input[start + index]);
+      for (ssize_t offset = 0; offset < 16; ++offset) {
+        XCTAssertEqual(blocked.readFromOffset(offset), single.readFromOffset(offset));
+      }
+    }
+  }
+}
+
+- (void)testReadBlockFixedDelay {
+  auto input = makeInput(200);
+  for (auto kind : {DelayBuffer<float>::Interpolator::linear, DelayBuffer<float>::Interpolator::cubic4thOrder}) {
+    for (float delay : {0.0f, 1.0f, 5.0f, 0.25f, 3.5f, 17.8f}) {
+      DelayBuffer<float> blocked(64, kind);
+      DelayBuffer<float> single(64, kind);
+      std::vector<float> output(13);
+      // The block size does not divide the buffer size, so the blocks will straddle the wrap point.
+      for (size_t start = 0; start + output.size() <= input.size(); start += output.size()) {
+        auto block = std::span(input).subspan(start, output.size());
+        blocked.writeBlock(block);
+        blocked.readBlock(output, delay);
+        for (size_t index = 0; index < output.size(); ++index) {
+          single.write(block[index]);
+          XCTAssertEqualWithAccuracy(output[index], single.read(delay), 1.0e-6);
+        }
+      }
+    }
+  }
+}
+
+- (void)testReadBlockAfterWrapPoint {
+  auto input = makeInput(32);
+  // Every start position is tried, so each policy has blocks whose newest tap is just past the wrap point and whose
+  // older taps come from the end of the buffer.
+  for (auto kind : {DelayBuffer<float>::Interpolator::linear, DelayBuffer<float>::Interpolator::hermite,
+    DelayBuffer<float>::Interpolator::lagrange3, DelayBuffer<float>::Interpolator::lagrange5}) {
+    for (size_t offset = 0; offset < 16; ++offset) {
+      DelayBuffer<float> buffer(16, kind);
+      buffer.writeBlock(std::span(input).subspan(0, 16 + offset));
+      std::vector<float> output(8);
+      std::vector<float> expected(8);
+      std::vector<float> delays(8, 2.5f);
+      buffer.readBlock(output, 2.5f);
+      buffer.readBlock(expected, delays);
+      for (size_t index = 0; index < output.size(); ++index) {
+        XCTAssertEqualWithAccuracy(output[index], expected[index], 1.0e-6);
+      }
+    }
+  }
+}
+
+- (void)testReadBlockModulatedDelay {
+  auto input = makeInput(200);
+  for (auto kind : {DelayBuffer<float>::Interpolator::linear, DelayBuffer<float>::Interpolator::cubic4thOrder}) {
+    DelayBuffer<float> blocked(64, kind);
+    DelayBuffer<float> single(64, kind);
+    std::vector<float> output(13);
+    std::vector<float> delays(output.size());
+    for (size_t start = 0; start + output.size() <= input.size(); start += output.size()) {
+      for (size_t index = 0; index < delays.size(); ++index) {
+        delays[index] = 10.0f + 8.0f * std::sin((start + index) * 0.05f);
+      }
+      delays[0] = 4.0f;
+      auto block = std::span(input).subspan(start, output.size());
+      blocked.writeBlock(block);
+      blocked.readBlock(output, delays);
+      for (size_t index = 0; index < output.size(); ++index) {
+        single.write(block[index]);
+        XCTAssertEqualWithAccuracy(output[index], single.read(delays[index]), 1.0e-6);
+      }
+    }
+  }
+}
+
+- (void)testPerSampleEchoSpeed {
+  auto input = std::make_shared<std::vector<float>>(makeInput(blockSize));
+  auto output = std::make_shared<std::vector<float>>(blockSize);
+  auto buffer = std::make_shared<DelayBuffer<float>>(8192);
+  [self measureBlock:^{
+    for (int iteration = 0; iteration < 20'000; ++iteration) {
+      for (size_t index = 0; index < blockSize; ++index) {
+        buffer->write((*input)[index]);
+        (*output)[index] = buffer->read(4410.5f);
+      }
+    }
+  }];
+}
+
+- (void)testBlockEchoSpeed {
+  auto input = std::make_shared<std::vector<float>>(makeInput(blockSize));
+  auto output = std::make_shared<std::vector<float>>(blockSize);
+  auto buffer = std::make_shared<DelayBuffer<float>>(8192);
+  [self measureBlock:^{
+    for (int iteration = 0; iteration < 20'000; ++iteration) {
+      buffer->writeBlock(*input);
+      buffer->readBlock(*output, 4410.5f);
+    }
+  }];
+}
+
 @end
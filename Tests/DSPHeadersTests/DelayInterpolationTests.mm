@@ -0,0 +1,240 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <cmath>
+#import <iomanip>
+#import <iostream>
+#import <memory>
+#import <numbers>
+#import <string>
+#import <vector>
+
+#import "DSPHeaders/DelayBuffer.hpp"
+
+using namespace DSPHeaders;
+using namespace DSPHeaders::DelayInterpolation;
+
+namespace {
+
+/// Normalized frequencies (cycles per sample) used in the accuracy table.
+constexpr std::array<double, 6> frequencies{0.01, 0.05, 0.1, 0.2, 0.3, 0.4};
+
+/**
+ Obtain the largest error of a policy when delaying a sine by a fractional amount.
+
+ @param frequency the normalized frequency of the sine
+ @param latency extra delay of the policy in samples
+ @returns the largest absolute error seen
+ */
+template <typename Policy>
+double maxError(double frequency, double latency = 0.0) {
+  constexpr double delay = 10.37;
+  constexpr size_t settle = 200;
+  DelayBuffer<double, Policy> buffer(64);
+  double error = 0.0;
+  for (size_t frame = 0; frame < settle + 1000; ++frame) {
+    buffer.write(std::sin(2.0 * std::numbers::pi * frequency * frame));
+    auto value = buffer.read(delay);
+    auto expected = std::sin(2.0 * std::numbers::pi * frequency * (frame - delay - latency));
+    if (frame >= settle) error = std::max(error, std::abs(value - expected));
+  }
+  return error;
+}
+
+template <typename Policy>
+std::array<double, frequencies.size()> errorRow(double latency = 0.0) {
+  std::array<double, frequencies.size()> row;
+  for (size_t index = 0; index < frequencies.size(); ++index) {
+    row[index] = maxError<Policy>(frequencies[index], latency);
+  }
+  return row;
+}
+
+template <typename Policy>
+void modulatedReads(DelayBuffer<float, Policy>& buffer, const std::vector<float>& input,
+                    const std::vector<float>& delays, std::vector<float>& output) {
+  for (int iteration = 0; iteration < 5'000; ++iteration) {
+    buffer.writeBlock(input);
+    buffer.readBlock(output, delays);
+  }
+}
+
+/// Number of frames to use in the speed tests.
+constexpr size_t blockSize = 512;
+
+std::vector<float> makeSignal(size_t count, float scale, float offset) {
+  std::vector<float> values(count);
+  for (size_t index = 0; index < count; ++index) values[index] = offset + scale * std::sin(index * 0.01f);
+  return values;
+}
+
+}
+
+@interface DelayInterpolationTests : XCTestCase
+@end
+
+@implementation DelayInterpolationTests
+
+- (void)testWeightsAtNodes {
+  // With no fractional part the weights select the sample at `whole`.
+  auto check = [&](auto weights, size_t newer) {
+    for (size_t tap = 0; tap < weights.size(); ++tap) {
+      XCTAssertEqualWithAccuracy(weights[tap], tap == newer ? 1.0 : 0.0, 1.0e-12);
+    }
+  };
+  check(Linear::weights(0.0), Linear::newer);
+  check(Hermite::weights(0.0), Hermite::newer);
+  check(Lagrange3::weights(0.0), Lagrange3::newer);
+  check(Lagrange5::weights(0.0), Lagrange5::newer);
+  check(WindowedSinc<>::weights(0.0), WindowedSinc<>::newer);
+}
+
+- (void)testWeightsSumToOne {
+  for (double partial : {0.1, 0.25, 0.5, 0.77, 0.999}) {
+    auto sum = [](auto weights) { double sum = 0.0; for (auto weight : weights) sum += weight; return sum; };
+    XCTAssertEqualWithAccuracy(sum(Linear::weights(partial)), 1.0, 1.0e-12);
+    XCTAssertEqualWithAccuracy(sum(Cubic4thOrder::weights(partial)), 1.0, 1.0e-12);
+    XCTAssertEqualWithAccuracy(sum(Hermite::weights(partial)), 1.0, 1.0e-12);
+    XCTAssertEqualWithAccuracy(sum(Lagrange3::weights(partial)), 1.0, 1.0e-12);
+    XCTAssertEqualWithAccuracy(sum(Lagrange5::weights(partial)), 1.0, 1.0e-12);
+    XCTAssertEqualWithAccuracy(sum(WindowedSinc<>::weights(partial)), 1.0, 1.0e-12);
+  }
+}
+
+- (void)testLagrangeIsExactForPolynomials {
+  DelayBuffer<double, Lagrange3> cubic(32);
+  DelayBuffer<double, Lagrange5> quintic(32);
+  auto poly3 = [](double x) { return 0.001 * x * x * x - 0.02 * x * x + 0.3 * x - 1.0; };
+  auto poly5 = [&](double x) { return 1.0e-6 * x * x * x * x * x - 2.0e-5 * x * x * x * x + poly3(x); };
+  for (int frame = 0; frame < 20; ++frame) {
+    cubic.write(poly3(frame));
+    quintic.write(poly5(frame));
+  }
+  for (double delay : {2.1, 3.5, 7.9}) {
+    XCTAssertEqualWithAccuracy(cubic.read(delay), poly3(19 - delay), 1.0e-9);
+    XCTAssertEqualWithAccuracy(quintic.read(delay), poly5(19 - delay), 1.0e-9);
+  }
+}
+
+- (void)testThiranDelaysSine {
+  DelayBuffer<double, Thiran> buffer(64);
+  for (int frame = 0; frame < 100; ++frame) buffer.write(std::sin(0.05 * frame));
+  buffer.clear();
+  XCTAssertEqual(buffer.read(4.5), 0.0);
+  XCTAssertLessThan(maxError<Thiran>(0.01), 1.0e-4);
+}
+
+- (void)testRuntimeMatchesPolicies {
+  DelayBuffer<float> runtime(64, DelayBuffer<float>::Interpolator::lagrange5);
+  DelayBuffer<float, Lagrange5> fixed(64);
+  std::vector<float> output(16);
+  for (int frame = 0; frame < 50; ++frame) {
+    runtime.write(std::sin(0.1f * frame));
+    fixed.write(std::sin(0.1f * frame));
+  }
+  XCTAssertEqual(runtime.read(7.3), fixed.read(7.3));
+  runtime.readBlock(output, 3.7f);
+  std::vector<float> expected(16);
+  fixed.readBlock(expected, 3.7f);
+  XCTAssertEqual(output, expected);
+}
+
+- (void)testAccuracyTable {
+  std::vector<std::pair<std::string, std::array<double, frequencies.size()>>> rows{
+    {"linear", errorRow<Linear>()},
+    {"cubic4thOrder (+1)", errorRow<Cubic4thOrder>(1.0)},
+    {"hermite", errorRow<Hermite>()},
+    {"lagrange3", errorRow<Lagrange3>()},
+    {"lagrange5", errorRow<Lagrange5>()},
+    {"thiran", errorRow<Thiran>()},
+    {"windowedSinc", errorRow<WindowedSinc<>>()}
+  };
+
+  std::cout << "max error (dB) for a delay of 10.37 samples at normalized frequency\n" << std::setw(20) << "";
+  for (auto frequency : frequencies) std::cout << std::setw(8) << frequency;
+  std::cout << '\n' << std::fixed << std::setprecision(1);
+  for (const auto& [name, errors] : rows) {
+    std::cout << std::setw(20) << name;
+    for (auto error : errors) std::cout << std::setw(8) << 20.0 * std::log10(error);
+    std::cout << '\n';
+  }
+  std::cout << std::defaultfloat;
+
+  // At low frequencies the higher-order polynomials are better, and the sinc kernel wins at high frequencies.
+  const auto& linear{rows[0].second};
+  const auto& hermite{rows[2].second};
+  const auto& lagrange3{rows[3].second};
+  const auto& lagrange5{rows[4].second};
+  const auto& sinc{rows[6].second};
+  XCTAssertLessThan(hermite[0], linear[0]);
+  XCTAssertLessThan(lagrange3[0], hermite[0]);
+  XCTAssertLessThan(lagrange5[0], lagrange3[0]);
+  XCTAssertLessThan(sinc[4], lagrange5[4]);
+  XCTAssertLessThan(sinc[4], linear[4]);
+}
+
+- (void)testRuntimeLinearSpeed {
+  auto buffer = std::make_shared<DelayBuffer<float>>(8192);
+  auto input = std::make_shared<std::vector<float>>(makeSignal(blockSize, 1.0, 0.0));
+  auto delays = std::make_shared<std::vector<float>>(makeSignal(blockSize, 100.0, 1000.0));
+  auto output = std::make_shared<std::vector<float>>(blockSize);
+  [self measureBlock:^{ modulatedReads(*buffer, *input, *delays, *output); }];
+}
+
+- (void)testLinearSpeed {
+  auto buffer = std::make_shared<DelayBuffer<float, Linear>>(8192);
+  auto input = std::make_shared<std::vector<float>>(makeSignal(blockSize, 1.0, 0.0));
+  auto delays = std::make_shared<std::vector<float>>(makeSignal(blockSize, 100.0, 1000.0));
+  auto output = std::make_shared<std::vector<float>>(blockSize);
+  [self measureBlock:^{ modulatedReads(*buffer, *input, *delays, *output); }];
+}
+
+- (void)testCubic4thOrderSpeed {
+  auto buffer = std::make_shared<DelayBuffer<float, Cubic4thOrder>>(8192);
+  auto input = std::make_shared<std::vector<float>>(makeSignal(blockSize, 1.0, 0.0));
+  auto delays = std::make_shared<std::vector<float>>(makeSignal(blockSize, 100.0, 1000.0));
+  auto output = std::make_shared<std::vector<float>>(blockSize);
+  [self measureBlock:^{ modulatedReads(*buffer, *input, *delays, *output); }];
+}
+
+- (void)testHermiteSpeed {
+  auto buffer = std::make_shared<DelayBuffer<float, Hermite>>(8192);
+  auto input = std::make_shared<std::vector<float>>(makeSignal(blockSize, 1.0, 0.0));
+  auto delays = std::make_shared<std::vector<float>>(makeSignal(blockSize, 100.0, 1000.0));
+  auto output = std::make_shared<std::vector<float>>(blockSize);
+  [self measureBlock:^{ modulatedReads(*buffer, *input, *delays, *output); }];
+}
+
+- (void)testLagrange3Speed {
+  auto buffer = std::make_shared<DelayBuffer<float, Lagrange3>>(8192);
+  auto input = std::make_shared<std::vector<float>>(makeSignal(blockSize, 1.0, 0.0));
+  auto delays = std::make_shared<std::vector<float>>(makeSignal(blockSize, 100.0, 1000.0));
+  auto output = std::make_shared<std::vector<float>>(blockSize);
+  [self measureBlock:^{ modulatedReads(*buffer, *input, *delays, *output); }];
+}
+
+- (void)testLagrange5Speed {
+  auto buffer = std::make_shared<DelayBuffer<float, Lagrange5>>(8192);
+  auto input = std::make_shared<std::vector<float>>(makeSignal(blockSize, 1.0, 0.0));
+  auto delays = std::make_shared<std::vector<float>>(makeSignal(blockSize, 100.0, 1000.0));
+  auto output = std::make_shared<std::vector<float>>(blockSize);
+  [self measureBlock:^{ modulatedReads(*buffer, *input, *delays, *output); }];
+}
+
+- (void)testThiranSpeed {
+  auto buffer = std::make_shared<DelayBuffer<float, Thiran>>(8192);
+  auto input = std::make_shared<std::vector<float>>(makeSignal(blockSize, 1.0, 0.0));
+  auto delays = std::make_shared<std::vector<float>>(makeSignal(blockSize, 100.0, 1000.0));
+  auto output = std::make_shared<std::vector<float>>(blockSize);
+  [self measureBlock:^{ modulatedReads(*buffer, *input, *delays, *output); }];
+}
+
+- (void)testWindowedSincSpeed {
+  auto buffer = std::make_shared<DelayBuffer<float, WindowedSinc<>>>(8192);
+  auto input = std::make_shared<std::vector<float>>(makeSignal(blockSize, 1.0, 0.0));
+  auto delays = std::make_shared<std::vector<float>>(makeSignal(blockSize, 100.0, 1000.0));
+  auto output = std::make_shared<std::vector<float>>(blockSize);
+  [self measureBlock:^{ modulatedReads(*buffer, *input, *delays, *output); }];
+}
+
+@end
@@ -0,0 +1,151 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <cmath>
+#import <memory>
+#import <vector>
+
+#import "DSPHeaders/DelayBuffer.hpp"
+
+using namespace DSPHeaders;
+
+namespace {
+
+std::vector<float> makeInput(size_t count) {
+  std::vector<float> input(count);
+  for (size_t index = 0; index < count; ++index) input[index] = std::sin(index * 0.1f) + 0.01f * index;
+  return input;
+}
+
+/// Number of frames to use in the speed tests.
+constexpr size_t blockSize = 512;
+
+/// Tap settings for an 8-tap echo
+constexpr std::array<float, 8> echoDelays{441.0f, 1002.5f, 1523.25f, 2205.0f, 2871.75f, 3307.5f, 3969.1f, 4410.0f};
+constexpr std::array<float, 8> echoGains{0.9f, 0.8f, 0.7f, 0.6f, 0.5f, 0.4f, 0.3f, 0.2f};
+
+}
+
+@interface DelayTapsTests : XCTestCase
+@end
+
+@implementation DelayTapsTests
+
+- (void)testRamp {
+  DelayTaps<float, 2> taps({10.0f, 20.0f}, {1.0f, 0.5f});
+  XCTAssertEqual(taps.size(), 2);
+  XCTAssertEqual(taps[1].delay, 20.0f);
+  XCTAssertEqual(taps[1].gain, 0.5f);
+  XCTAssertFalse(taps[0].isRamping());
+
+  taps.rampDelay(0, 14.0f, 4);
+  XCTAssertTrue(taps[0].isRamping());
+  for (float expected : {10.0f, 11.0f, 12.0f, 13.0f}) {
+    XCTAssertEqual(taps[0].delay, expected);
+    taps[0].advance();
+  }
+  XCTAssertFalse(taps[0].isRamping());
+  XCTAssertEqual(taps[0].delay, 14.0f);
+
+  taps.rampDelay(1, 5.0f, 0);
+  XCTAssertFalse(taps[1].isRamping());
+  XCTAssertEqual(taps[1].delay, 5.0f);
+
+  taps.rampDelay(1, 8.0f, 10);
+  taps.setDelay(1, 3.0f);
+  XCTAssertFalse(taps[1].isRamping());
+  XCTAssertEqual(taps[1].delay, 3.0f);
+}
+
+- (void)testSummedTaps {
+  auto input = makeInput(300);
+  for (auto kind : {DelayBuffer<float>::Interpolator::linear, DelayBuffer<float>::Interpolator::hermite}) {
+    DelayBuffer<float> buffer(64, kind);
+    DelayTaps<float, 4> taps({0.0f, 3.0f, 7.25f, 30.5f}, {1.0f, -0.5f, 0.25f, 2.0f});
+    std::vector<float> output(13);
+    std::vector<float> single(13);
+    for (size_t start = 0; start + output.size() <= input.size(); start += output.size()) {
+      buffer.writeBlock(std::span(input).subspan(start, output.size()));
+      buffer.readTaps(taps, output);
+      std::vector<float> expected(output.size(), 0.0f);
+      for (size_t tap = 0; tap < taps.size(); ++tap) {
+        buffer.readBlock(single, taps[tap].delay);
+        for (size_t index = 0; index < output.size(); ++index) expected[index] += taps[tap].gain * single[index];
+      }
+      for (size_t index = 0; index < output.size(); ++index) {
+        XCTAssertEqualWithAccuracy(output[index], expected[index], 1.0e-5);
+      }
+    }
+  }
+}
+
+- (void)testSeparateTaps {
+  auto input = makeInput(100);
+  DelayBuffer<float> buffer(64, DelayBuffer<float>::Interpolator::lagrange3);
+  DelayTaps<float, 3> taps({1.0f, 4.5f, 9.8f}, {1.0f, 0.5f, -1.0f});
+  std::vector<std::vector<float>> outputs(3, std::vector<float>(20));
+  std::vector<float*> pointers{outputs[0].data(), outputs[1].data(), outputs[2].data()};
+  std::vector<float> single(20);
+  buffer.writeBlock(std::span(input).subspan(0, 50));
+  buffer.writeBlock(std::span(input).subspan(50, 20));
+  buffer.readTaps(taps, pointers, 20);
+  for (size_t tap = 0; tap < taps.size(); ++tap) {
+    buffer.readBlock(single, taps[tap].delay);
+    for (size_t index = 0; index < single.size(); ++index) {
+      XCTAssertEqualWithAccuracy(outputs[tap][index], taps[tap].gain * single[index], 1.0e-6);
+    }
+  }
+}
+
+- (void)testRampingTaps {
+  auto input = makeInput(200);
+  DelayBuffer<float> buffer(64);
+  DelayBuffer<float> reference(64);
+  DelayTaps<float, 2> taps({5.0f, 10.0f}, {1.0f, 0.5f});
+  taps.rampDelay(0, 15.0f, 40);
+  std::array<float, 2> delays{5.0f, 10.0f};
+  std::vector<float> output(16);
+  for (size_t start = 0; start + output.size() <= input.size(); start += output.size()) {
+    buffer.writeBlock(std::span(input).subspan(start, output.size()));
+    buffer.readTaps(taps, output);
+    for (size_t index = 0; index < output.size(); ++index) {
+      reference.write(input[start + index]);
+      auto expected = reference.read(delays[0]) + 0.5f * reference.read(delays[1]);
+      XCTAssertEqualWithAccuracy(output[index], expected, 1.0e-5);
+      if (start + index < 40) delays[0] += 0.25f;
+    }
+  }
+  XCTAssertFalse(taps[0].isRamping());
+  XCTAssertEqual(taps[0].delay, 15.0f);
+}
+
+- (void)testPerSampleTapsSpeed {
+  auto input = std::make_shared<std::vector<float>>(makeInput(blockSize));
+  auto output = std::make_shared<std::vector<float>>(blockSize);
+  auto buffer = std::make_shared<DelayBuffer<float>>(8192);
+  [self measureBlock:^{
+    for (int iteration = 0; iteration < 2'000; ++iteration) {
+      for (size_t index = 0; index < blockSize; ++index) {
+        buffer->write((*input)[index]);
+        float sum = 0.0f;
+        for (size_t tap = 0; tap < echoDelays.size(); ++tap) sum += echoGains[tap] * buffer->read(echoDelays[tap]);
+        (*output)[index] = sum;
+      }
+    }
+  }];
+}
+
+- (void)testBlockTapsSpeed {
+  auto input = std::make_shared<std::vector<float>>(makeInput(blockSize));
+  auto output = std::make_shared<std::vector<float>>(blockSize);
+  auto buffer = std::make_shared<DelayBuffer<float>>(8192);
+  auto taps = std::make_shared<DelayTaps<float, 8>>(echoDelays, echoGains);
+  [self measureBlock:^{
+    for (int iteration = 0; iteration < 2'000; ++iteration) {
+      buffer->writeBlock(*input);
+      buffer->readTaps(*taps, *output);
+    }
+  }];
+}
+
+@end
@@ -303,6 +303,29 @@ AURenderPullInputBlock mockPullInput = ^(AudioUnitRenderActionFlags* actionFlags
   XCTAssertEqual(self.effect->frameCounts_[1], 10);
 }
 
+- (void)testZeroLengthRampEvent {
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+  AudioTimeStamp timestamp = AudioTimeStamp();
+  AVAudioPCMBuffer* buffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *outputData = [buffer mutableAudioBufferList];
+
+  AUParameterEvent* rampingEvent = new AUParameterEvent();
+  rampingEvent->next = nullptr;
+  rampingEvent->eventSampleTime = -1;
+  rampingEvent->parameterAddress = 1;
+  rampingEvent->rampDurationSampleFrames = 0;
+  rampingEvent->value = 10;
+
+  AURenderEvent* eventList = reinterpret_cast<AURenderEvent*>(rampingEvent);
+  eventList->head.eventType = AURenderEventParameterRamp;
+
+  XCTAssertEqual(self.effect->processAndRender(&timestamp, 8, 0, outputData, eventList, mockPullInput), 0);
+  XCTAssertEqual(self.effect->param_.frameValue(), 10.0);
+  XCTAssertEqual(self.effect->rampRemaining(), 0);
+  XCTAssertFalse(self.effect->isRamping());
+  delete rampingEvent;
+}
+
 - (void)testDetectParameterChange {
   self.effect->param_.setPending(123.5);
   XCTAssertEqualWithAccuracy(self.effect->param_.getPending(), 123.5, epsilon);
@@ -348,6 +371,16 @@ ValidatedKernel<MockEffectWithRenderingStateChanged> _mockEffectWithRenderingSta
   XCTAssertEqual(effect->renderingStateChanges_, 2);
 }
 
+- (void)testTooManyChannels {
+  auto effect = new MockEffectWithRenderingStateChanged();
+  XCTAssertEqual(effect->setRenderingFormat(1, 44100.0, 10, 512), kAudioUnitErr_FormatNotSupported);
+  XCTAssertFalse(effect->isRendering());
+  XCTAssertEqual(effect->renderingStateChanges_, 0);
+  XCTAssertEqual(effect->setRenderingFormat(1, 44100.0, BusBuffers::maxChannelCount, 512), noErr);
+  XCTAssertTrue(effect->isRendering());
+  delete effect;
+}
+
 - (void)testRenderingStateChangeClearsRamping {
   auto effect = new MockEffectWithRenderingStateChanged();
   AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
@@ -417,4 +450,816 @@ struct MockEffectWithMIDI : public EventProcessor<MockEffectWithMIDI>
   XCTAssertEqual(effect->midiEvents_, 1);
 }
 
+struct MockEffectWithTail : public EventProcessor<MockEffectWithTail>
+{
+  using super = EventProcessor<MockEffectWithTail>;
+
+  MockEffectWithTail() : super("mock") { registerParameter(param_); }
+
+  AUAudioFrameCount doTailFrameCount() const { return 100; }
+
+  void doMIDIEvent(const AUMIDIEvent&) {}
+
+  void doRendering(BusBuffers, BusBuffers outs, AUAudioFrameCount frameCount) {
+    frameCounts_.push_back(frameCount);
+    for (size_t channel = 0; channel < outs.size(); ++channel) {
+      for (AUAudioFrameCount frame = 0; frame < frameCount; ++frame) outs[channel][frame] = 1.0;
+    }
+  }
+
+  Parameters::Float param_{0, 0.0, false};
+  std::vector<AUAudioFrameCount> frameCounts_{};
+};
+
+ValidatedKernel<MockEffectWithTail> _mockEffectWithTail;
+
+AURenderPullInputBlock silentPullInput = ^(AudioUnitRenderActionFlags* actionFlags, const AudioTimeStamp *timestamp,
+                                           AUAudioFrameCount frameCount, NSInteger inputBusNumber,
+                                           AudioBufferList* inputData) {
+  for (UInt32 bufferIndex = 0; bufferIndex < inputData->mNumberBuffers; ++bufferIndex) {
+    auto ptr = static_cast<AUValue*>(inputData->mBuffers[bufferIndex].mData);
+    for (AUAudioFrameCount frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+      ptr[frameIndex] = frameIndex % 2 ? -0.0 : 0.0;
+    }
+  }
+  return 0;
+};
+
+AURenderPullInputBlock flaggedSilentPullInput = ^(AudioUnitRenderActionFlags* actionFlags,
+                                                  const AudioTimeStamp *timestamp, AUAudioFrameCount frameCount,
+                                                  NSInteger inputBusNumber, AudioBufferList* inputData) {
+  // Leave garbage in the buffers to show that the flag is honored
+  *actionFlags |= kAudioUnitRenderAction_OutputIsSilence;
+  return 0;
+};
+
+- (void)testSkipRenderingAfterTail {
+  auto effect = new MockEffectWithTail();
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+  AUAudioFrameCount frames = 64;
+  effect->setRenderingFormat(1, format, 512);
+
+  AudioTimeStamp timestamp = AudioTimeStamp();
+  AVAudioPCMBuffer* buffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *outputData = [buffer mutableAudioBufferList];
+  AudioUnitRenderActionFlags flags = 0;
+
+  XCTAssertEqual(effect->processAndRender(&timestamp, frames, 0, outputData, nullptr, mockPullInput, &flags), 0);
+  XCTAssertEqual(effect->frameCounts_.size(), 1);
+
+  // Silent input is rendered until the tail has passed
+  XCTAssertEqual(effect->processAndRender(&timestamp, frames, 0, outputData, nullptr, silentPullInput, &flags), 0);
+  XCTAssertEqual(effect->processAndRender(&timestamp, frames, 0, outputData, nullptr, silentPullInput, &flags), 0);
+  XCTAssertEqual(effect->frameCounts_.size(), 3);
+  XCTAssertEqual(flags & kAudioUnitRenderAction_OutputIsSilence, 0);
+  XCTAssertEqual(static_cast<AUValue*>(outputData->mBuffers[0].mData)[0], 1.0);
+
+  XCTAssertEqual(effect->processAndRender(&timestamp, frames, 0, outputData, nullptr, silentPullInput, &flags), 0);
+  XCTAssertEqual(effect->frameCounts_.size(), 3);
+  XCTAssertEqual(flags & kAudioUnitRenderAction_OutputIsSilence, kAudioUnitRenderAction_OutputIsSilence);
+  for (UInt32 channel = 0; channel < outputData->mNumberBuffers; ++channel) {
+    auto samples = static_cast<AUValue*>(outputData->mBuffers[channel].mData);
+    for (AUAudioFrameCount frame = 0; frame < frames; ++frame) XCTAssertEqual(samples[frame], 0.0);
+  }
+
+  // Parameter events are still processed while skipping
+  AUParameterEvent paramEvent{};
+  paramEvent.eventSampleTime = 10;
+  paramEvent.parameterAddress = 0;
+  paramEvent.value = 0.5;
+  AURenderEvent* eventList = reinterpret_cast<AURenderEvent*>(&paramEvent);
+  eventList->head.eventType = AURenderEventParameter;
+  XCTAssertEqual(effect->processAndRender(&timestamp, frames, 0, outputData, eventList, flaggedSilentPullInput), 0);
+  XCTAssertEqual(effect->frameCounts_.size(), 3);
+  XCTAssertEqual(effect->param_.frameValue(), 0.5);
+
+  // Rendering resumes when input is no longer silent
+  flags = 0;
+  XCTAssertEqual(effect->processAndRender(&timestamp, frames, 0, outputData, nullptr, mockPullInput, &flags), 0);
+  XCTAssertEqual(effect->frameCounts_.size(), 4);
+  XCTAssertEqual(flags & kAudioUnitRenderAction_OutputIsSilence, 0);
+  delete effect;
+}
+
+- (void)testMIDIEventPreventsSkipRendering {
+  auto effect = new MockEffectWithTail();
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+  AUAudioFrameCount frames = 128;
+  effect->setRenderingFormat(1, format, 512);
+
+  AudioTimeStamp timestamp = AudioTimeStamp();
+  AVAudioPCMBuffer* buffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *outputData = [buffer mutableAudioBufferList];
+
+  effect->processAndRender(&timestamp, frames, 0, outputData, nullptr, flaggedSilentPullInput);
+  XCTAssertEqual(effect->frameCounts_.size(), 1);
+  effect->processAndRender(&timestamp, frames, 0, outputData, nullptr, flaggedSilentPullInput);
+  XCTAssertEqual(effect->frameCounts_.size(), 1);
+
+  AUMIDIEvent midiEvent{};
+  midiEvent.eventSampleTime = -1;
+  AURenderEvent* eventList = reinterpret_cast<AURenderEvent*>(&midiEvent);
+  eventList->head.eventType = AURenderEventMIDI;
+  effect->processAndRender(&timestamp, frames, 0, outputData, eventList, flaggedSilentPullInput);
+  XCTAssertEqual(effect->frameCounts_.size(), 2);
+  delete effect;
+}
+
+struct MockFixedBlockEffect : public EventProcessor<MockFixedBlockEffect, 16>
+{
+  using super = EventProcessor<MockFixedBlockEffect, 16>;
+
+  MockFixedBlockEffect() : super("mock") { registerParameter(gain_); }
+
+  void doRendering(BusBuffers ins, BusBuffers outs, AUAudioFrameCount frameCount) {
+    frameCounts_.push_back(frameCount);
+    gains_.push_back(gain_.frameValue());
+    for (size_t channel = 0; channel < outs.size(); ++channel) {
+      for (AUAudioFrameCount frame = 0; frame < frameCount; ++frame) {
+        outs[channel][frame] = ins[channel][frame] * gain_.frameValue();
+      }
+    }
+  }
+
+  Parameters::Float gain_{0, 1.0, false};
+  std::vector<AUAudioFrameCount> frameCounts_{};
+  std::vector<AUValue> gains_{};
+};
+
+ValidatedKernel<MockFixedBlockEffect> _mockFixedBlockEffect;
+
+- (void)testFixedBlockRendering {
+  auto effect = new MockFixedBlockEffect();
+  XCTAssertEqual(MockFixedBlockEffect::latency, 16);
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+  AUAudioFrameCount frames = 40;
+  effect->setRenderingFormat(1, format, 512);
+
+  AudioTimeStamp timestamp = AudioTimeStamp();
+  AVAudioPCMBuffer* buffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *outputData = [buffer mutableAudioBufferList];
+
+  XCTAssertEqual(effect->processAndRender(&timestamp, frames, 0, outputData, nullptr, mockPullInput), 0);
+  XCTAssertEqual(effect->frameCounts_, (std::vector<AUAudioFrameCount>{16, 16}));
+
+  // Output is delayed by one block
+  for (UInt32 channel = 0; channel < outputData->mNumberBuffers; ++channel) {
+    auto samples = static_cast<AUValue*>(outputData->mBuffers[channel].mData);
+    for (AUAudioFrameCount frame = 0; frame < 16; ++frame) XCTAssertEqual(samples[frame], 0.0);
+    for (AUAudioFrameCount frame = 16; frame < frames; ++frame) XCTAssertEqual(samples[frame], frame - 16);
+  }
+
+  timestamp.mSampleTime += frames;
+  XCTAssertEqual(effect->processAndRender(&timestamp, frames, 0, outputData, nullptr, mockPullInput), 0);
+  XCTAssertEqual(effect->frameCounts_, (std::vector<AUAudioFrameCount>{16, 16, 16, 16, 16}));
+
+  // The first 16 samples come from the end of the previous input (24-39), then the new input (0-23).
+  auto samples = static_cast<AUValue*>(outputData->mBuffers[0].mData);
+  for (AUAudioFrameCount frame = 0; frame < 16; ++frame) XCTAssertEqual(samples[frame], frame + 24);
+  for (AUAudioFrameCount frame = 16; frame < frames; ++frame) XCTAssertEqual(samples[frame], frame - 16);
+  delete effect;
+}
+
+- (void)testFixedBlockEventsQuantized {
+  auto effect = new MockFixedBlockEffect();
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+  effect->setRenderingFormat(1, format, 512);
+
+  AudioTimeStamp timestamp = AudioTimeStamp();
+  AVAudioPCMBuffer* buffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *outputData = [buffer mutableAudioBufferList];
+
+  // Event in the middle of the second block takes effect at the start of that block.
+  AUParameterEvent paramEvent{};
+  paramEvent.eventSampleTime = 20;
+  paramEvent.parameterAddress = 0;
+  paramEvent.value = 0.5;
+  AURenderEvent* eventList = reinterpret_cast<AURenderEvent*>(&paramEvent);
+  eventList->head.eventType = AURenderEventParameter;
+  XCTAssertEqual(effect->processAndRender(&timestamp, 40, 0, outputData, eventList, mockPullInput), 0);
+  XCTAssertEqual(effect->gains_, (std::vector<AUValue>{1.0, 0.5}));
+
+  // Event in the block that is still filling at the end of the call is applied before that block renders.
+  timestamp.mSampleTime += 40;
+  paramEvent.eventSampleTime = 42;
+  paramEvent.value = 0.25;
+  XCTAssertEqual(effect->processAndRender(&timestamp, 4, 0, outputData, eventList, mockPullInput), 0);
+  XCTAssertEqual(effect->gains_, (std::vector<AUValue>{1.0, 0.5}));
+  timestamp.mSampleTime += 4;
+  XCTAssertEqual(effect->processAndRender(&timestamp, 4, 0, outputData, nullptr, mockPullInput), 0);
+  XCTAssertEqual(effect->gains_, (std::vector<AUValue>{1.0, 0.5, 0.25}));
+  delete effect;
+}
+
+struct MockEffectWithCommands : public EventProcessor<MockEffectWithCommands>
+{
+  using super = EventProcessor<MockEffectWithCommands>;
+
+  MockEffectWithCommands() : super("mock") { registerParameters({param1_, param2_}); }
+
+  void doCommand(const Command& command) { codes_.push_back(command.code); }
+
+  void doRendering(BusBuffers, BusBuffers, AUAudioFrameCount frameCount) {}
+
+  bool doSetImmediateParameterValue(AUParameterAddress address, AUValue value, AUAudioFrameCount duration) {
+    changes_.push_back(value);
+    (address == 1 ? param1_ : param2_).setImmediate(value, duration);
+    return true;
+  }
+
+  Parameters::Float param1_{1, 0.0, false};
+  Parameters::Float param2_{2, 0.0, false};
+  std::vector<uint32_t> codes_{};
+  std::vector<AUValue> changes_{};
+};
+
+ValidatedKernel<MockEffectWithCommands> _mockEffectWithCommands;
+
+- (void)testCommands {
+  auto effect = new MockEffectWithCommands();
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+  effect->setRenderingFormat(1, format, 512);
+
+  AudioTimeStamp timestamp = AudioTimeStamp();
+  AVAudioPCMBuffer* buffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *outputData = [buffer mutableAudioBufferList];
+
+  // Interleaved changes to two parameters only apply the last value of each.
+  XCTAssertTrue(effect->postCommand(Command::parameter(1, 0.1)));
+  XCTAssertTrue(effect->postCommand(Command::parameter(2, 0.2)));
+  XCTAssertTrue(effect->postCommand(Command::custom(7)));
+  XCTAssertTrue(effect->postCommand(Command::parameter(1, 0.3)));
+  XCTAssertTrue(effect->postCommand(Command::parameter(2, 0.4)));
+  XCTAssertTrue(effect->postCommand(Command::custom(8, 0.0, nullptr, 100)));
+  XCTAssertTrue(effect->postCommand(Command::parameter(1, 0.5, 0, 100)));
+
+  XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, outputData, nullptr, mockPullInput), 0);
+  XCTAssertEqual(effect->codes_, (std::vector<uint32_t>{7}));
+  XCTAssertEqual(effect->changes_, (std::vector<AUValue>{0.3, 0.4}));
+  XCTAssertEqual(effect->param1_.getImmediate(), AUValue(0.3));
+  XCTAssertEqual(effect->param2_.getImmediate(), AUValue(0.4));
+
+  // Commands without a ramp duration take effect immediately and leave nothing ramping
+  XCTAssertEqual(effect->rampRemaining(), 0);
+  XCTAssertFalse(effect->isRamping());
+
+  // Timestamped commands wait for the render call that reaches them
+  timestamp.mSampleTime += 64;
+  XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, outputData, nullptr, mockPullInput), 0);
+  XCTAssertEqual(effect->codes_, (std::vector<uint32_t>{7, 8}));
+  XCTAssertEqual(effect->param1_.getImmediate(), AUValue(0.5));
+  delete effect;
+}
+
+- (void)testRampedCommand {
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+  AVAudioPCMBuffer* buffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *outputData = [buffer mutableAudioBufferList];
+  AudioTimeStamp timestamp = AudioTimeStamp();
+
+  // The ramp takes one step per render pass, starting with the pass that applies the command.
+  XCTAssertTrue(self.effect->postCommand(Command::parameter(1, 64.0, 4)));
+  for (int pass = 0; pass < 5; ++pass) {
+    XCTAssertEqual(self.effect->processAndRender(&timestamp, 64, 0, outputData, nullptr, mockPullInput), 0);
+    timestamp.mSampleTime += 64;
+    XCTAssertEqual(self.effect->isRamping(), pass < 3);
+  }
+
+  XCTAssertEqual(self.effect->paramValues_, (std::vector<AUAudioFrameCount>{16, 32, 48, 64, 64}));
+  XCTAssertFalse(self.effect->param_.isRamping());
+}
+
+- (void)testCommandQueueFull {
+  auto effect = new MockEffectWithCommands();
+  for (size_t index = 0; index < MockEffectWithCommands::commandQueueCapacity; ++index) {
+    XCTAssertTrue(effect->postCommand(Command::custom(uint32_t(index))));
+  }
+  XCTAssertFalse(effect->postCommand(Command::custom(0)));
+  delete effect;
+}
+
+- (void)testMetering {
+  auto effect = new MockEffectWithTail();
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:1000.0 channels:2];
+  effect->configureMetering(0.064, 8);
+  effect->setRenderingFormat(1, format, 512);
+  XCTAssertTrue(effect->isMeteringEnabled());
+  XCTAssertEqual(effect->meterCount(), 1);
+
+  AudioTimeStamp timestamp = AudioTimeStamp();
+  AVAudioPCMBuffer* buffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *outputData = [buffer mutableAudioBufferList];
+
+  XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, outputData, nullptr, mockPullInput), 0);
+  auto& reading = effect->meterReading(0);
+  XCTAssertEqual(reading.channelCount, 2);
+  XCTAssertEqual(reading.peak[0], 1.0);
+  XCTAssertEqual(reading.rms[1], 1.0);
+  XCTAssertEqual(reading.scopeLength, 8);
+
+  effect->setMeteringEnabled(false);
+  XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, outputData, nullptr, mockPullInput), 0);
+  XCTAssertEqual(effect->meterReading(0).sequence, 0);
+  delete effect;
+}
+
+- (void)testNoMeteringByDefault {
+  XCTAssertFalse(self.effect->isMeteringEnabled());
+  XCTAssertEqual(self.effect->meterCount(), 0);
+}
+
+struct MockEffectWithMIDI2 : public EventProcessor<MockEffectWithMIDI2>
+{
+  using super = EventProcessor<MockEffectWithMIDI2>;
+
+  MockEffectWithMIDI2() : super("mock") {}
+
+  void doMIDI2Event(const MIDI2::Event& event) {
+    notes_.push_back(event.note);
+    eventFrames_.push_back(renderedFrames_);
+  }
+
+  void doRendering(BusBuffers, BusBuffers, AUAudioFrameCount frameCount) { renderedFrames_ += frameCount; }
+
+  std::vector<UInt8> notes_{};
+  std::vector<AUAudioFrameCount> eventFrames_{};
+  AUAudioFrameCount renderedFrames_{0};
+};
+
+ValidatedKernel<MockEffectWithMIDI2> _mockEffectWithMIDI2;
+
+// Make an AUMIDIEventList holding one packet with the given MIDI 2.0 note on messages.
+static AURenderEvent* makeMIDIEventList(std::vector<UInt64>& storage, AUEventSampleTime when,
+                                        std::initializer_list<UInt8> notes) {
+  storage.assign(64, 0);
+  auto event = reinterpret_cast<AUMIDIEventList*>(storage.data());
+  event->eventSampleTime = when;
+  event->eventType = AURenderEventMIDIEventList;
+  event->eventList.protocol = kMIDIProtocol_2_0;
+  event->eventList.numPackets = 1;
+  auto& packet = event->eventList.packet[0];
+  packet.wordCount = 0;
+  for (auto note : notes) {
+    packet.words[packet.wordCount++] = 0x40900000 | (UInt32(note) << 8);
+    packet.words[packet.wordCount++] = 0xFFFF0000;
+  }
+  return reinterpret_cast<AURenderEvent*>(event);
+}
+
+- (void)testMIDI2EventProcessing {
+  auto effect = new MockEffectWithMIDI2();
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+  effect->setRenderingFormat(1, format, 512);
+
+  AudioTimeStamp timestamp = AudioTimeStamp();
+  AVAudioPCMBuffer* buffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *outputData = [buffer mutableAudioBufferList];
+
+  std::vector<UInt64> first;
+  std::vector<UInt64> second;
+  auto eventList = makeMIDIEventList(first, 10, {60, 64});
+  eventList->head.next = makeMIDIEventList(second, 25, {67});
+
+  XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, outputData, eventList, mockPullInput), 0);
+  XCTAssertEqual(effect->notes_, (std::vector<UInt8>{60, 64, 67}));
+
+  // Each event is delivered after rendering exactly the frames before it
+  XCTAssertEqual(effect->eventFrames_, (std::vector<AUAudioFrameCount>{10, 10, 25}));
+  XCTAssertEqual(effect->renderedFrames_, 64);
+  delete effect;
+}
+
+struct MockSplitEffect : public EventProcessor<MockSplitEffect>
+{
+  using super = EventProcessor<MockSplitEffect>;
+
+  MockSplitEffect() : super("mock") {}
+
+  void doRendering(BusBuffers ins, std::span<BusBuffers> outs, AUAudioFrameCount frameCount) {
+    frameCounts_.push_back(frameCount);
+    for (size_t bus = 0; bus < outs.size(); ++bus) {
+      for (size_t channel = 0; channel < outs[bus].size(); ++channel) {
+        for (AUAudioFrameCount frame = 0; frame < frameCount; ++frame) {
+          outs[bus][channel][frame] = ins[channel][frame] * 0.5f * AUValue(bus + 1);
+        }
+      }
+    }
+  }
+
+  std::vector<AUAudioFrameCount> frameCounts_{};
+};
+
+ValidatedKernel<MockSplitEffect> _mockSplitEffect;
+
+static int pullCount = 0;
+
+AURenderPullInputBlock countingPullInput = ^(AudioUnitRenderActionFlags* actionFlags, const AudioTimeStamp *timestamp,
+                                             AUAudioFrameCount frameCount, NSInteger inputBusNumber,
+                                             AudioBufferList* inputData) {
+  ++pullCount;
+  XCTAssertEqual(inputBusNumber, 0);
+  return mockPullInput(actionFlags, timestamp, frameCount, inputBusNumber, inputData);
+};
+
+- (void)testRenderAllBussesOnce {
+  auto effect = new MockSplitEffect();
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+  effect->setRenderingFormat(2, format, 512);
+  pullCount = 0;
+
+  AudioTimeStamp timestamp = AudioTimeStamp();
+  AVAudioPCMBuffer* buffer0 = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AVAudioPCMBuffer* buffer1 = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *output0 = [buffer0 mutableAudioBufferList];
+  AudioBufferList *output1 = [buffer1 mutableAudioBufferList];
+
+  XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, output0, nullptr, countingPullInput), 0);
+  XCTAssertEqual(effect->processAndRender(&timestamp, 64, 1, output1, nullptr, countingPullInput), 0);
+  XCTAssertEqual(pullCount, 1);
+  XCTAssertEqual(effect->frameCounts_.size(), 1);
+  for (UInt32 channel = 0; channel < 2; ++channel) {
+    auto samples0 = static_cast<AUValue*>(output0->mBuffers[channel].mData);
+    auto samples1 = static_cast<AUValue*>(output1->mBuffers[channel].mData);
+    for (AUAudioFrameCount frame = 0; frame < 64; ++frame) {
+      XCTAssertEqual(samples0[frame], 0.5f * frame);
+      XCTAssertEqual(samples1[frame], frame);
+    }
+    XCTAssertEqual(output1->mBuffers[channel].mDataByteSize, 64 * sizeof(AUValue));
+  }
+
+  // A new sample time renders again, and host buffers without storage get ours.
+  timestamp.mSampleTime += 64;
+  output1->mBuffers[0].mData = nullptr;
+  output1->mBuffers[1].mData = nullptr;
+  XCTAssertEqual(effect->processAndRender(&timestamp, 32, 1, output1, nullptr, countingPullInput), 0);
+  XCTAssertEqual(effect->processAndRender(&timestamp, 32, 0, output0, nullptr, countingPullInput), 0);
+  XCTAssertEqual(pullCount, 2);
+  XCTAssertEqual(effect->frameCounts_.size(), 2);
+  XCTAssertTrue(output1->mBuffers[0].mData != nullptr);
+  XCTAssertEqual(static_cast<AUValue*>(output1->mBuffers[0].mData)[31], 31.0);
+  XCTAssertEqual(static_cast<AUValue*>(output0->mBuffers[1].mData)[31], 15.5);
+
+  // Changing the rendering state invalidates the cache
+  effect->deallocateRenderResources();
+  effect->setRenderingFormat(2, format, 512);
+  output1->mBuffers[0].mData = nullptr;
+  output1->mBuffers[1].mData = nullptr;
+  XCTAssertEqual(effect->processAndRender(&timestamp, 32, 1, output1, nullptr, countingPullInput), 0);
+  XCTAssertEqual(pullCount, 3);
+  delete effect;
+}
+
+static std::vector<void*> pulledBuffers;
+static AUValue upstreamSamples[2][512];
+
+AURenderPullInputBlock redirectingPullInput = ^(AudioUnitRenderActionFlags* actionFlags,
+                                                const AudioTimeStamp *timestamp, AUAudioFrameCount frameCount,
+                                                NSInteger inputBusNumber, AudioBufferList* inputData) {
+  // Like an upstream node that renders in place, hand back our own buffers instead of filling the ones given.
+  pulledBuffers.push_back(inputData->mBuffers[0].mData);
+  for (UInt32 channel = 0; channel < inputData->mNumberBuffers; ++channel) {
+    for (AUAudioFrameCount frame = 0; frame < frameCount; ++frame) upstreamSamples[channel][frame] = frame;
+    inputData->mBuffers[channel].mData = upstreamSamples[channel];
+  }
+  return AUAudioUnitStatus(noErr);
+};
+
+- (void)testRenderAllBussesRestoresInputBuffers {
+  auto effect = new MockSplitEffect();
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+  effect->setRenderingFormat(2, format, 512);
+  pulledBuffers.clear();
+
+  AudioTimeStamp timestamp = AudioTimeStamp();
+  AVAudioPCMBuffer* buffer0 = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AVAudioPCMBuffer* buffer1 = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *output0 = [buffer0 mutableAudioBufferList];
+  AudioBufferList *output1 = [buffer1 mutableAudioBufferList];
+  for (int pass = 0; pass < 2; ++pass) {
+    XCTAssertEqual(effect->processAndRender(&timestamp, 64, 1, output1, nullptr, redirectingPullInput), 0);
+    XCTAssertEqual(static_cast<AUValue*>(output1->mBuffers[0].mData)[31], 31.0);
+    timestamp.mSampleTime += 64;
+  }
+
+  // Bus 0 is rendered into our own storage, never into the buffers handed back by upstream.
+  output0->mBuffers[0].mData = nullptr;
+  output0->mBuffers[1].mData = nullptr;
+  timestamp.mSampleTime -= 64;
+  XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, output0, nullptr, redirectingPullInput), 0);
+  XCTAssertTrue(output0->mBuffers[0].mData != upstreamSamples[0]);
+  XCTAssertEqual(static_cast<AUValue*>(output0->mBuffers[0].mData)[31], 15.5);
+  XCTAssertEqual(upstreamSamples[0][31], 31.0);
+
+  // Each pull is given our own storage, not the buffers that the last pull handed back.
+  XCTAssertEqual(pulledBuffers.size(), 2);
+  XCTAssertEqual(pulledBuffers[0], pulledBuffers[1]);
+  XCTAssertTrue(pulledBuffers[1] != upstreamSamples[0]);
+  delete effect;
+}
+
+struct MockSideChainEffect : public EventProcessor<MockSideChainEffect>
+{
+  using super = EventProcessor<MockSideChainEffect>;
+
+  MockSideChainEffect() : super("mock") {
+    registerParameter(param_);
+    setInputBusCount(2);
+  }
+
+  void doRendering(std::span<BusBuffers> ins, BusBuffers outs, AUAudioFrameCount frameCount) {
+    frameCounts_.push_back(frameCount);
+    for (size_t channel = 0; channel < outs.size(); ++channel) {
+      for (AUAudioFrameCount frame = 0; frame < frameCount; ++frame) {
+        outs[channel][frame] = ins[0][channel][frame] + ins[1][channel][frame];
+      }
+    }
+  }
+
+  Parameters::Float param_{0, 0.0, false};
+  std::vector<AUAudioFrameCount> frameCounts_{};
+};
+
+ValidatedKernel<MockSideChainEffect> _mockSideChainEffect;
+
+static AUValue sideChainSamples[2][512];
+
+// Bus 0 gets a ramp. Bus 1 gets 1000 + ramp written into the given buffers.
+AURenderPullInputBlock sideChainPullInput = ^(AudioUnitRenderActionFlags* actionFlags, const AudioTimeStamp *timestamp,
+                                              AUAudioFrameCount frameCount, NSInteger inputBusNumber,
+                                              AudioBufferList* inputData) {
+  if (inputBusNumber == 0) return mockPullInput(actionFlags, timestamp, frameCount, inputBusNumber, inputData);
+  for (UInt32 channel = 0; channel < inputData->mNumberBuffers; ++channel) {
+    auto ptr = static_cast<AUValue*>(inputData->mBuffers[channel].mData);
+    for (AUAudioFrameCount frame = 0; frame < frameCount; ++frame) ptr[frame] = 1000 + AUValue(frame);
+  }
+  return AUAudioUnitStatus(noErr);
+};
+
+// Same as above, but bus 1 supplies its own buffers instead of writing into the given ones.
+AURenderPullInputBlock sideChainSupplyingPullInput = ^(AudioUnitRenderActionFlags* actionFlags,
+                                                       const AudioTimeStamp *timestamp, AUAudioFrameCount frameCount,
+                                                       NSInteger inputBusNumber, AudioBufferList* inputData) {
+  if (inputBusNumber == 0) return mockPullInput(actionFlags, timestamp, frameCount, inputBusNumber, inputData);
+  for (UInt32 channel = 0; channel < inputData->mNumberBuffers; ++channel) {
+    inputData->mBuffers[channel].mData = sideChainSamples[channel];
+    for (AUAudioFrameCount frame = 0; frame < frameCount; ++frame) sideChainSamples[channel][frame] = 1000 + frame;
+  }
+  return AUAudioUnitStatus(noErr);
+};
+
+- (void)testSideChainInput {
+  for (auto pullInput : {sideChainPullInput, sideChainSupplyingPullInput}) {
+    auto effect = new MockSideChainEffect();
+    XCTAssertEqual(effect->inputBusCount(), 2);
+    AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+    effect->setRenderingFormat(1, format, 512);
+
+    AudioTimeStamp timestamp = AudioTimeStamp();
+    AVAudioPCMBuffer* buffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+    AudioBufferList *outputData = [buffer mutableAudioBufferList];
+
+    // Split the render in two to show that all input busses advance together.
+    AUParameterEvent paramEvent{};
+    paramEvent.eventSampleTime = 10;
+    paramEvent.parameterAddress = 0;
+    paramEvent.value = 0.5;
+    AURenderEvent* eventList = reinterpret_cast<AURenderEvent*>(&paramEvent);
+    eventList->head.eventType = AURenderEventParameter;
+
+    XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, outputData, eventList, pullInput), 0);
+    XCTAssertEqual(effect->frameCounts_, (std::vector<AUAudioFrameCount>{10, 54}));
+    for (UInt32 channel = 0; channel < 2; ++channel) {
+      auto samples = static_cast<AUValue*>(outputData->mBuffers[channel].mData);
+      for (AUAudioFrameCount frame = 0; frame < 64; ++frame) XCTAssertEqual(samples[frame], 1000 + 2 * frame);
+    }
+    delete effect;
+  }
+}
+
+- (void)testSideChainWithoutPullInput {
+  auto effect = new MockSideChainEffect();
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+  effect->setRenderingFormat(1, format, 512);
+
+  AudioTimeStamp timestamp = AudioTimeStamp();
+  AVAudioPCMBuffer* buffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *outputData = [buffer mutableAudioBufferList];
+  XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, outputData, nullptr, nullptr), 0);
+  XCTAssertEqual(effect->frameCounts_.size(), 1);
+  XCTAssertEqual(static_cast<AUValue*>(outputData->mBuffers[0].mData)[5], 0.0);
+  delete effect;
+}
+
+struct MockOversampledEffect : public EventProcessor<MockOversampledEffect>
+{
+  using super = EventProcessor<MockOversampledEffect>;
+
+  MockOversampledEffect() : super("mock") {
+    registerParameter(gain_);
+    setOversampling(4);
+  }
+
+  void doRendering(BusBuffers ins, BusBuffers outs, AUAudioFrameCount frameCount) {
+    frameCounts_.push_back(frameCount);
+    std::vector<AUValue> gains(frameCount, gain_.frameValue());
+    gain_.fillFrameValues(gains);
+    gains_.insert(gains_.end(), gains.begin(), gains.end());
+    for (size_t channel = 0; channel < outs.size(); ++channel) {
+      for (AUAudioFrameCount frame = 0; frame < frameCount; ++frame) {
+        outs[channel][frame] = ins[channel][frame] * gains[frame];
+      }
+    }
+  }
+
+  Parameters::Float gain_{0, 1.0};
+  std::vector<AUAudioFrameCount> frameCounts_{};
+  std::vector<AUValue> gains_{};
+};
+
+ValidatedKernel<MockOversampledEffect> _mockOversampledEffect;
+
+AURenderPullInputBlock constantPullInput = ^(AudioUnitRenderActionFlags* actionFlags, const AudioTimeStamp *timestamp,
+                                             AUAudioFrameCount frameCount, NSInteger inputBusNumber,
+                                             AudioBufferList* inputData) {
+  for (UInt32 bufferIndex = 0; bufferIndex < inputData->mNumberBuffers; ++bufferIndex) {
+    auto ptr = static_cast<AUValue*>(inputData->mBuffers[bufferIndex].mData);
+    std::fill_n(ptr, frameCount, 1.0f);
+  }
+  return AUAudioUnitStatus(noErr);
+};
+
+- (void)testOversampledRendering {
+  auto effect = new MockOversampledEffect();
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+  effect->setRenderingFormat(1, format, 512);
+  XCTAssertEqual(effect->oversampling(), 4);
+  XCTAssertEqual(effect->sampleRate(), 44100.0);
+  XCTAssertEqual(effect->renderingSampleRate(), 4 * 44100.0);
+  XCTAssertEqual(effect->oversamplingLatency(), 26.5);
+  XCTAssertEqual(effect->treeBasedRampDuration(), 4 * 16);
+
+  AudioTimeStamp timestamp = AudioTimeStamp();
+  AVAudioPCMBuffer* buffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *outputData = [buffer mutableAudioBufferList];
+
+  // Once past the start-up transient of the filters, the constant input comes out unchanged.
+  XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, outputData, nullptr, constantPullInput), 0);
+  timestamp.mSampleTime += 64;
+  XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, outputData, nullptr, constantPullInput), 0);
+  XCTAssertEqual(effect->frameCounts_, (std::vector<AUAudioFrameCount>{256, 256}));
+  for (UInt32 channel = 0; channel < outputData->mNumberBuffers; ++channel) {
+    auto samples = static_cast<AUValue*>(outputData->mBuffers[channel].mData);
+    for (AUAudioFrameCount frame = 0; frame < 64; ++frame) XCTAssertEqualWithAccuracy(samples[frame], 1.0, 1.0e-3);
+  }
+
+  // The kernel sees the event offset and the ramp duration grow by the oversampling factor.
+  AUParameterEvent paramEvent{};
+  paramEvent.eventSampleTime = timestamp.mSampleTime + 64 + 10;
+  paramEvent.parameterAddress = 0;
+  paramEvent.value = 0.0;
+  paramEvent.rampDurationSampleFrames = 8;
+  AURenderEvent* eventList = reinterpret_cast<AURenderEvent*>(&paramEvent);
+  eventList->head.eventType = AURenderEventParameterRamp;
+  timestamp.mSampleTime += 64;
+  effect->gains_.clear();
+  XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, outputData, eventList, constantPullInput), 0);
+  XCTAssertEqual(effect->frameCounts_, (std::vector<AUAudioFrameCount>{256, 256, 40, 216}));
+  XCTAssertEqual(effect->gains_[39], 1.0);
+  XCTAssertLessThan(effect->gains_[40], 1.0);
+  XCTAssertGreaterThan(effect->gains_[40 + 30], 0.0);
+  XCTAssertEqual(effect->gains_[40 + 31], 0.0);
+  delete effect;
+}
+
+- (void)testOversampledRenderingWithoutPullInput {
+  auto effect = new MockOversampledEffect();
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+  effect->setRenderingFormat(1, format, 512);
+
+  AudioTimeStamp timestamp = AudioTimeStamp();
+  AVAudioPCMBuffer* buffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *outputData = [buffer mutableAudioBufferList];
+  XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, outputData, nullptr, nullptr), 0);
+  XCTAssertEqual(effect->frameCounts_, (std::vector<AUAudioFrameCount>{256}));
+  for (UInt32 channel = 0; channel < outputData->mNumberBuffers; ++channel) {
+    auto samples = static_cast<AUValue*>(outputData->mBuffers[channel].mData);
+    for (AUAudioFrameCount frame = 0; frame < 64; ++frame) XCTAssertEqual(samples[frame], 0.0);
+  }
+  delete effect;
+}
+
+- (void)testOversampledBypassLatency {
+  auto rendered = new MockOversampledEffect();
+  auto bypassed = new MockOversampledEffect();
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+  rendered->setRenderingFormat(1, format, 512);
+  bypassed->setRenderingFormat(1, format, 512);
+  bypassed->setBypass(true);
+
+  AudioTimeStamp timestamp = AudioTimeStamp();
+  AVAudioPCMBuffer* renderedBuffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AVAudioPCMBuffer* bypassedBuffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *renderedData = [renderedBuffer mutableAudioBufferList];
+  AudioBufferList *bypassedData = [bypassedBuffer mutableAudioBufferList];
+
+  // With unity gain the kernel passes its input through, so bypassing must give the same, equally delayed, output.
+  for (int pass = 0; pass < 3; ++pass) {
+    XCTAssertEqual(rendered->processAndRender(&timestamp, 64, 0, renderedData, nullptr, mockPullInput), 0);
+    XCTAssertEqual(bypassed->processAndRender(&timestamp, 64, 0, bypassedData, nullptr, mockPullInput), 0);
+    timestamp.mSampleTime += 64;
+    for (UInt32 channel = 0; channel < renderedData->mNumberBuffers; ++channel) {
+      auto expected = static_cast<AUValue*>(renderedData->mBuffers[channel].mData);
+      auto samples = static_cast<AUValue*>(bypassedData->mBuffers[channel].mData);
+      for (AUAudioFrameCount frame = 0; frame < 64; ++frame) XCTAssertEqual(samples[frame], expected[frame]);
+    }
+  }
+
+  XCTAssertEqual(rendered->frameCounts_.size(), 3);
+  XCTAssertTrue(bypassed->frameCounts_.empty());
+  delete rendered;
+  delete bypassed;
+}
+
+- (void)testOversampledRampTiming {
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+  AVAudioPCMBuffer* buffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *outputData = [buffer mutableAudioBufferList];
+
+  // A kernel that uses `frameValue` sees a ramp take the same number of render passes at every oversampling factor.
+  for (AUAudioFrameCount factor : {1u, 2u, 8u}) {
+    auto effect = new MockEffect();
+    effect->setOversampling(factor);
+    effect->setRenderingFormat(1, format, 512, 4);
+    XCTAssertEqual(effect->treeBasedRampDuration(), 4 * factor);
+    effect->param_.setPending(64.0);
+
+    AudioTimeStamp timestamp = AudioTimeStamp();
+    std::vector<AUAudioFrameCount> remaining;
+    for (int pass = 0; pass < 5; ++pass) {
+      XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, outputData, nullptr, constantPullInput), 0);
+      remaining.push_back(effect->rampRemaining());
+      timestamp.mSampleTime += 64;
+    }
+
+    XCTAssertEqual(effect->frameCounts_, std::vector<AUAudioFrameCount>(5, 64 * factor));
+    XCTAssertEqual(effect->paramValues_, (std::vector<AUAudioFrameCount>{16, 32, 48, 64, 64}));
+    XCTAssertEqual(remaining, (std::vector<AUAudioFrameCount>{3 * factor, 2 * factor, factor, 0, 0}));
+    XCTAssertFalse(effect->isRamping());
+    XCTAssertFalse(effect->param_.isRamping());
+    delete effect;
+  }
+}
+
+#if DSPHEADERS_RENDER_GUARD_ENABLED
+
+struct MockAllocatingEffect : public EventProcessor<MockAllocatingEffect>
+{
+  using super = EventProcessor<MockAllocatingEffect>;
+
+  MockAllocatingEffect() : super("mock") {}
+
+  void doRendering(BusBuffers ins, BusBuffers outs, AUAudioFrameCount frameCount) {
+    if (allocate_) scratch_.resize(scratch_.size() + frameCount);
+    for (size_t channel = 0; channel < outs.size(); ++channel) {
+      std::copy_n(ins[channel], frameCount, outs[channel]);
+    }
+  }
+
+  bool allocate_{false};
+  std::vector<AUValue> scratch_{};
+};
+
+- (void)testRenderGuard {
+  auto effect = new MockAllocatingEffect();
+  AVAudioFormat* format = [[AVAudioFormat alloc] initStandardFormatWithSampleRate:44100.0 channels:2];
+  effect->setRenderingFormat(1, format, 512);
+
+  AudioTimeStamp timestamp = AudioTimeStamp();
+  AVAudioPCMBuffer* buffer = [[AVAudioPCMBuffer alloc] initWithPCMFormat:format frameCapacity:512];
+  AudioBufferList *outputData = [buffer mutableAudioBufferList];
+
+  AUParameterEvent paramEvent{};
+  paramEvent.eventSampleTime = 10;
+  paramEvent.parameterAddress = 0;
+  paramEvent.value = 0.5;
+  AURenderEvent* eventList = reinterpret_cast<AURenderEvent*>(&paramEvent);
+  eventList->head.eventType = AURenderEventParameter;
+
+  // Rendering by the processor itself is free of allocations and locks.
+  RenderGuard::reset();
+  XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, outputData, eventList, constantPullInput), 0);
+  XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, outputData, nullptr, nullptr), 0);
+  XCTAssertEqual(RenderGuard::violationCount(), 0);
+
+  effect->allocate_ = true;
+  XCTAssertEqual(effect->processAndRender(&timestamp, 64, 0, outputData, nullptr, constantPullInput), 0);
+  XCTAssertEqual(RenderGuard::violationCount(), 1);
+  XCTAssertEqual(RenderGuard::violation(0).kind, RenderGuard::Kind::allocation);
+  XCTAssertEqual(RenderGuard::violation(0).size, 64 * sizeof(AUValue));
+  RenderGuard::reset();
+  delete effect;
+}
+
+#endif
+
 @end
@@ -0,0 +1,174 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <array>
+#import <initializer_list>
+#import <memory>
+#import <vector>
+
+#import "DSPHeaders/MIDI2.hpp"
+
+using namespace DSPHeaders;
+
+namespace {
+
+// Storage for a variable-length MIDIEventList. Packets only occupy the words they use, just like the real thing.
+struct EventListBuffer {
+  EventListBuffer(std::initializer_list<std::initializer_list<UInt32>> packets) {
+    storage[0] = kMIDIProtocol_2_0;
+    storage[1] = UInt32(packets.size());
+    size_t pos = 2;
+    for (auto packet : packets) {
+      pos += 2; // timestamp
+      storage[pos++] = UInt32(packet.size());
+      for (auto word : packet) storage[pos++] = word;
+    }
+  }
+
+  const MIDIEventList& list() const { return *reinterpret_cast<const MIDIEventList*>(storage.data()); }
+
+  alignas(8) std::array<UInt32, 1024> storage{};
+};
+
+std::vector<MIDI2::Event> decode(const EventListBuffer& buffer) {
+  std::vector<MIDI2::Event> events;
+  MIDI2::forEachEvent(buffer.list(), [&](const MIDI2::Event& event) { events.push_back(event); });
+  return events;
+}
+
+}
+
+@interface MIDI2Tests : XCTestCase
+@end
+
+@implementation MIDI2Tests
+
+- (void)testMessageWordCount {
+  XCTAssertEqual(MIDI2::messageWordCount(0x20000000), 1);
+  XCTAssertEqual(MIDI2::messageWordCount(0x30000000), 2);
+  XCTAssertEqual(MIDI2::messageWordCount(0x40000000), 2);
+  XCTAssertEqual(MIDI2::messageWordCount(0x50000000), 4);
+  XCTAssertEqual(MIDI2::messageWordCount(0xF0000000), 4);
+}
+
+- (void)testScaleUp {
+  XCTAssertEqual(MIDI2::scaleUp(0, 7, 16), 0x0000);
+  XCTAssertEqual(MIDI2::scaleUp(64, 7, 16), 0x8000);
+  XCTAssertEqual(MIDI2::scaleUp(127, 7, 16), 0xFFFF);
+  XCTAssertEqual(MIDI2::scaleUp(127, 7, 32), 0xFFFFFFFF);
+  XCTAssertEqual(MIDI2::scaleUp(8192, 14, 32), 0x80000000);
+  XCTAssertEqual(MIDI2::scaleUp(16383, 14, 32), 0xFFFFFFFF);
+}
+
+- (void)testMIDI2NoteOn {
+  EventListBuffer buffer({{0x41934C03, 0xC0001234}});
+  auto events = decode(buffer);
+  XCTAssertEqual(events.size(), 1);
+  XCTAssertTrue(events[0].kind == MIDI2::Kind::noteOn);
+  XCTAssertEqual(events[0].group, 1);
+  XCTAssertEqual(events[0].channel, 3);
+  XCTAssertEqual(events[0].note, 0x4C);
+  XCTAssertEqual(events[0].attributeType, 3);
+  XCTAssertEqual(events[0].velocity, 0xC000);
+  XCTAssertEqual(events[0].attribute, 0x1234);
+}
+
+- (void)testMIDI2Controllers {
+  EventListBuffer buffer({
+    {0x40B10700, 0x80000000},   // control change 7
+    {0x40013C05, 0x12345678,    // registered per-note controller 5 on note 60
+     0x40220102, 0xFFFFFFFF},   // registered controller bank 1 index 2
+    {0x40C00001, 0x05000102},   // program change 5, bank 1:2
+    {0x40E00000, 0x80000000}}); // pitch bend center
+  auto events = decode(buffer);
+  XCTAssertEqual(events.size(), 5);
+  XCTAssertTrue(events[0].kind == MIDI2::Kind::controlChange);
+  XCTAssertEqual(events[0].channel, 1);
+  XCTAssertEqual(events[0].index, 7);
+  XCTAssertEqual(events[0].value, 0x80000000);
+
+  XCTAssertTrue(events[1].kind == MIDI2::Kind::registeredPerNoteController);
+  XCTAssertEqual(events[1].note, 60);
+  XCTAssertEqual(events[1].index, 5);
+  XCTAssertEqual(events[1].value, 0x12345678);
+
+  XCTAssertTrue(events[2].kind == MIDI2::Kind::registeredController);
+  XCTAssertEqual(events[2].channel, 2);
+  XCTAssertEqual(events[2].bank, 1);
+  XCTAssertEqual(events[2].index, 2);
+
+  XCTAssertTrue(events[3].kind == MIDI2::Kind::programChange);
+  XCTAssertEqual(events[3].flags, 1);
+  XCTAssertEqual(events[3].index, 5);
+  XCTAssertEqual(events[3].bank, (1 << 7) | 2);
+
+  XCTAssertTrue(events[4].kind == MIDI2::Kind::pitchBend);
+  XCTAssertEqual(events[4].value, 0x80000000);
+}
+
+- (void)testMIDI1Conversion {
+  EventListBuffer buffer({{
+    0x20904064,   // note on 64, velocity 100
+    0x20904000,   // note on 64, velocity 0
+    0x20B1077F,   // control change 7 to 127
+    0x20E00040}}); // pitch bend center
+  auto events = decode(buffer);
+  XCTAssertEqual(events.size(), 4);
+  XCTAssertTrue(events[0].kind == MIDI2::Kind::noteOn);
+  XCTAssertEqual(events[0].note, 64);
+  XCTAssertEqual(events[0].velocity, MIDI2::scaleUp(100, 7, 16));
+  XCTAssertTrue(events[1].kind == MIDI2::Kind::noteOff);
+  XCTAssertEqual(events[1].velocity, 0x8000);
+  XCTAssertTrue(events[2].kind == MIDI2::Kind::controlChange);
+  XCTAssertEqual(events[2].channel, 1);
+  XCTAssertEqual(events[2].value, 0xFFFFFFFF);
+  XCTAssertTrue(events[3].kind == MIDI2::Kind::pitchBend);
+  XCTAssertEqual(events[3].value, 0x80000000);
+}
+
+- (void)testSkipsOtherMessages {
+  EventListBuffer buffer({{
+    0x10F80000,                               // system real-time
+    0x30011234, 0x56780000,                   // SysEx7
+    0x00000000,                               // utility
+    0x40904000, 0xFFFF0000,                   // note on
+    0x50000000, 0x00000000, 0x00000000, 0x00000000}}); // SysEx8
+  auto events = decode(buffer);
+  XCTAssertEqual(events.size(), 1);
+  XCTAssertTrue(events[0].kind == MIDI2::Kind::noteOn);
+}
+
+- (void)testTruncatedMessage {
+  // Note on missing its second word, followed by a packet with a complete message.
+  EventListBuffer buffer({{0x20904064, 0x40904000}, {0x40804000, 0x00000000}});
+  auto events = decode(buffer);
+  XCTAssertEqual(events.size(), 2);
+  XCTAssertTrue(events[0].kind == MIDI2::Kind::noteOn);
+  XCTAssertTrue(events[1].kind == MIDI2::Kind::noteOff);
+}
+
+- (void)testDenseControllerSpeed {
+  // One packet holding 30 controller messages, repeated across 30 packets
+  auto buffer = std::make_shared<EventListBuffer>(std::initializer_list<std::initializer_list<UInt32>>{});
+  auto& storage = buffer->storage;
+  size_t pos = 2;
+  for (UInt32 packet = 0; packet < 15; ++packet) {
+    pos += 2;
+    storage[pos++] = 60;
+    for (UInt32 index = 0; index < 30; ++index) {
+      storage[pos++] = 0x40B00000 | (index << 8);
+      storage[pos++] = index * 0x01000000;
+    }
+  }
+  storage[1] = 15;
+
+  [self measureBlock:^{
+    UInt64 sum = 0;
+    for (int iteration = 0; iteration < 20'000; ++iteration) {
+      MIDI2::forEachEvent(buffer->list(), [&](const MIDI2::Event& event) { sum += event.value; });
+    }
+    XCTAssertTrue(sum > 0);
+  }];
+}
+
+@end
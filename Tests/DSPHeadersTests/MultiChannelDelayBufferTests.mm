@@ -0,0 +1,140 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <cmath>
+#import <memory>
+#import <vector>
+
+#import "DSPHeaders/DelayBuffer.hpp"
+#import "DSPHeaders/MultiChannelDelayBuffer.hpp"
+
+using namespace DSPHeaders;
+
+namespace {
+
+/// @returns a different signal for each channel
+std::vector<std::vector<float>> makeInput(size_t channelCount, size_t count) {
+  std::vector<std::vector<float>> input(channelCount, std::vector<float>(count));
+  for (size_t channel = 0; channel < channelCount; ++channel) {
+    for (size_t index = 0; index < count; ++index) {
+      input[channel][index] = std::sin(index * 0.1f * (channel + 1)) + 0.01f * index;
+    }
+  }
+  return input;
+}
+
+std::vector<const float*> inputPointers(const std::vector<std::vector<float>>& channels, size_t offset) {
+  std::vector<const float*> pointers;
+  for (const auto& channel : channels) pointers.push_back(channel.data() + offset);
+  return pointers;
+}
+
+std::vector<float*> outputPointers(std::vector<std::vector<float>>& channels) {
+  std::vector<float*> pointers;
+  for (auto& channel : channels) pointers.push_back(channel.data());
+  return pointers;
+}
+
+/// Number of frames to use in the speed tests.
+constexpr size_t blockSize = 512;
+
+}
+
+@interface MultiChannelDelayBufferTests : XCTestCase
+@end
+
+@implementation MultiChannelDelayBufferTests
+
+- (void)testSizing {
+  XCTAssertEqual((MultiChannelDelayBuffer<float, 2>(100.0).size()), 128);
+  XCTAssertEqual((MultiChannelDelayBuffer<float, 1>::frameStride), 1);
+  XCTAssertEqual((MultiChannelDelayBuffer<float, 2>::frameStride), 2);
+  XCTAssertEqual((MultiChannelDelayBuffer<float, 3>::frameStride), 4);
+  XCTAssertEqual((MultiChannelDelayBuffer<float, 6>::frameStride), 8);
+}
+
+- (void)testFrames {
+  MultiChannelDelayBuffer<float, 3> buffer(4);
+  buffer.write({1.0f, 2.0f, 3.0f});
+  buffer.write({4.0f, 5.0f, 6.0f});
+  XCTAssertEqual(buffer.readFromOffset(0), (std::array<float, 3>{4.0f, 5.0f, 6.0f}));
+  XCTAssertEqual(buffer.readFromOffset(1), (std::array<float, 3>{1.0f, 2.0f, 3.0f}));
+  XCTAssertEqual(buffer.readFromOffset(2), (std::array<float, 3>{0.0f, 0.0f, 0.0f}));
+  XCTAssertEqual(buffer.read(0.5f), (std::array<float, 3>{2.5f, 3.5f, 4.5f}));
+  buffer.clear();
+  XCTAssertEqual(buffer.readFromOffset(0), (std::array<float, 3>{0.0f, 0.0f, 0.0f}));
+}
+
+- (void)testMatchesDelayBuffers {
+  constexpr size_t channelCount = 6;
+  auto input = makeInput(channelCount, 200);
+  for (auto kind : {DelayBuffer<float>::Interpolator::linear, DelayBuffer<float>::Interpolator::hermite,
+    DelayBuffer<float>::Interpolator::lagrange5}) {
+    MultiChannelDelayBuffer<float, channelCount> buffer(64, kind);
+    std::vector<DelayBuffer<float>> references(channelCount, DelayBuffer<float>(64, kind));
+    std::vector<std::vector<float>> output(channelCount, std::vector<float>(13));
+    std::vector<float> expected(13);
+    std::vector<float> delays(13);
+    auto pointers = outputPointers(output);
+    for (size_t start = 0; start + 13 <= input[0].size(); start += 13) {
+      buffer.writeBlock(inputPointers(input, start), 13);
+      for (size_t channel = 0; channel < channelCount; ++channel) {
+        references[channel].writeBlock(std::span(input[channel]).subspan(start, 13));
+      }
+
+      for (float delay : {0.0f, 4.0f, 7.25f, 20.6f}) {
+        buffer.readBlock(pointers, 13, delay);
+        for (size_t channel = 0; channel < channelCount; ++channel) {
+          references[channel].readBlock(expected, delay);
+          for (size_t index = 0; index < 13; ++index) {
+            XCTAssertEqualWithAccuracy(output[channel][index], expected[index], 1.0e-6);
+          }
+        }
+      }
+
+      for (size_t index = 0; index < delays.size(); ++index) delays[index] = 12.0f + 9.0f * std::sin(start + index);
+      buffer.readBlock(pointers, delays);
+      for (size_t channel = 0; channel < channelCount; ++channel) {
+        references[channel].readBlock(expected, delays);
+        for (size_t index = 0; index < 13; ++index) {
+          XCTAssertEqualWithAccuracy(output[channel][index], expected[index], 1.0e-6);
+        }
+      }
+    }
+  }
+}
+
+- (void)testSeparateBuffersSpeed {
+  auto input = std::make_shared<std::vector<std::vector<float>>>(makeInput(2, blockSize));
+  auto output = std::make_shared<std::vector<std::vector<float>>>(makeInput(2, blockSize));
+  auto delays = std::make_shared<std::vector<float>>(blockSize);
+  for (size_t index = 0; index < blockSize; ++index) (*delays)[index] = 1000.0f + 100.0f * std::sin(index * 0.01f);
+  auto buffers = std::make_shared<std::vector<DelayBuffer<float>>>(
+    2, DelayBuffer<float>(8192, DelayBuffer<float>::Interpolator::hermite));
+  [self measureBlock:^{
+    for (int iteration = 0; iteration < 5'000; ++iteration) {
+      for (size_t channel = 0; channel < 2; ++channel) {
+        (*buffers)[channel].writeBlock((*input)[channel]);
+        (*buffers)[channel].readBlock((*output)[channel], *delays);
+      }
+    }
+  }];
+}
+
+- (void)testInterleavedBufferSpeed {
+  auto input = std::make_shared<std::vector<std::vector<float>>>(makeInput(2, blockSize));
+  auto output = std::make_shared<std::vector<std::vector<float>>>(makeInput(2, blockSize));
+  auto delays = std::make_shared<std::vector<float>>(blockSize);
+  for (size_t index = 0; index < blockSize; ++index) (*delays)[index] = 1000.0f + 100.0f * std::sin(index * 0.01f);
+  auto buffer = std::make_shared<MultiChannelDelayBuffer<float, 2>>(8192, DelayBuffer<float>::Interpolator::hermite);
+  auto sources = std::make_shared<std::vector<const float*>>(inputPointers(*input, 0));
+  auto destinations = std::make_shared<std::vector<float*>>(outputPointers(*output));
+  [self measureBlock:^{
+    for (int iteration = 0; iteration < 5'000; ++iteration) {
+      buffer->writeBlock(*sources, blockSize);
+      buffer->readBlock(*destinations, *delays);
+    }
+  }];
+}
+
+@end
@@ -0,0 +1,175 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <cstring>
+#import <vector>
+
+#import "DSPHeaders/EventProcessor.hpp"
+#import "DSPHeaders/OfflineRenderer.hpp"
+#import "DSPHeaders/Parameters/Float.hpp"
+
+using namespace DSPHeaders;
+
+struct MockOfflineKernel : public EventProcessor<MockOfflineKernel>
+{
+  using super = EventProcessor<MockOfflineKernel>;
+
+  MockOfflineKernel() : super("mock") { registerParameter(gain_); }
+
+  void doRendering(BusBuffers ins, BusBuffers outs, AUAudioFrameCount frameCount) {
+    frameCounts_.push_back(frameCount);
+    gainValues_.push_back(gain_.frameValue());
+    for (size_t channel = 0; channel < outs.size(); ++channel) {
+      for (AUAudioFrameCount frame = 0; frame < frameCount; ++frame) {
+        // There are no input samples when there is no pull-input block.
+        outs[channel][frame] = ins[channel] ? ins[channel][frame] * gain_.frameValue() : 0.0;
+      }
+    }
+  }
+
+  void doMIDIEvent(const AUMIDIEvent& midi) { midiStatus_.push_back(midi.data[0]); }
+
+  Parameters::Float gain_{0, 1.0, false};
+  std::vector<AUAudioFrameCount> frameCounts_{};
+  std::vector<AUValue> gainValues_{};
+  std::vector<UInt8> midiStatus_{};
+};
+
+ValidatedKernel<MockOfflineKernel> _mockOfflineKernel;
+
+@interface OfflineRendererTests : XCTestCase
+@end
+
+@implementation OfflineRendererTests
+
+- (void)testRenderBlockSizes {
+  MockOfflineKernel kernel;
+  OfflineRenderer<MockOfflineKernel> renderer(kernel, 44100.0, 2, 64);
+  renderer.setInput({std::vector<AUValue>(100, 0.5), std::vector<AUValue>(100, 0.25)});
+  renderer.setBlockSizes({64, 13});
+
+  XCTAssertEqual(renderer.render(200), noErr);
+  XCTAssertEqual(renderer.sampleTime(), 200);
+  XCTAssertEqual(kernel.frameCounts_, (std::vector<AUAudioFrameCount>{64, 13, 64, 13, 46}));
+
+  const auto& stats{renderer.statistics()};
+  XCTAssertEqual(stats.framesRendered, 200);
+  XCTAssertEqual(stats.renderCalls, 5);
+  XCTAssertEqual(stats.eventsDelivered, 0);
+  XCTAssertEqual(stats.sampleRate, 44100.0);
+  XCTAssertTrue(stats.renderSeconds >= stats.maxCallSeconds);
+
+  renderer.resetStatistics();
+  XCTAssertEqual(renderer.statistics().framesRendered, 0);
+  XCTAssertEqual(renderer.statistics().sampleRate, 44100.0);
+}
+
+- (void)testInvalidBlockSizes {
+  MockOfflineKernel kernel;
+  OfflineRenderer<MockOfflineKernel> renderer(kernel, 44100.0, 2, 64);
+  XCTAssertThrows(renderer.setBlockSizes({}));
+  XCTAssertThrows(renderer.setBlockSizes({0}));
+  XCTAssertThrows(renderer.setBlockSizes({65}));
+}
+
+- (void)testInputLoopsAndOutputHandler {
+  MockOfflineKernel kernel;
+  OfflineRenderer<MockOfflineKernel> renderer(kernel, 44100.0, 2, 8);
+  renderer.setInput({{1.0, 2.0, 3.0}});
+
+  std::vector<AUValue> left;
+  std::vector<AUValue> right;
+  renderer.setOutputHandler([&](const AudioBufferList& bufferList, AUAudioFrameCount frameCount) {
+    auto l = static_cast<const AUValue*>(bufferList.mBuffers[0].mData);
+    auto r = static_cast<const AUValue*>(bufferList.mBuffers[1].mData);
+    left.insert(left.end(), l, l + frameCount);
+    right.insert(right.end(), r, r + frameCount);
+  });
+
+  XCTAssertEqual(renderer.render(10), noErr);
+  XCTAssertEqual(left.size(), 10);
+  XCTAssertEqual(left, (std::vector<AUValue>{1, 2, 3, 1, 2, 3, 1, 2, 3, 1}));
+  XCTAssertEqual(right, left);
+}
+
+- (void)testInterleavedInput {
+  MockOfflineKernel kernel;
+  OfflineRenderer<MockOfflineKernel> renderer(kernel, 44100.0, 2, 8);
+  std::vector<int16_t> frames{8192, -8192, 16384, -16384, -32768, 0};
+  std::vector<std::byte> samples(frames.size() * sizeof(int16_t));
+  std::memcpy(samples.data(), frames.data(), samples.size());
+  renderer.setInput(samples, {SampleFormat::int16, 2, true});
+  XCTAssertThrows(renderer.setInput(samples, {SampleFormat::int16, 2, false}));
+
+  std::vector<AUValue> left;
+  std::vector<AUValue> right;
+  renderer.setOutputHandler([&](const AudioBufferList& bufferList, AUAudioFrameCount frameCount) {
+    auto l = static_cast<const AUValue*>(bufferList.mBuffers[0].mData);
+    auto r = static_cast<const AUValue*>(bufferList.mBuffers[1].mData);
+    left.insert(left.end(), l, l + frameCount);
+    right.insert(right.end(), r, r + frameCount);
+  });
+
+  XCTAssertEqual(renderer.render(10), noErr);
+  XCTAssertEqual(left, (std::vector<AUValue>{0.25, 0.5, -1.0, 0.25, 0.5, -1.0, 0.25, 0.5, -1.0, 0.25}));
+  XCTAssertEqual(right, (std::vector<AUValue>{-0.25, -0.5, 0.0, -0.25, -0.5, 0.0, -0.25, -0.5, 0.0, -0.25}));
+}
+
+- (void)testTooManyChannels {
+  MockOfflineKernel kernel;
+  XCTAssertThrows((OfflineRenderer<MockOfflineKernel>(kernel, 44100.0, 10, 16)));
+}
+
+- (void)testInPlace {
+  MockOfflineKernel kernel;
+  OfflineRenderer<MockOfflineKernel> renderer(kernel, 44100.0, 1, 16);
+  renderer.setInput({std::vector<AUValue>(16, 0.5)});
+  renderer.setInPlace(true);
+
+  AUValue last{0.0};
+  renderer.setOutputHandler([&](const AudioBufferList& bufferList, AUAudioFrameCount frameCount) {
+    XCTAssertNotEqual(bufferList.mBuffers[0].mData, nullptr);
+    last = static_cast<const AUValue*>(bufferList.mBuffers[0].mData)[frameCount - 1];
+  });
+
+  XCTAssertEqual(renderer.render(32), noErr);
+  XCTAssertEqual(last, 0.5);
+}
+
+- (void)testEventsSplitRendering {
+  MockOfflineKernel kernel;
+  OfflineRenderer<MockOfflineKernel> renderer(kernel, 44100.0, 2, 64);
+  renderer.setInput({std::vector<AUValue>(64, 1.0)});
+
+  // Add out of order to check sorting.
+  renderer.addParameterEvent(80, 0, 0.25);
+  renderer.addParameterEvent(10, 0, 0.5);
+  renderer.addMIDIEvent(70, 0x90, 64, 100);
+
+  XCTAssertEqual(renderer.render(128), noErr);
+  XCTAssertEqual(renderer.statistics().eventsDelivered, 3);
+  XCTAssertEqual(kernel.frameCounts_, (std::vector<AUAudioFrameCount>{10, 54, 6, 10, 48}));
+  XCTAssertEqual(kernel.gainValues_, (std::vector<AUValue>{1.0, 0.5, 0.5, 0.5, 0.25}));
+  XCTAssertEqual(kernel.midiStatus_, (std::vector<UInt8>{0x90}));
+
+  // Events from previous render calls are not delivered again.
+  renderer.addParameterEvent(130, 0, 0.75);
+  XCTAssertEqual(renderer.render(64), noErr);
+  XCTAssertEqual(renderer.statistics().eventsDelivered, 4);
+  XCTAssertEqual(kernel.gainValues_.back(), 0.75);
+}
+
+- (void)testNoInput {
+  MockOfflineKernel kernel;
+  OfflineRenderer<MockOfflineKernel> renderer(kernel, 48000.0, 2, 64);
+  AUValue peak{0.0};
+  renderer.setOutputHandler([&](const AudioBufferList& bufferList, AUAudioFrameCount frameCount) {
+    auto samples = static_cast<const AUValue*>(bufferList.mBuffers[0].mData);
+    for (AUAudioFrameCount frame = 0; frame < frameCount; ++frame) peak = std::max(peak, std::abs(samples[frame]));
+  });
+  XCTAssertEqual(renderer.render(48000), noErr);
+  XCTAssertEqual(peak, 0.0);
+  XCTAssertTrue(renderer.statistics().realTimeFactor() > 1.0);
+}
+
+@end
@@ -0,0 +1,192 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <cmath>
+#import <memory>
+#import <numbers>
+#import <vector>
+
+#import "DSPHeaders/Oversampler.hpp"
+
+using namespace DSPHeaders;
+
+namespace {
+
+/// Holds the sample buffers for a stereo bus
+struct Bus {
+  Bus(size_t frameCount) : samples(2, std::vector<AUValue>(frameCount)) {
+    for (auto& channel : samples) pointers.push_back(channel.data());
+  }
+
+  BusBuffers busBuffers() { return BusBuffers(pointers); }
+
+  std::vector<std::vector<AUValue>> samples;
+  std::vector<AUValue*> pointers{};
+};
+
+/// Use the Goertzel algorithm to obtain the magnitude of one frequency in a block of samples.
+double magnitude(const AUValue* samples, size_t count, double frequency, double sampleRate) {
+  auto coefficient = 2.0 * std::cos(2.0 * std::numbers::pi * frequency / sampleRate);
+  double s1 = 0.0;
+  double s2 = 0.0;
+  for (size_t index = 0; index < count; ++index) {
+    auto s0 = samples[index] + coefficient * s1 - s2;
+    s2 = s1;
+    s1 = s0;
+  }
+  return std::sqrt(s1 * s1 + s2 * s2 - coefficient * s1 * s2) / (count / 2.0);
+}
+
+/// Upsample the input and then decimate the result back to the original rate.
+void roundTrip(Oversampler& oversampler, Bus& input, Bus& output, AUAudioFrameCount frameCount) {
+  auto upsampled = oversampler.upsample(input.busBuffers(), frameCount);
+  auto rendered = oversampler.output();
+  for (size_t channel = 0; channel < upsampled.size(); ++channel) {
+    std::copy_n(upsampled[channel], frameCount * oversampler.factor(), rendered[channel]);
+  }
+  oversampler.downsample(output.busBuffers(), frameCount);
+}
+
+}
+
+@interface OversamplerTests : XCTestCase
+@end
+
+@implementation OversamplerTests
+
+- (void)testFactors {
+  Oversampler oversampler;
+  XCTAssertEqual(oversampler.factor(), 1);
+  XCTAssertEqual(oversampler.latency(), 0.0);
+
+  oversampler.allocate(2, 2, 64);
+  XCTAssertEqual(oversampler.factor(), 2);
+  XCTAssertEqual(oversampler.latency(), 23.0);
+
+  oversampler.allocate(4, 2, 64);
+  XCTAssertEqual(oversampler.factor(), 4);
+  XCTAssertEqual(oversampler.latency(), 26.5);
+
+  oversampler.allocate(8, 2, 64);
+  XCTAssertEqual(oversampler.factor(), 8);
+  XCTAssertEqual(oversampler.latency(), 28.25);
+
+  oversampler.allocate(3, 2, 64);
+  XCTAssertEqual(oversampler.factor(), 2);
+  oversampler.allocate(16, 2, 64);
+  XCTAssertEqual(oversampler.factor(), 8);
+  oversampler.allocate(1, 2, 64);
+  XCTAssertEqual(oversampler.factor(), 1);
+  XCTAssertEqual(oversampler.latency(), 0.0);
+}
+
+- (void)testUnityGain {
+  for (size_t factor : {2, 4, 8}) {
+    Oversampler oversampler;
+    AUAudioFrameCount frameCount = 64;
+    oversampler.allocate(factor, 2, frameCount);
+    Bus input(frameCount);
+    Bus output(frameCount);
+    for (auto& channel : input.samples) std::fill(channel.begin(), channel.end(), 1.0f);
+
+    // Once past the start-up transient, a constant signal comes out unchanged.
+    for (int iteration = 0; iteration < 4; ++iteration) roundTrip(oversampler, input, output, frameCount);
+    for (auto& channel : output.samples) {
+      for (auto sample : channel) XCTAssertEqualWithAccuracy(sample, 1.0, 1.0e-3);
+    }
+
+    // Also true for the samples at the higher rate.
+    auto upsampled = oversampler.upsample(input.busBuffers(), frameCount);
+    for (size_t frame = 0; frame < frameCount * factor; ++frame) {
+      XCTAssertEqualWithAccuracy(upsampled[0][frame], 1.0, 1.0e-3);
+    }
+  }
+}
+
+- (void)testDelayMatchesLatency {
+  for (size_t factor : {2, 4, 8}) {
+    Oversampler oversampler;
+    AUAudioFrameCount frameCount = 64;
+    oversampler.allocate(factor, 2, frameCount);
+    Bus input(frameCount);
+    Bus output(frameCount);
+    input.samples[0][0] = 1.0;
+    roundTrip(oversampler, input, output, frameCount);
+
+    auto& samples{output.samples[0]};
+    auto peak = std::max_element(samples.begin(), samples.end()) - samples.begin();
+    XCTAssertEqual(peak, long(std::floor(oversampler.latency())));
+  }
+}
+
+- (void)testImageRejection {
+  Oversampler oversampler;
+  AUAudioFrameCount frameCount = 1024;
+  double sampleRate = 48000.0;
+  oversampler.allocate(2, 2, frameCount);
+  Bus input(frameCount);
+  for (AUAudioFrameCount frame = 0; frame < frameCount; ++frame) {
+    input.samples[0][frame] = std::sin(2.0 * std::numbers::pi * 5000.0 * frame / sampleRate);
+  }
+
+  // Zero-stuffing creates an image of the signal at 48 - 5 = 43 kHz which the filter must remove. Skip the start-up
+  // transient before measuring.
+  auto upsampled = oversampler.upsample(input.busBuffers(), frameCount);
+  auto start = upsampled[0] + 128;
+  auto count = frameCount * 2 - 128;
+  auto signal = magnitude(start, count, 5000.0, sampleRate * 2);
+  auto image = magnitude(start, count, 43000.0, sampleRate * 2);
+  XCTAssertEqualWithAccuracy(signal, 1.0, 0.01);
+  XCTAssertLessThan(image, 1.0e-3);
+}
+
+- (void)testAliasRejection {
+  Oversampler oversampler;
+  AUAudioFrameCount frameCount = 1024;
+  double sampleRate = 48000.0;
+  oversampler.allocate(2, 2, frameCount);
+  Bus output(frameCount);
+
+  // Content at 30 kHz created at the higher rate would alias down to 18 kHz without filtering.
+  auto rendered = oversampler.output();
+  for (AUAudioFrameCount frame = 0; frame < frameCount * 2; ++frame) {
+    rendered[0][frame] = std::sin(2.0 * std::numbers::pi * 30000.0 * frame / (sampleRate * 2));
+    rendered[1][frame] = 0.0;
+  }
+  oversampler.downsample(output.busBuffers(), frameCount);
+  XCTAssertLessThan(magnitude(output.samples[0].data() + 64, frameCount - 64, 18000.0, sampleRate), 1.0e-3);
+}
+
+- (void)testReset {
+  Oversampler oversampler;
+  AUAudioFrameCount frameCount = 64;
+  oversampler.allocate(4, 2, frameCount);
+  Bus input(frameCount);
+  Bus output(frameCount);
+  for (auto& channel : input.samples) std::fill(channel.begin(), channel.end(), 1.0f);
+  roundTrip(oversampler, input, output, frameCount);
+
+  oversampler.reset();
+  for (auto& channel : input.samples) std::fill(channel.begin(), channel.end(), 0.0f);
+  roundTrip(oversampler, input, output, frameCount);
+  for (auto& channel : output.samples) {
+    for (auto sample : channel) XCTAssertEqual(sample, 0.0);
+  }
+}
+
+- (void)testRoundTripSpeed {
+  auto oversampler = std::make_shared<Oversampler>();
+  AUAudioFrameCount frameCount = 512;
+  oversampler->allocate(4, 2, frameCount);
+  auto input = std::make_shared<Bus>(frameCount);
+  auto output = std::make_shared<Bus>(frameCount);
+  for (AUAudioFrameCount frame = 0; frame < frameCount; ++frame) {
+    input->samples[0][frame] = input->samples[1][frame] = std::sin(frame * 0.1);
+  }
+
+  [self measureBlock:^{
+    for (int iteration = 0; iteration < 1'000; ++iteration) roundTrip(*oversampler, *input, *output, frameCount);
+  }];
+}
+
+@end
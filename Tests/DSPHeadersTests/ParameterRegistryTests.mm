@@ -0,0 +1,229 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <functional>
+#import <memory>
+#import <unordered_map>
+#import <vector>
+
+#import "DSPHeaders/Parameters/Float.hpp"
+#import "DSPHeaders/Parameters/Registry.hpp"
+
+using namespace DSPHeaders::Parameters;
+
+@interface ParameterRegistryTests : XCTestCase
+@end
+
+@implementation ParameterRegistryTests
+
+static constexpr size_t parameterCount = 48;
+static constexpr size_t renderCalls = 20'000;
+static constexpr size_t eventsPerRenderCall = 16;
+
+static std::vector<std::unique_ptr<Float>> makeParameters(size_t count = parameterCount) {
+  std::vector<std::unique_ptr<Float>> params;
+  for (size_t index = 0; index < count; ++index) {
+    params.push_back(std::make_unique<Float>(AUParameterAddress(index), 0.0));
+  }
+  return params;
+}
+
+- (void)testEmpty {
+  Registry registry;
+  XCTAssertTrue(registry.empty());
+  XCTAssertEqual(registry.size(), 0);
+  XCTAssertEqual(registry.find(0), nullptr);
+  XCTAssertEqual(registry.find(123'456), nullptr);
+  XCTAssertTrue(registry.begin() == registry.end());
+}
+
+- (void)testDirectAddresses {
+  Float a{0, 1.0};
+  Float b{5, 2.0};
+  Float c{3, 3.0};
+  Registry registry;
+  XCTAssertTrue(registry.add(a));
+  XCTAssertTrue(registry.add(b));
+  XCTAssertTrue(registry.add(c));
+  XCTAssertEqual(registry.size(), 3);
+  XCTAssertEqual(registry.find(0), &a);
+  XCTAssertEqual(registry.find(5), &b);
+  XCTAssertEqual(registry.find(3), &c);
+  XCTAssertEqual(registry.find(1), nullptr);
+  XCTAssertEqual(registry.find(6), nullptr);
+}
+
+- (void)testSparseAddresses {
+  Float a{Registry::maxDirectAddress + 10, 1.0};
+  Float b{1, 2.0};
+  Float c{0xFFFFFFFF00ULL, 3.0};
+  Float d{Registry::maxDirectAddress, 4.0};
+  Registry registry;
+  XCTAssertTrue(registry.add(a));
+  XCTAssertTrue(registry.add(b));
+  XCTAssertTrue(registry.add(c));
+  XCTAssertTrue(registry.add(d));
+  XCTAssertEqual(registry.find(Registry::maxDirectAddress + 10), &a);
+  XCTAssertEqual(registry.find(1), &b);
+  XCTAssertEqual(registry.find(0xFFFFFFFF00ULL), &c);
+  XCTAssertEqual(registry.find(Registry::maxDirectAddress), &d);
+  XCTAssertEqual(registry.find(Registry::maxDirectAddress + 1), nullptr);
+  XCTAssertEqual(registry.find(0xFFFFFFFF01ULL), nullptr);
+}
+
+- (void)testDuplicates {
+  Float a{7, 1.0};
+  Float b{7, 2.0};
+  Float c{2000, 1.0};
+  Float d{2000, 2.0};
+  Registry registry;
+  XCTAssertTrue(registry.add(a));
+  XCTAssertFalse(registry.add(b));
+  XCTAssertTrue(registry.add(c));
+  XCTAssertFalse(registry.add(d));
+  XCTAssertEqual(registry.size(), 2);
+  XCTAssertEqual(registry.find(7), &a);
+  XCTAssertEqual(registry.find(2000), &c);
+}
+
+- (void)testIterationOrder {
+  Float a{9, 1.0};
+  Float b{2, 2.0};
+  Float c{4000, 3.0};
+  Registry registry;
+  registry.add(a);
+  registry.add(b);
+  registry.add(c);
+  std::vector<AUParameterAddress> addresses;
+  for (auto param : registry) addresses.push_back(param->address());
+  XCTAssertEqual(addresses, (std::vector<AUParameterAddress>{9, 2, 4000}));
+}
+
+- (void)testCheckForValueChanges {
+  Float a{0, 0.0};
+  Float b{1, 0.0};
+  Registry registry;
+  registry.add(a);
+  registry.add(b);
+
+  // Newly-registered parameters are visited once, but nothing has changed.
+  XCTAssertFalse(registry.checkForValueChanges(4));
+  XCTAssertFalse(registry.checkForValueChanges(4));
+
+  b.setPending(8.0);
+  XCTAssertTrue(registry.checkForValueChanges(4));
+  XCTAssertEqual(a.frameValue(), 0.0);
+  XCTAssertEqual(b.frameValue(), 2.0);
+
+  // Parameter is still visited while ramping even though nothing new was posted.
+  XCTAssertFalse(registry.checkForValueChanges(4));
+  XCTAssertEqual(b.frameValue(), 4.0);
+  XCTAssertFalse(registry.checkForValueChanges(4));
+  XCTAssertEqual(b.frameValue(), 6.0);
+  XCTAssertFalse(registry.checkForValueChanges(4));
+  XCTAssertEqual(b.frameValue(), 8.0);
+  XCTAssertFalse(b.isRamping());
+  XCTAssertFalse(registry.checkForValueChanges(4));
+  XCTAssertEqual(b.frameValue(), 8.0);
+}
+
+- (void)testCheckForValueChangesAfterSetImmediate {
+  Float a{0, 0.0};
+  Registry registry;
+  registry.add(a);
+  registry.checkForValueChanges(4);
+
+  // Ramp started by the render thread continues in later render passes.
+  a.setImmediate(3.0, 3);
+  XCTAssertEqual(a.frameValue(), 1.0);
+  XCTAssertFalse(registry.checkForValueChanges(4));
+  XCTAssertEqual(a.frameValue(), 2.0);
+  XCTAssertFalse(registry.checkForValueChanges(4));
+  XCTAssertEqual(a.frameValue(), 3.0);
+  XCTAssertFalse(a.isRamping());
+}
+
+- (void)testCheckForValueChangesManyParameters {
+  auto params = makeParameters(200);
+  Registry registry;
+  for (auto& param : params) registry.add(*param);
+  registry.checkForValueChanges(1);
+
+  params[3]->setPending(1.0);
+  params[64]->setPending(2.0);
+  params[199]->setPending(3.0);
+  registry.checkForValueChanges(1);
+  for (size_t index = 0; index < params.size(); ++index) {
+    auto expected = index == 3 ? 1.0 : index == 64 ? 2.0 : index == 199 ? 3.0 : 0.0;
+    XCTAssertEqual(params[index]->frameValue(), expected);
+  }
+}
+
+// Simulate event-heavy automation: each render call looks up and sets a number of parameters as would happen in
+// `EventProcessor::processEventsUntil`, and then visits all of them as in `checkForParameterValueChanges`.
+
+- (void)testUnorderedMapAutomationSpeed {
+  auto params = makeParameters();
+  std::unordered_map<AUParameterAddress, std::reference_wrapper<Base>> map;
+  for (auto& param : params) map.emplace(param->address(), *param);
+
+  [self measureBlock:^{
+    for (size_t call = 0; call < renderCalls; ++call) {
+      for (size_t event = 0; event < eventsPerRenderCall; ++event) {
+        auto pos = map.find(AUParameterAddress((call * 7 + event * 13) % parameterCount));
+        if (pos != map.end()) pos->second.get().setImmediate(AUValue(event), 4);
+      }
+      for (auto param : map) param.second.get().checkForValueChange(16);
+    }
+  }];
+}
+
+- (void)testRegistryAutomationSpeed {
+  auto params = makeParameters();
+  // Blocks copy captured C++ objects, so hold the registry by a shared pointer.
+  auto registry = std::make_shared<Registry>();
+  for (auto& param : params) registry->add(*param);
+
+  [self measureBlock:^{
+    for (size_t call = 0; call < renderCalls; ++call) {
+      for (size_t event = 0; event < eventsPerRenderCall; ++event) {
+        auto param = registry->find(AUParameterAddress((call * 7 + event * 13) % parameterCount));
+        if (param != nullptr) param->setImmediate(AUValue(event), 4);
+      }
+      for (auto param : *registry) param->checkForValueChange(16);
+    }
+  }];
+}
+
+// Simulate render calls where the UI only rarely changes a parameter. Compare visiting every parameter with visiting
+// only those flagged in the registry's dirty set.
+
+- (void)testVisitAllIdleSpeed {
+  auto params = makeParameters();
+  auto registry = std::make_shared<Registry>();
+  for (auto& param : params) registry->add(*param);
+  std::vector<Base*> targets{registry->begin(), registry->end()};
+
+  [self measureBlock:^{
+    for (size_t call = 0; call < renderCalls * 10; ++call) {
+      if (call % 1000 == 0) targets[call % parameterCount]->setPending(AUValue(call));
+      for (auto param : *registry) param->checkForValueChange(16);
+    }
+  }];
+}
+
+- (void)testDirtySetIdleSpeed {
+  auto params = makeParameters();
+  auto registry = std::make_shared<Registry>();
+  for (auto& param : params) registry->add(*param);
+  std::vector<Base*> targets{registry->begin(), registry->end()};
+
+  [self measureBlock:^{
+    for (size_t call = 0; call < renderCalls * 10; ++call) {
+      if (call % 1000 == 0) targets[call % parameterCount]->setPending(AUValue(call));
+      registry->checkForValueChanges(16);
+    }
+  }];
+}
+
+@end
@@ -0,0 +1,241 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <memory>
+#import <vector>
+
+#import "DSPHeaders/Biquad.hpp"
+#import "DSPHeaders/DelayBuffer.hpp"
+#import "DSPHeaders/LFO.hpp"
+#import "DSPHeaders/Pipeline.hpp"
+
+using namespace DSPHeaders;
+
+namespace {
+
+/**
+ Stereo flanger that can render with a fused pipeline or with a pass over the block for each step.
+ */
+struct Flanger {
+  static constexpr AUAudioFrameCount frameCount = 512;
+  static constexpr AUValue depth = 40.0;
+  static constexpr AUValue offset = 50.0;
+  static constexpr AUValue feedback = 0.3;
+  static constexpr AUValue wetLevel = 0.4;
+  static constexpr AUValue gain = 0.8;
+
+  Flanger() : frequency{1, 2.0}, lfo(frequency, 48000.0, LFOWaveform::triangle),
+  delays(2, DelayBuffer<AUValue>(1024.0)), inputs(2, std::vector<AUValue>(frameCount)),
+  output(2, std::vector<AUValue>(frameCount)), modulation(frameCount), delayed(frameCount) {
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+      inputs[0][frame] = std::sin(frame * 0.05f);
+      inputs[1][frame] = std::cos(frame * 0.03f);
+    }
+    for (auto& channel : output) pointers.push_back(channel.data());
+  }
+
+  void fused() {
+    using namespace Pipeline;
+    render(BusBuffers(pointers), frameCount, Pipeline::lfo(lfo) * depth + offset, [&](size_t channel, auto delay) {
+      auto ins = inputs[channel].data();
+      auto wet = delayLine(delays[channel], delay, input(ins), feedback);
+      return mix(input(ins), wet, wetLevel) * gain;
+    });
+  }
+
+  void multiPass() {
+    for (auto& value : modulation) {
+      value = lfo.value() * depth + offset;
+      lfo.increment();
+    }
+    for (size_t channel = 0; channel < 2; ++channel) {
+      auto& delay{delays[channel]};
+      auto& ins{inputs[channel]};
+      auto& outs{output[channel]};
+      for (size_t frame = 0; frame < frameCount; ++frame) {
+        delayed[frame] = delay.read(modulation[frame]);
+        delay.write(ins[frame] + feedback * delayed[frame]);
+      }
+      for (size_t frame = 0; frame < frameCount; ++frame) {
+        outs[frame] = ins[frame] * (1.0f - wetLevel) + delayed[frame] * wetLevel;
+      }
+      for (size_t frame = 0; frame < frameCount; ++frame) outs[frame] *= gain;
+    }
+  }
+
+  Parameters::Float frequency;
+  LFO<AUValue> lfo;
+  std::vector<DelayBuffer<AUValue>> delays;
+  std::vector<std::vector<AUValue>> inputs;
+  std::vector<std::vector<AUValue>> output;
+  std::vector<AUValue*> pointers{};
+  std::vector<AUValue> modulation;
+  std::vector<AUValue> delayed;
+};
+
+/**
+ Channel strip of cheap steps -- gain ramp, send mix, filter and soft clip -- over a large block, where the cost of
+ moving samples between passes matters more than the math.
+ */
+struct Strip {
+  static constexpr AUAudioFrameCount frameCount = 4096;
+  static constexpr AUValue send = 0.5;
+
+  Strip() : filter(Biquad::Coefficients<AUValue>::LPF2(48000.0, 8000.0, 0.707)), dry(frameCount),
+  returns(frameCount), output(frameCount) {
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+      dry[frame] = std::sin(frame * 0.05f);
+      returns[frame] = std::cos(frame * 0.03f);
+    }
+  }
+
+  static AUValue clip(AUValue value) noexcept { return value / (1.0f + std::abs(value)); }
+
+  void fused() {
+    using namespace Pipeline;
+    render(output.data(), frameCount,
+           map(Pipeline::filter(filter, input(dry.data()) * ramp(0.0, 1.0, frameCount) + input(returns.data()) * send),
+               clip));
+  }
+
+  void multiPass() {
+    auto step = 1.0f / frameCount;
+    for (size_t frame = 0; frame < frameCount; ++frame) output[frame] = dry[frame] * (step * frame);
+    for (size_t frame = 0; frame < frameCount; ++frame) output[frame] += returns[frame] * send;
+    for (size_t frame = 0; frame < frameCount; ++frame) output[frame] = filter.transform(output[frame]);
+    for (size_t frame = 0; frame < frameCount; ++frame) output[frame] = clip(output[frame]);
+  }
+
+  Biquad::Direct<AUValue> filter;
+  std::vector<AUValue> dry;
+  std::vector<AUValue> returns;
+  std::vector<AUValue> output;
+};
+
+}
+
+@interface PipelineTests : XCTestCase
+@end
+
+@implementation PipelineTests
+
+- (void)testArithmetic {
+  using namespace Pipeline;
+  std::vector<AUValue> samples{1.0, 2.0, 3.0, 4.0};
+  std::vector<AUValue> results(4);
+
+  render(results.data(), 4, input(samples.data()) * 2 + 1);
+  XCTAssertEqual(results, (std::vector<AUValue>{3.0, 5.0, 7.0, 9.0}));
+
+  render(results.data(), 4, 10 - input(samples.data()) * ramp(0.0, 1.0, 4));
+  XCTAssertEqual(results, (std::vector<AUValue>{10.0, 9.5, 8.5, 7.0}));
+
+  render(results.data(), 4, map(input(samples.data()), [](AUValue value) { return value * value; }));
+  XCTAssertEqual(results, (std::vector<AUValue>{1.0, 4.0, 9.0, 16.0}));
+
+  // In-place rendering
+  render(samples.data(), 4, mix(input(samples.data()), 0.0, 0.25));
+  XCTAssertEqual(samples, (std::vector<AUValue>{0.75, 1.5, 2.25, 3.0}));
+}
+
+- (void)testFilter {
+  using namespace Pipeline;
+  auto coefficients = Biquad::Coefficients<AUValue>::LPF2(48000.0, 1000.0, 0.707);
+  Biquad::Canonical<AUValue> expected(coefficients);
+  Biquad::Canonical<AUValue> filtered(coefficients);
+  std::vector<AUValue> samples(64);
+  for (size_t frame = 0; frame < samples.size(); ++frame) samples[frame] = frame % 8 < 4 ? 1.0 : -1.0;
+
+  std::vector<AUValue> results(64);
+  render(results.data(), 64, filter(filtered, input(samples.data()) * 0.5));
+  for (size_t frame = 0; frame < samples.size(); ++frame) {
+    XCTAssertEqualWithAccuracy(results[frame], expected.transform(samples[frame] * 0.5f), 1.0e-6);
+  }
+}
+
+- (void)testDelayLine {
+  using namespace Pipeline;
+  DelayBuffer<AUValue> delay(8.0);
+  std::vector<AUValue> samples{1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+  std::vector<AUValue> results(6);
+
+  // A delay of 2 samples returns what was written 3 frames before since the read comes first.
+  render(results.data(), 6, delayLine(delay, 2, input(samples.data())));
+  XCTAssertEqual(results, (std::vector<AUValue>{0.0, 0.0, 0.0, 1.0, 2.0, 3.0}));
+
+  delay.clear();
+  render(results.data(), 6, delayLine(delay, 0, input(samples.data()), 0.5));
+  XCTAssertEqual(results, (std::vector<AUValue>{0.0, 1.0, 2.5, 4.25, 6.125, 8.0625}));
+}
+
+- (void)testSharedByChannels {
+  using namespace Pipeline;
+  Flanger flanger;
+  auto first = flanger.lfo.value();
+  std::vector<AUValue> left(8);
+  std::vector<AUValue> right(8);
+  std::vector<AUValue*> pointers{left.data(), right.data()};
+  render(BusBuffers(pointers), 8, lfo(flanger.lfo), [](size_t channel, auto shared) { return shared * (channel + 1); });
+  XCTAssertEqual(left[0], first);
+  for (size_t frame = 0; frame < 8; ++frame) XCTAssertEqual(right[frame], left[frame] * 2);
+
+  // The LFO advanced once per frame, not once per frame for each channel.
+  Flanger expected;
+  for (int frame = 0; frame < 8; ++frame) expected.lfo.increment();
+  XCTAssertEqual(flanger.lfo.phase(), expected.lfo.phase());
+}
+
+- (void)testFusedMatchesMultiPass {
+  Flanger fused;
+  Flanger multiPass;
+  for (int iteration = 0; iteration < 4; ++iteration) {
+    fused.fused();
+    multiPass.multiPass();
+    for (size_t channel = 0; channel < 2; ++channel) {
+      for (size_t frame = 0; frame < Flanger::frameCount; ++frame) {
+        XCTAssertEqualWithAccuracy(fused.output[channel][frame], multiPass.output[channel][frame], 1.0e-6);
+      }
+    }
+  }
+  XCTAssertEqualWithAccuracy(fused.lfo.phase(), multiPass.lfo.phase(), 1.0e-6);
+}
+
+- (void)testStripFusedMatchesMultiPass {
+  Strip fused;
+  Strip multiPass;
+  fused.fused();
+  multiPass.multiPass();
+  for (size_t frame = 0; frame < Strip::frameCount; ++frame) {
+    XCTAssertEqualWithAccuracy(fused.output[frame], multiPass.output[frame], 1.0e-5);
+  }
+}
+
+- (void)testStripMultiPassSpeed {
+  auto strip = std::make_shared<Strip>();
+  [self measureBlock:^{
+    for (int iteration = 0; iteration < 500; ++iteration) strip->multiPass();
+  }];
+}
+
+- (void)testStripFusedSpeed {
+  auto strip = std::make_shared<Strip>();
+  [self measureBlock:^{
+    for (int iteration = 0; iteration < 500; ++iteration) strip->fused();
+  }];
+}
+
+- (void)testMultiPassSpeed {
+  auto flanger = std::make_shared<Flanger>();
+  [self measureBlock:^{
+    for (int iteration = 0; iteration < 2'000; ++iteration) flanger->multiPass();
+  }];
+}
+
+- (void)testFusedSpeed {
+  auto flanger = std::make_shared<Flanger>();
+  [self measureBlock:^{
+    for (int iteration = 0; iteration < 2'000; ++iteration) flanger->fused();
+  }];
+}
+
+@end
@@ -49,6 +49,20 @@ using namespace DSPHeaders::Parameters;
   XCTAssertEqual(param.getImmediate(), 1.0);
 }
 
+- (void)testRampingInSteps {
+  auto param = Float(2);
+  param.setPending(1.0);
+  XCTAssertTrue(param.checkForValueChange(8, 2));
+  XCTAssertEqual(param.frameValue(), 0.25);
+  XCTAssertFalse(param.checkForValueChange(8, 2));
+  XCTAssertEqual(param.frameValue(), 0.5);
+  XCTAssertFalse(param.checkForValueChange(8, 3));
+  XCTAssertEqual(param.frameValue(), 0.875);
+  XCTAssertFalse(param.checkForValueChange(8, 3));
+  XCTAssertEqual(param.frameValue(), 1.0);
+  XCTAssertFalse(param.isRamping());
+}
+
 - (void)testReRamping {
   auto param = Float(3);
   AUAudioFrameCount rampDuration{4};
@@ -102,4 +116,72 @@ using namespace DSPHeaders::Parameters;
   XCTAssertFalse(param.isRamping());
 }
 
+- (void)testFillFrameValuesConstant {
+  auto param = Float(7, 0.5);
+  std::vector<AUValue> values(8, -1.0);
+  XCTAssertFalse(param.fillFrameValues(values));
+  XCTAssertEqual(values, std::vector<AUValue>(8, -1.0));
+  XCTAssertEqual(param.frameValue(), 0.5);
+}
+
+- (void)testFillFrameValuesRamp {
+  auto param = Float(8);
+  param.setImmediate(1.0, 4);
+  std::vector<AUValue> values(6);
+  XCTAssertTrue(param.fillFrameValues(values));
+  XCTAssertEqual(values, (std::vector<AUValue>{0.25, 0.5, 0.75, 1.0, 1.0, 1.0}));
+  XCTAssertFalse(param.isRamping());
+  XCTAssertEqual(param.frameValue(), 1.0);
+  XCTAssertFalse(param.fillFrameValues(values));
+}
+
+- (void)testFillFrameValuesAcrossBlocks {
+  auto param = Float(9);
+  param.setImmediate(8.0, 8);
+  std::vector<AUValue> values(3);
+  XCTAssertTrue(param.fillFrameValues(values));
+  XCTAssertEqual(values, (std::vector<AUValue>{1.0, 2.0, 3.0}));
+  XCTAssertEqual(param.frameValue(), 4.0);
+
+  // Render pass check does not move a ramp that is advanced per frame.
+  XCTAssertFalse(param.checkForValueChange(8));
+  XCTAssertEqual(param.frameValue(), 4.0);
+
+  XCTAssertTrue(param.fillFrameValues(values));
+  XCTAssertEqual(values, (std::vector<AUValue>{4.0, 5.0, 6.0}));
+  XCTAssertTrue(param.fillFrameValues(values));
+  XCTAssertEqual(values, (std::vector<AUValue>{7.0, 8.0, 8.0}));
+  XCTAssertFalse(param.isRamping());
+  XCTAssertEqual(param.frameValue(), 8.0);
+}
+
+- (void)testFillFrameValuesExactEnd {
+  auto param = Float(10);
+  param.setImmediate(4.0, 4);
+  std::vector<AUValue> values(3);
+  XCTAssertTrue(param.fillFrameValues(values));
+  XCTAssertEqual(values, (std::vector<AUValue>{1.0, 2.0, 3.0}));
+  XCTAssertFalse(param.isRamping());
+  XCTAssertEqual(param.frameValue(), 4.0);
+}
+
+- (void)testFillFrameValuesNewRamp {
+  auto param = Float(11);
+  param.setImmediate(8.0, 8);
+  std::vector<AUValue> values(2);
+  param.fillFrameValues(values);
+  XCTAssertEqual(param.frameValue(), 3.0);
+
+  // A new pending value starts a new ramp at the next render pass, which moves per render pass again until it is
+  // advanced per frame.
+  param.setPending(0.0);
+  XCTAssertTrue(param.checkForValueChange(3));
+  XCTAssertEqual(param.frameValue(), 2.0);
+  XCTAssertFalse(param.checkForValueChange(3));
+  XCTAssertEqual(param.frameValue(), 1.0);
+  XCTAssertTrue(param.fillFrameValues(values));
+  XCTAssertEqual(values, (std::vector<AUValue>{1.0, 0.0}));
+  XCTAssertFalse(param.isRamping());
+}
+
 @end
@@ -0,0 +1,114 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <cstdlib>
+#import <memory>
+#import <mutex>
+#import <vector>
+
+#import "DSPHeaders/RenderGuard.hpp"
+
+using namespace DSPHeaders;
+
+/// Holds allocations so that the compiler cannot remove them
+static void* volatile sink;
+
+static void allocateAndFree() {
+  auto value = new int(1);
+  sink = value;
+  delete value;
+}
+
+@interface RenderGuardTests : XCTestCase
+@end
+
+@implementation RenderGuardTests
+
+- (void)setUp {
+  RenderGuard::prepare();
+  RenderGuard::reset();
+}
+
+#if DSPHEADERS_RENDER_GUARD_ENABLED
+
+- (void)testIgnoresUnwatchedThread {
+  XCTAssertFalse(RenderGuard::isWatching());
+  auto value = std::make_unique<int>(1);
+  value.reset();
+  XCTAssertEqual(RenderGuard::violationCount(), 0);
+}
+
+- (void)testDetectsNewAndDelete {
+  {
+    RenderGuard::Scope scope;
+    XCTAssertTrue(RenderGuard::isWatching());
+    allocateAndFree();
+  }
+  XCTAssertFalse(RenderGuard::isWatching());
+  XCTAssertEqual(RenderGuard::violationCount(), 2);
+  XCTAssertEqual(RenderGuard::violation(0).kind, RenderGuard::Kind::allocation);
+  XCTAssertEqual(RenderGuard::violation(0).size, sizeof(int));
+  XCTAssertGreaterThan(RenderGuard::violation(0).stackDepth, 0);
+  XCTAssertEqual(RenderGuard::violation(1).kind, RenderGuard::Kind::deallocation);
+
+  auto description = RenderGuard::describe(0);
+  XCTAssertEqual(description.rfind("allocation of 4 bytes", 0), 0);
+}
+
+- (void)testDetectsContainerGrowth {
+  std::vector<float> values;
+  {
+    RenderGuard::Scope scope;
+    values.push_back(1.0);
+  }
+  XCTAssertEqual(RenderGuard::violationCount(), 1);
+
+  // No allocation when there is room.
+  RenderGuard::reset();
+  values.reserve(16);
+  {
+    RenderGuard::Scope scope;
+    values.push_back(2.0);
+  }
+  XCTAssertEqual(RenderGuard::violationCount(), 0);
+}
+
+- (void)testSuspend {
+  RenderGuard::Scope scope;
+  {
+    RenderGuard::Suspend suspend;
+    XCTAssertFalse(RenderGuard::isWatching());
+    allocateAndFree();
+  }
+  XCTAssertTrue(RenderGuard::isWatching());
+  XCTAssertEqual(RenderGuard::violationCount(), 0);
+}
+
+- (void)testKeepsFirstViolations {
+  {
+    RenderGuard::Scope scope;
+    for (size_t index = 0; index < RenderGuard::maxViolations + 4; ++index) allocateAndFree();
+  }
+  XCTAssertEqual(RenderGuard::violationCount(), 2 * (RenderGuard::maxViolations + 4));
+  XCTAssertEqual(RenderGuard::violation(RenderGuard::maxViolations - 1).kind, RenderGuard::Kind::deallocation);
+}
+
+- (void)testDetectsMallocAndLock {
+  if (!RenderGuard::detectsLocks) return;
+  std::mutex mutex;
+  {
+    RenderGuard::Scope scope;
+    sink = std::malloc(16);
+    std::free(sink);
+    std::lock_guard<std::mutex> lock(mutex);
+  }
+  XCTAssertEqual(RenderGuard::violationCount(), 3);
+  XCTAssertEqual(RenderGuard::violation(0).kind, RenderGuard::Kind::allocation);
+  XCTAssertEqual(RenderGuard::violation(0).size, 16);
+  XCTAssertEqual(RenderGuard::violation(1).kind, RenderGuard::Kind::deallocation);
+  XCTAssertEqual(RenderGuard::violation(2).kind, RenderGuard::Kind::lock);
+}
+
+#endif
+
+@end
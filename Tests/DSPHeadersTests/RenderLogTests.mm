@@ -0,0 +1,164 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <cinttypes>
+#import <memory>
+#import <string>
+#import <thread>
+#import <vector>
+
+#import "DSPHeaders/RenderLog.hpp"
+
+using namespace DSPHeaders;
+
+@interface RenderLogTests : XCTestCase
+@end
+
+@implementation RenderLogTests
+
+- (void)testPostAndDrain {
+  RenderLog log(os_log_create("RenderLogTests", "test"), 8);
+  log.allocate();
+  XCTAssertEqual(log.capacity(), 8);
+  XCTAssertTrue(log.post("no args"));
+  XCTAssertTrue(log.post("param %llu %f", 12ULL, AUValue(0.5)));
+  XCTAssertTrue(log.post("%d %c %u %.2f", -3, 'x', 7U, 1.25));
+
+  std::vector<std::string> messages;
+  XCTAssertEqual(log.drain([&](const char* message) { messages.emplace_back(message); }), 3);
+  XCTAssertEqual(messages, (std::vector<std::string>{"no args", "param 12 0.500000", "-3 x 7 1.25"}));
+  XCTAssertEqual(log.drain([&](const char* message) { messages.emplace_back(message); }), 0);
+}
+
+- (void)testParameterAddress {
+  RenderLog log(os_log_create("RenderLogTests", "test"), 4);
+  log.allocate();
+  AUParameterAddress address = 0x100000002;
+  XCTAssertTrue(log.post("param %" PRIu64 " %u", address, AUAudioFrameCount(16)));
+
+  std::vector<std::string> messages;
+  log.drain([&](const char* message) { messages.emplace_back(message); });
+  XCTAssertEqual(messages, (std::vector<std::string>{"param 4294967298 16"}));
+}
+
+- (void)testCapacityRoundsUp {
+  RenderLog log(os_log_create("RenderLogTests", "test"), 100);
+  log.allocate();
+  XCTAssertEqual(log.capacity(), 128);
+}
+
+- (void)testDropsWhenFull {
+  RenderLog log(os_log_create("RenderLogTests", "test"), 4);
+  log.allocate();
+  for (int index = 0; index < 4; ++index) XCTAssertTrue(log.post("%d", index));
+  XCTAssertFalse(log.post("%d", 4));
+  XCTAssertEqual(log.dropped(), 1);
+
+  std::vector<std::string> messages;
+  log.drain([&](const char* message) { messages.emplace_back(message); });
+  XCTAssertEqual(messages, (std::vector<std::string>{"0", "1", "2", "3"}));
+
+  // Space is available again after draining, and the ring wraps around.
+  for (int index = 0; index < 4; ++index) XCTAssertTrue(log.post("%d", index + 10));
+  messages.clear();
+  log.drain([&](const char* message) { messages.emplace_back(message); });
+  XCTAssertEqual(messages, (std::vector<std::string>{"10", "11", "12", "13"}));
+}
+
+- (void)testMultipleProducers {
+  RenderLog log(os_log_create("RenderLogTests", "test"), 4096);
+  log.allocate();
+  constexpr int perThread = 1000;
+  std::vector<std::thread> threads;
+  for (int thread = 0; thread < 4; ++thread) {
+    threads.emplace_back([&log, thread]() {
+      for (int index = 0; index < perThread; ++index) log.post("%d %d", thread, index);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  std::vector<int> next(4, 0);
+  auto count = log.drain([&](const char* message) {
+    int thread;
+    int index;
+    std::sscanf(message, "%d %d", &thread, &index);
+    // Messages from the same thread must arrive in order
+    XCTAssertEqual(index, next[size_t(thread)]);
+    next[size_t(thread)] = index + 1;
+  });
+  XCTAssertEqual(count, 4 * perThread);
+  XCTAssertEqual(log.dropped(), 0);
+}
+
+- (void)testBackgroundDraining {
+  RenderLog log(os_log_create("RenderLogTests", "test"), 16);
+  log.allocate();
+  XCTAssertTrue(log.startDraining());
+  for (int index = 0; index < 100; ++index) {
+    while (!log.post("%d", index)) std::this_thread::yield();
+  }
+  log.stopDraining();
+  XCTAssertEqual(log.drain([](const char*) {}), 0);
+}
+
+- (void)testSharedDraining {
+  // Both instances are served by the one background thread.
+  RenderLog first(os_log_create("RenderLogTests", "test"), 4);
+  RenderLog second(os_log_create("RenderLogTests", "test"), 4);
+  first.allocate();
+  second.allocate();
+  XCTAssertTrue(first.startDraining());
+  XCTAssertTrue(second.startDraining());
+  XCTAssertTrue(first.startDraining());
+  for (int index = 0; index < 20; ++index) {
+    while (!first.post("%d", index)) std::this_thread::yield();
+    while (!second.post("%d", index)) std::this_thread::yield();
+  }
+  first.stopDraining();
+  second.stopDraining();
+  XCTAssertEqual(first.drain([](const char*) {}), 0);
+  XCTAssertEqual(second.drain([](const char*) {}), 0);
+}
+
+- (void)testUnallocated {
+  RenderLog log(os_log_create("RenderLogTests", "test"), 4);
+  XCTAssertFalse(log.isAllocated());
+  XCTAssertFalse(log.post("%d", 1));
+  XCTAssertEqual(log.dropped(), 1);
+  XCTAssertEqual(log.drain([](const char*) {}), 0);
+
+  log.allocate();
+  XCTAssertTrue(log.isAllocated());
+  XCTAssertTrue(log.post("%d", 2));
+  XCTAssertEqual(log.drain([](const char*) {}), 1);
+}
+
+- (void)testMacro {
+  RenderLog log(os_log_create("RenderLogTests", "test"), 4);
+  log.allocate();
+  int evaluated = 0;
+  DSPHEADERS_RENDER_LOG(log, "value %d", ++evaluated);
+  DSPHEADERS_RENDER_LOG(log, "no args");
+  auto count = log.drain([](const char*) {});
+#if DSPHEADERS_RENDER_LOG_ENABLED
+  XCTAssertEqual(evaluated, 1);
+  XCTAssertEqual(count, 2);
+#else
+  XCTAssertEqual(evaluated, 0);
+  XCTAssertEqual(count, 0);
+#endif
+}
+
+- (void)testPostSpeed {
+  // Blocks copy captured C++ objects, so hold the log by a shared pointer.
+  auto log = std::make_shared<RenderLog>(os_log_create("RenderLogTests", "test"), 1024);
+  log->allocate();
+  [self measureBlock:^{
+    for (int iteration = 0; iteration < 100; ++iteration) {
+      for (int index = 0; index < 1000; ++index) log->post("param %llu %f", 12ULL, AUValue(index));
+      log->drain([](const char*) {});
+    }
+  }];
+}
+
+@end
@@ -0,0 +1,100 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <thread>
+
+#import "DSPHeaders/RenderMetrics.hpp"
+
+using namespace DSPHeaders;
+
+@interface RenderMetricsTests : XCTestCase
+@end
+
+@implementation RenderMetricsTests
+
+static uint64_t ticks(double seconds) { return uint64_t(seconds / RenderMetrics::seconds(1)); }
+
+- (void)testEmpty {
+  RenderMetrics metrics;
+  auto snapshot = metrics.snapshot();
+  XCTAssertEqual(snapshot.calls, 0);
+  XCTAssertEqual(snapshot.averageSeconds(), 0.0);
+  XCTAssertEqual(snapshot.budgetPercentile(0.99), 0.0);
+}
+
+- (void)testRecord {
+  RenderMetrics metrics;
+  double sampleRate = 48000.0;
+  AUAudioFrameCount frameCount = 480; // 10 ms budget
+
+  metrics.record(ticks(0.0011), frameCount, 1, sampleRate); // 11%
+  metrics.record(ticks(0.0051), frameCount, 3, sampleRate); // 51%
+  metrics.record(ticks(0.0151), frameCount, 2, sampleRate); // 151%
+
+  auto snapshot = metrics.snapshot();
+  XCTAssertEqual(snapshot.calls, 3);
+  XCTAssertEqual(snapshot.frames, 3 * frameCount);
+  XCTAssertEqual(snapshot.subBlocks, 6);
+  XCTAssertEqual(snapshot.overruns, 1);
+  XCTAssertEqualWithAccuracy(snapshot.maxSeconds(), 0.0151, 1.0e-6);
+  XCTAssertEqualWithAccuracy(snapshot.averageSeconds(), 0.0213 / 3, 1.0e-6);
+  XCTAssertEqualWithAccuracy(snapshot.maxBudget, 1.51, 1.0e-3);
+
+  XCTAssertEqual(snapshot.histogram[5], 1);
+  XCTAssertEqual(snapshot.histogram[25], 1);
+  XCTAssertEqual(snapshot.histogram[RenderMetrics::bucketCount - 1], 1);
+
+  XCTAssertEqualWithAccuracy(snapshot.budgetPercentile(0.3), 0.12, 1.0e-9);
+  XCTAssertEqualWithAccuracy(snapshot.budgetPercentile(0.67), 0.52, 1.0e-9);
+  XCTAssertEqualWithAccuracy(snapshot.budgetPercentile(1.0), 1.51, 1.0e-3);
+}
+
+- (void)testPercentileLimitedByMax {
+  RenderMetrics metrics;
+  metrics.record(ticks(0.0011), 480, 1, 48000.0); // 11%
+
+  // The bucket holding the call ends at 12%, but no call used more than 11%.
+  auto snapshot = metrics.snapshot();
+  XCTAssertEqualWithAccuracy(snapshot.budgetPercentile(0.5), 0.11, 1.0e-3);
+  XCTAssertEqualWithAccuracy(snapshot.budgetPercentile(0.99), 0.11, 1.0e-3);
+}
+
+- (void)testNoSampleRate {
+  RenderMetrics metrics;
+  metrics.record(ticks(0.001), 512, 1, 0.0);
+  auto snapshot = metrics.snapshot();
+  XCTAssertEqual(snapshot.calls, 1);
+  XCTAssertEqual(snapshot.maxBudget, 0.0);
+  for (auto count : snapshot.histogram) XCTAssertEqual(count, 0);
+}
+
+- (void)testReset {
+  RenderMetrics metrics;
+  metrics.record(ticks(0.001), 512, 1, 44100.0);
+  metrics.reset();
+  auto snapshot = metrics.snapshot();
+  XCTAssertEqual(snapshot.calls, 0);
+  XCTAssertEqual(snapshot.maxTicks, 0);
+  XCTAssertEqual(snapshot.maxBudget, 0.0);
+  for (auto count : snapshot.histogram) XCTAssertEqual(count, 0);
+}
+
+- (void)testConcurrentReader {
+  RenderMetrics metrics;
+  std::atomic<bool> done{false};
+  std::thread writer([&]() {
+    for (int index = 0; index < 100'000; ++index) metrics.record(ticks(0.0001), 64, 1, 48000.0);
+    done = true;
+  });
+
+  uint64_t last = 0;
+  while (!done) {
+    auto calls = metrics.snapshot().calls;
+    XCTAssertTrue(calls >= last);
+    last = calls;
+  }
+  writer.join();
+  XCTAssertEqual(metrics.snapshot().calls, 100'000);
+}
+
+@end
@@ -0,0 +1,130 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <vector>
+
+#import "DSPHeaders/SIMD.hpp"
+
+using namespace DSPHeaders;
+
+namespace {
+
+/// Not a multiple of any vector width so that the scalar finish is always exercised.
+constexpr size_t count = 37;
+
+std::vector<float> ramp(float start, float step) {
+  std::vector<float> values(count);
+  for (size_t index = 0; index < count; ++index) values[index] = start + step * float(index);
+  return values;
+}
+
+}
+
+@interface SIMDTests : XCTestCase
+@end
+
+@implementation SIMDTests
+
+- (void)testFloat {
+  auto values = ramp(1.0, 1.0);
+  auto a = SIMD::Float::load(values.data());
+  auto b = SIMD::Float::broadcast(2.0);
+  std::vector<float> result(SIMD::Float::width);
+  ((a + b) * a - 1.0f).store(result.data());
+  for (size_t lane = 0; lane < SIMD::Float::width; ++lane) {
+    XCTAssertEqual(result[lane], (values[lane] + 2.0f) * values[lane] - 1.0f);
+  }
+  SIMD::Float::laneIndices().store(result.data());
+  for (size_t lane = 0; lane < SIMD::Float::width; ++lane) XCTAssertEqual(result[lane], float(lane));
+}
+
+- (void)testConvert {
+  std::vector<int16_t> shorts(SIMD::Float::width);
+  std::vector<int32_t> ints(SIMD::Float::width);
+  std::vector<double> doubles(SIMD::Float::width);
+  for (size_t lane = 0; lane < SIMD::Float::width; ++lane) {
+    shorts[lane] = int16_t(-32768 + 1000 * int(lane));
+    ints[lane] = -1000 * int32_t(lane);
+    doubles[lane] = 0.25 * lane - 0.5;
+  }
+  std::vector<float> result(SIMD::Float::width);
+  SIMD::Float::convert(shorts.data()).store(result.data());
+  for (size_t lane = 0; lane < SIMD::Float::width; ++lane) XCTAssertEqual(result[lane], float(shorts[lane]));
+  SIMD::Float::convert(ints.data()).store(result.data());
+  for (size_t lane = 0; lane < SIMD::Float::width; ++lane) XCTAssertEqual(result[lane], float(ints[lane]));
+  SIMD::Float::convert(doubles.data()).store(result.data());
+  for (size_t lane = 0; lane < SIMD::Float::width; ++lane) XCTAssertEqual(result[lane], float(doubles[lane]));
+}
+
+- (void)testDeinterleave {
+  auto values = ramp(0.0, 1.0);
+  SIMD::Float even;
+  SIMD::Float odd;
+  SIMD::Float::deinterleave(SIMD::Float::load(values.data()), SIMD::Float::load(values.data() + SIMD::Float::width),
+                            even, odd);
+  std::vector<float> result(SIMD::Float::width);
+  even.store(result.data());
+  for (size_t lane = 0; lane < SIMD::Float::width; ++lane) XCTAssertEqual(result[lane], 2.0 * lane);
+  odd.store(result.data());
+  for (size_t lane = 0; lane < SIMD::Float::width; ++lane) XCTAssertEqual(result[lane], 2.0 * lane + 1);
+}
+
+- (void)testAdd {
+  auto source = ramp(1.0, 0.5);
+  auto destination = ramp(-2.0, 0.25);
+  SIMD::add(source.data(), destination.data(), count - 1);
+  for (size_t index = 0; index < count - 1; ++index) XCTAssertEqual(destination[index], -1.0 + 0.75 * index);
+  XCTAssertEqual(destination[count - 1], -2.0 + 0.25 * (count - 1));
+
+  SIMD::addScaled(source.data(), 2.0, destination.data(), count);
+  for (size_t index = 0; index < count - 1; ++index) XCTAssertEqual(destination[index], 1.0 + 1.75 * index);
+
+  auto gains = ramp(0.0, 1.0);
+  std::vector<float> sum(count, 1.0);
+  SIMD::addProduct(source.data(), gains.data(), sum.data(), count);
+  for (size_t index = 0; index < count; ++index) XCTAssertEqual(sum[index], 1.0 + source[index] * index);
+}
+
+- (void)testScale {
+  auto destination = ramp(1.0, 1.0);
+  SIMD::scale(destination.data(), 0.5, count);
+  for (size_t index = 0; index < count; ++index) XCTAssertEqual(destination[index], 0.5 * (index + 1));
+
+  auto gains = ramp(0.0, 2.0);
+  SIMD::multiply(gains.data(), destination.data(), count);
+  for (size_t index = 0; index < count; ++index) XCTAssertEqual(destination[index], index * (index + 1.0));
+
+  std::vector<float> ones(count, 1.0);
+  SIMD::scaleRamp(ones.data(), 1.0, -1.0 / count, count);
+  for (size_t index = 0; index < count; ++index) {
+    XCTAssertEqualWithAccuracy(ones[index], 1.0 - double(index) / count, 1.0e-6);
+  }
+}
+
+- (void)testPan {
+  auto source = ramp(1.0, 1.0);
+  std::vector<float> left(count);
+  std::vector<float> right(count);
+  SIMD::pan(source.data(), 0.25, 0.75, left.data(), right.data(), count);
+  for (size_t index = 0; index < count; ++index) {
+    XCTAssertEqual(left[index], source[index] * 0.25f);
+    XCTAssertEqual(right[index], source[index] * 0.75f);
+  }
+}
+
+- (void)testSumAndDifference {
+  auto first = ramp(1.0, 1.0);
+  auto second = ramp(0.0, -0.5);
+  SIMD::sumAndDifference(first.data(), second.data(), 0.5, count);
+  for (size_t index = 0; index < count; ++index) {
+    XCTAssertEqual(first[index], (1.0 + 0.5 * index) * 0.5);
+    XCTAssertEqual(second[index], (1.0 + 1.5 * index) * 0.5);
+  }
+  SIMD::sumAndDifference(first.data(), second.data(), 1.0, count);
+  for (size_t index = 0; index < count; ++index) {
+    XCTAssertEqual(first[index], 1.0 + index);
+    XCTAssertEqual(second[index], -0.5 * index);
+  }
+}
+
+@end
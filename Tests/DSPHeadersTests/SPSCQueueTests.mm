@@ -0,0 +1,83 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <memory>
+#import <thread>
+
+#import "DSPHeaders/SPSCQueue.hpp"
+
+using namespace DSPHeaders;
+
+@interface SPSCQueueTests : XCTestCase
+@end
+
+@implementation SPSCQueueTests
+
+- (void)testEmpty {
+  SPSCQueue<int, 4> queue;
+  XCTAssertEqual(queue.capacity(), 4);
+  XCTAssertTrue(queue.empty());
+  XCTAssertEqual(queue.peek(), nullptr);
+}
+
+- (void)testPushPop {
+  SPSCQueue<int, 4> queue;
+  XCTAssertTrue(queue.push(1));
+  XCTAssertTrue(queue.push(2));
+  XCTAssertEqual(queue.size(), 2);
+  XCTAssertEqual(*queue.peek(), 1);
+  XCTAssertEqual(*queue.peek(1), 2);
+  XCTAssertEqual(queue.peek(2), nullptr);
+  queue.pop();
+  XCTAssertEqual(*queue.peek(), 2);
+  queue.pop();
+  XCTAssertTrue(queue.empty());
+}
+
+- (void)testFull {
+  SPSCQueue<int, 4> queue;
+  for (int index = 0; index < 4; ++index) XCTAssertTrue(queue.push(index));
+  XCTAssertFalse(queue.push(4));
+  queue.pop();
+  XCTAssertTrue(queue.push(4));
+
+  // Values wrap around the end of the storage
+  for (int index = 1; index <= 4; ++index) {
+    XCTAssertEqual(*queue.peek(), index);
+    queue.pop();
+  }
+  XCTAssertTrue(queue.empty());
+}
+
+- (void)testProducerConsumer {
+  auto queue = std::make_shared<SPSCQueue<int, 64>>();
+  constexpr int count = 100'000;
+  std::thread producer([queue]() {
+    for (int index = 0; index < count; ++index) {
+      while (!queue->push(index)) std::this_thread::yield();
+    }
+  });
+
+  int expected = 0;
+  while (expected < count) {
+    if (auto value = queue->peek()) {
+      XCTAssertEqual(*value, expected);
+      queue->pop();
+      ++expected;
+    }
+  }
+  producer.join();
+  XCTAssertTrue(queue->empty());
+}
+
+- (void)testPushPopSpeed {
+  auto queue = std::make_shared<SPSCQueue<int, 256>>();
+  [self measureBlock:^{
+    for (int iteration = 0; iteration < 10'000; ++iteration) {
+      for (int index = 0; index < 256; ++index) queue->push(index);
+      while (queue->peek() != nullptr) queue->pop();
+    }
+  }];
+}
+
+@end
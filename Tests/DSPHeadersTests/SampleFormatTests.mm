@@ -0,0 +1,232 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <cstring>
+#import <memory>
+#import <vector>
+
+#import "DSPHeaders/SampleFormat.hpp"
+
+using namespace DSPHeaders;
+
+namespace {
+
+/// Not a multiple of any vector width so that the scalar finish is always exercised.
+constexpr size_t frameCount = 37;
+
+/// @returns sample value for a channel and frame that is exactly representable in all formats
+double sampleValue(size_t channel, size_t frame) {
+  return (double(frame) - 18.0) / 32.0 * (channel % 2 == 0 ? 1 : -1) / double(channel / 2 + 1);
+}
+
+/// Number of frames to use in the speed tests.
+constexpr size_t blockSize = 512;
+
+/**
+ Interleaved samples of channels in a given format.
+ */
+std::vector<std::byte> makeSamples(SampleFormat format, size_t channelCount = 2, size_t frames = frameCount) {
+  auto size = bytesPerSample(format);
+  std::vector<std::byte> samples(frames * channelCount * size);
+  for (size_t frame = 0; frame < frames; ++frame) {
+    for (size_t channel = 0; channel < channelCount; ++channel) {
+      auto value = sampleValue(channel, frame % frameCount);
+      auto pos = samples.data() + (frame * channelCount + channel) * size;
+      switch (format) {
+        case SampleFormat::float32: { float tmp = float(value); std::memcpy(pos, &tmp, size); break; }
+        case SampleFormat::float64: std::memcpy(pos, &value, size); break;
+        case SampleFormat::int16: { int16_t tmp = int16_t(value * 32768.0); std::memcpy(pos, &tmp, size); break; }
+        case SampleFormat::int24: { int32_t tmp = int32_t(value * 8388608.0); std::memcpy(pos, &tmp, size); break; }
+        case SampleFormat::int32: { int32_t tmp = int32_t(value * 2147483648.0); std::memcpy(pos, &tmp, size); break; }
+      }
+    }
+  }
+  return samples;
+}
+
+}
+
+@interface SampleFormatTests : XCTestCase
+@end
+
+@implementation SampleFormatTests
+
+- (void)testBytesPerSample {
+  XCTAssertEqual(bytesPerSample(SampleFormat::float32), 4);
+  XCTAssertEqual(bytesPerSample(SampleFormat::float64), 8);
+  XCTAssertEqual(bytesPerSample(SampleFormat::int16), 2);
+  XCTAssertEqual(bytesPerSample(SampleFormat::int24), 3);
+  XCTAssertEqual(bytesPerSample(SampleFormat::int32), 4);
+
+  StreamFormat format{SampleFormat::int24, 2, true};
+  XCTAssertEqual(format.frameStride(), 6);
+  XCTAssertFalse(format.isNative());
+  XCTAssertFalse(format.isContiguous());
+  XCTAssertTrue((StreamFormat{SampleFormat::float32, 1, true}).isContiguous());
+  XCTAssertFalse((StreamFormat{SampleFormat::float32, 2, true}).isContiguous());
+}
+
+- (void)testDecode {
+  for (auto format : {SampleFormat::float32, SampleFormat::float64, SampleFormat::int16, SampleFormat::int24,
+    SampleFormat::int32}) {
+    auto samples = makeSamples(format);
+    auto stride = bytesPerSample(format) * 2;
+    std::vector<AUValue> right(frameCount);
+    SampleConversion::decode(format, samples.data() + bytesPerSample(format), stride, right.data(), frameCount);
+    for (size_t frame = 0; frame < frameCount; ++frame) XCTAssertEqual(right[frame], sampleValue(1, frame));
+  }
+}
+
+- (void)testDeinterleave {
+  for (auto format : {SampleFormat::float32, SampleFormat::float64, SampleFormat::int16, SampleFormat::int24,
+    SampleFormat::int32}) {
+    for (size_t channelCount = 1; channelCount <= 3; ++channelCount) {
+      auto samples = makeSamples(format, channelCount);
+      std::vector<std::vector<AUValue>> channels(channelCount, std::vector<AUValue>(frameCount));
+      std::vector<AUValue*> pointers;
+      for (auto& channel : channels) pointers.push_back(channel.data());
+      SampleConversion::deinterleave(format, samples.data(), pointers, frameCount);
+      for (size_t channel = 0; channel < channelCount; ++channel) {
+        for (size_t frame = 0; frame < frameCount; ++frame) {
+          XCTAssertEqual(channels[channel][frame], sampleValue(channel, frame));
+        }
+      }
+    }
+  }
+}
+
+- (void)testDecodeExtremes {
+  std::vector<int16_t> samples{-32768, 32767, 0, -1};
+  std::vector<AUValue> values(samples.size());
+  SampleConversion::decode(SampleFormat::int16, reinterpret_cast<const std::byte*>(samples.data()), 2, values.data(),
+                           values.size());
+  XCTAssertEqual(values[0], -1.0);
+  XCTAssertEqualWithAccuracy(values[1], 1.0, 1.0e-4);
+  XCTAssertEqual(values[2], 0.0);
+  XCTAssertEqual(values[3], -1.0 / 32768.0);
+
+  // 0x800000 is the most negative 24-bit value and the sign must be extended.
+  std::vector<uint8_t> packed{0x00, 0x00, 0x80, 0xFF, 0xFF, 0x7F};
+  SampleConversion::decode(SampleFormat::int24, reinterpret_cast<const std::byte*>(packed.data()), 3, values.data(),
+                           2);
+  XCTAssertEqual(values[0], -1.0);
+  XCTAssertEqualWithAccuracy(values[1], 1.0, 1.0e-6);
+}
+
+- (void)testZeroCopyNonInterleaved {
+  std::vector<AUValue> left(frameCount, 0.5);
+  std::vector<AUValue> right(frameCount, -0.5);
+  std::vector<std::byte> storage(offsetof(AudioBufferList, mBuffers) + 2 * sizeof(AudioBuffer));
+  auto bufferList = reinterpret_cast<AudioBufferList*>(storage.data());
+  bufferList->mNumberBuffers = 2;
+  bufferList->mBuffers[0] = {1, UInt32(frameCount * sizeof(AUValue)), left.data()};
+  bufferList->mBuffers[1] = {1, UInt32(frameCount * sizeof(AUValue)), right.data()};
+
+  FormatFacet facet;
+  facet.setFormat({SampleFormat::float32, 2, false}, frameCount);
+  XCTAssertTrue(facet.isZeroCopy());
+  XCTAssertEqual(facet.assignBufferList(bufferList, frameCount), noErr);
+  auto buffers = facet.busBuffers();
+  XCTAssertEqual(buffers.size(), 2);
+  XCTAssertEqual(buffers[0], left.data());
+  XCTAssertEqual(buffers[1], right.data());
+  XCTAssertEqual(facet.channel(1).data(), right.data());
+  XCTAssertTrue(facet.channel(1).isContiguous());
+}
+
+- (void)testZeroCopyInterleaved {
+  auto samples = makeSamples(SampleFormat::float32);
+  FormatFacet facet;
+  facet.setFormat({SampleFormat::float32, 2, true}, frameCount);
+  XCTAssertFalse(facet.isZeroCopy());
+  XCTAssertEqual(facet.assign(samples.data(), frameCount), noErr);
+
+  // The strided view uses the original samples.
+  auto right = facet.channel(1);
+  XCTAssertEqual(right.stride(), 2);
+  XCTAssertEqual(reinterpret_cast<const std::byte*>(right.data()), samples.data() + sizeof(AUValue));
+  for (size_t frame = 0; frame < frameCount; ++frame) XCTAssertEqual(right[frame], sampleValue(1, frame));
+
+  // Contiguous samples come from the scratch buffers.
+  auto buffers = facet.busBuffers();
+  for (size_t frame = 0; frame < frameCount; ++frame) {
+    XCTAssertEqual(buffers[0][frame], sampleValue(0, frame));
+    XCTAssertEqual(buffers[1][frame], sampleValue(1, frame));
+  }
+  XCTAssertEqual(facet.channel(1).data(), right.data());
+}
+
+- (void)testConverted {
+  for (auto format : {SampleFormat::float64, SampleFormat::int16, SampleFormat::int24, SampleFormat::int32}) {
+    auto samples = makeSamples(format);
+    FormatFacet facet;
+    facet.setFormat({format, 2, true}, 64);
+    XCTAssertEqual(facet.assign(samples.data(), frameCount), noErr);
+    XCTAssertEqual(facet.frameCount(), frameCount);
+    auto buffers = facet.busBuffers();
+    for (size_t frame = 0; frame < frameCount; ++frame) {
+      XCTAssertEqual(buffers[0][frame], sampleValue(0, frame));
+      XCTAssertEqual(buffers[1][frame], sampleValue(1, frame));
+      XCTAssertEqual(facet.channel(1)[frame], sampleValue(1, frame));
+    }
+    XCTAssertTrue(facet.channel(0).isContiguous());
+  }
+}
+
+- (void)testValidation {
+  auto samples = makeSamples(SampleFormat::int16);
+  FormatFacet facet;
+  facet.setFormat({SampleFormat::int16, 2, true}, frameCount - 1);
+  XCTAssertEqual(facet.assign(nullptr, 1), kAudioUnitErr_InvalidParameter);
+  XCTAssertEqual(facet.assign(samples.data(), frameCount), kAudioUnitErr_TooManyFramesToProcess);
+  XCTAssertEqual(facet.assignBufferList(nullptr, 1), kAudioUnitErr_InvalidParameter);
+
+  AudioBufferList bufferList{1, {{2, UInt32(samples.size()), samples.data()}}};
+  XCTAssertEqual(facet.assignBufferList(&bufferList, frameCount - 1), noErr);
+
+  facet.setFormat({SampleFormat::int16, 2, false}, frameCount);
+  XCTAssertEqual(facet.assign(samples.data(), frameCount), kAudioUnitErr_FormatNotSupported);
+  XCTAssertEqual(facet.assignBufferList(&bufferList, frameCount), kAudioUnitErr_FormatNotSupported);
+}
+
+- (void)testTooManyChannels {
+  FormatFacet facet;
+  XCTAssertEqual(facet.setFormat({SampleFormat::int16, 2, true}, frameCount), noErr);
+  XCTAssertEqual(facet.setFormat({SampleFormat::int16, 10, true}, frameCount), kAudioUnitErr_FormatNotSupported);
+  XCTAssertEqual(facet.format().channelCount, 2);
+}
+
+- (void)testPerSampleConvertSpeed {
+  auto samples = std::make_shared<std::vector<std::byte>>(makeSamples(SampleFormat::int16, 2, blockSize));
+  auto values = std::make_shared<std::vector<AUValue>>(2 * blockSize);
+  auto format = std::make_shared<SampleFormat>(SampleFormat::int16);
+  [self measureBlock:^{
+    for (int iteration = 0; iteration < 20'000; ++iteration) {
+      // One sample at a time, checking the format for each one
+      auto size = bytesPerSample(*format);
+      for (size_t frame = 0; frame < blockSize; ++frame) {
+        for (size_t channel = 0; channel < 2; ++channel) {
+          auto sample = samples->data() + (frame * 2 + channel) * size;
+          AUValue value = 0.0;
+          switch (*format) {
+            case SampleFormat::int16: value = SampleConversion::Detail::read<int16_t>(sample) / 32768.0; break;
+            case SampleFormat::int24: value = SampleConversion::Detail::readInt24(sample) / 8388608.0; break;
+            default: break;
+          }
+          (*values)[channel * blockSize + frame] = value;
+        }
+      }
+    }
+  }];
+}
+
+- (void)testBlockConvertSpeed {
+  auto samples = std::make_shared<std::vector<std::byte>>(makeSamples(SampleFormat::int16, 2, blockSize));
+  auto facet = std::make_shared<FormatFacet>();
+  facet->setFormat({SampleFormat::int16, 2, true}, blockSize);
+  [self measureBlock:^{
+    for (int iteration = 0; iteration < 20'000; ++iteration) facet->assign(samples->data(), blockSize);
+  }];
+}
+
+@end
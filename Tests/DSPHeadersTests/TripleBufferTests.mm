@@ -0,0 +1,77 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#import <XCTest/XCTest.h>
+#import <array>
+#import <memory>
+#import <thread>
+
+#import "DSPHeaders/TripleBuffer.hpp"
+
+using namespace DSPHeaders;
+
+@interface TripleBufferTests : XCTestCase
+@end
+
+@implementation TripleBufferTests
+
+- (void)testInitial {
+  TripleBuffer<int> buffer;
+  XCTAssertFalse(buffer.hasUpdate());
+  XCTAssertEqual(buffer.read(), 0);
+}
+
+- (void)testPublishAndRead {
+  TripleBuffer<int> buffer;
+  buffer.writeValue() = 1;
+  buffer.publish();
+  XCTAssertTrue(buffer.hasUpdate());
+  XCTAssertEqual(buffer.read(), 1);
+  XCTAssertFalse(buffer.hasUpdate());
+  XCTAssertEqual(buffer.read(), 1);
+
+  // Only the latest value is seen
+  buffer.writeValue() = 2;
+  buffer.publish();
+  buffer.writeValue() = 3;
+  buffer.publish();
+  XCTAssertEqual(buffer.read(), 3);
+}
+
+- (void)testReaderValueIsStable {
+  TripleBuffer<int> buffer;
+  buffer.writeValue() = 1;
+  buffer.publish();
+  auto& value = buffer.read();
+  for (int index = 2; index < 10; ++index) {
+    buffer.writeValue() = index;
+    buffer.publish();
+  }
+  XCTAssertEqual(value, 1);
+  XCTAssertEqual(buffer.read(), 9);
+}
+
+- (void)testConcurrentReader {
+  // Each value holds copies of the same number, so a torn read would show up as a mismatch.
+  using Value = std::array<int, 64>;
+  auto buffer = std::make_shared<TripleBuffer<Value>>();
+  std::atomic<bool> done{false};
+  std::thread writer([buffer, &done]() {
+    for (int index = 1; index <= 100'000; ++index) {
+      buffer->writeValue().fill(index);
+      buffer->publish();
+    }
+    done = true;
+  });
+
+  int last = 0;
+  while (!done) {
+    auto& value = buffer->read();
+    for (auto entry : value) XCTAssertEqual(entry, value[0]);
+    XCTAssertTrue(value[0] >= last);
+    last = value[0];
+  }
+  writer.join();
+  XCTAssertEqual(buffer->read()[0], 100'000);
+}
+
+@end
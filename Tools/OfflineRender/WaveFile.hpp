@@ -0,0 +1,117 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "DSPHeaders/AudioTypes.hpp"
+#include "DSPHeaders/SampleFormat.hpp"
+
+namespace OfflineRender {
+
+/**
+ Minimal reader of RIFF/WAVE files. Supports 16, 24 and 32-bit integer PCM as well as 32 and 64-bit floating-point
+ samples, including the WAVE_FORMAT_EXTENSIBLE variants. The samples are kept as they are in the file -- interleaved
+ and in their original format -- so that `OfflineRenderer` can convert them as it feeds them to a kernel.
+ */
+struct WaveFile {
+  double sampleRate{0.0};
+  DSPHeaders::StreamFormat format{};
+  std::vector<std::byte> samples{};
+
+  /// @returns the number of frames in the file
+  size_t frameCount() const noexcept {
+    return samples.size() / (DSPHeaders::bytesPerSample(format.sampleFormat) * format.channelCount);
+  }
+
+  /**
+   Load the contents of a WAV file. Throws `std::runtime_error` if the file cannot be read or is not supported.
+
+   @param path the location of the file to load
+   @returns new WaveFile instance
+   */
+  static WaveFile load(const std::string& path) {
+    std::ifstream stream(path, std::ios::binary);
+    if (!stream) throw std::runtime_error("unable to open " + path);
+    std::vector<char> contents{std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+    if (contents.size() < 12 || std::memcmp(contents.data(), "RIFF", 4) != 0 ||
+        std::memcmp(contents.data() + 8, "WAVE", 4) != 0) {
+      throw std::runtime_error("not a WAVE file: " + path);
+    }
+
+    uint16_t format{0};
+    uint16_t channelCount{0};
+    uint32_t rate{0};
+    uint16_t bitsPerSample{0};
+    const char* data{nullptr};
+    size_t dataSize{0};
+
+    size_t pos = 12;
+    while (pos + 8 <= contents.size()) {
+      const char* chunk = contents.data() + pos;
+      size_t chunkSize = read<uint32_t>(chunk + 4);
+      const char* body = chunk + 8;
+      chunkSize = std::min(chunkSize, contents.size() - pos - 8);
+      if (std::memcmp(chunk, "fmt ", 4) == 0 && chunkSize >= 16) {
+        format = read<uint16_t>(body);
+        channelCount = read<uint16_t>(body + 2);
+        rate = read<uint32_t>(body + 4);
+        bitsPerSample = read<uint16_t>(body + 14);
+        if (format == formatExtensible && chunkSize >= 26) format = read<uint16_t>(body + 24);
+      } else if (std::memcmp(chunk, "data", 4) == 0) {
+        data = body;
+        dataSize = chunkSize;
+      }
+      pos += 8 + chunkSize + (chunkSize & 1);
+    }
+
+    if (data == nullptr || channelCount == 0) throw std::runtime_error("missing fmt or data chunk: " + path);
+
+    WaveFile wave;
+    wave.sampleRate = rate;
+    wave.format = {sampleFormat(format, bitsPerSample), channelCount, true};
+    size_t frameSize = DSPHeaders::bytesPerSample(wave.format.sampleFormat) * channelCount;
+    auto begin = reinterpret_cast<const std::byte*>(data);
+    wave.samples.assign(begin, begin + dataSize / frameSize * frameSize);
+    return wave;
+  }
+
+private:
+  static constexpr uint16_t formatPCM = 1;
+  static constexpr uint16_t formatFloat = 3;
+  static constexpr uint16_t formatExtensible = 0xFFFE;
+
+  template <typename T>
+  static T read(const char* ptr) noexcept {
+    T value;
+    std::memcpy(&value, ptr, sizeof(T));
+    return value;
+  }
+
+  static DSPHeaders::SampleFormat sampleFormat(uint16_t format, uint16_t bitsPerSample) {
+    if (format == formatPCM) {
+      switch (bitsPerSample) {
+        case 16: return DSPHeaders::SampleFormat::int16;
+        case 24: return DSPHeaders::SampleFormat::int24;
+        case 32: return DSPHeaders::SampleFormat::int32;
+        default: break;
+      }
+    } else if (format == formatFloat) {
+      switch (bitsPerSample) {
+        case 32: return DSPHeaders::SampleFormat::float32;
+        case 64: return DSPHeaders::SampleFormat::float64;
+        default: break;
+      }
+    }
+    throw std::runtime_error("unsupported sample format");
+  }
+};
+
+} // end namespace OfflineRender
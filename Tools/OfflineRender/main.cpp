@@ -0,0 +1,174 @@
+// Copyright © 2025 Brad Howes. All rights reserved.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "DSPHeaders/EventProcessor.hpp"
+#include "DSPHeaders/OfflineRenderer.hpp"
+#include "DSPHeaders/Parameters/Float.hpp"
+#include "DSPHeaders/RenderGuard.hpp"
+#include "WaveFile.hpp"
+
+using namespace DSPHeaders;
+
+namespace {
+
+/**
+ Simple kernel that applies a ramping gain to its input. It stands in for a real kernel when measuring the overhead of
+ the `EventProcessor` machinery. Copy this file and replace `GainKernel` with your own kernel to measure it.
+ */
+struct GainKernel : public EventProcessor<GainKernel> {
+  using super = EventProcessor<GainKernel>;
+
+  GainKernel() : super("GainKernel") { registerParameter(gain_); }
+
+  void doRendering(BusBuffers ins, BusBuffers outs, AUAudioFrameCount frameCount) noexcept {
+    // Work in chunks so that ramping gain values can be held in a small buffer on the stack.
+    for (AUAudioFrameCount offset = 0; offset < frameCount; offset += chunkSize) {
+      auto count = std::min(chunkSize, frameCount - offset);
+      std::span<AUValue> gains{gains_.data(), count};
+      auto ramping = gain_.fillFrameValues(gains);
+      auto gain = gain_.frameValue();
+      for (size_t channel = 0; channel < outs.size(); ++channel) {
+        auto in = ins[channel] + offset;
+        auto out = outs[channel] + offset;
+        if (ramping) {
+          for (AUAudioFrameCount frame = 0; frame < count; ++frame) out[frame] = in[frame] * gains[frame];
+        } else {
+          for (AUAudioFrameCount frame = 0; frame < count; ++frame) out[frame] = in[frame] * gain;
+        }
+      }
+    }
+  }
+
+  static constexpr AUAudioFrameCount chunkSize = 64;
+  std::array<AUValue, chunkSize> gains_{};
+  Parameters::Float gain_{0, 1.0};
+};
+
+[[maybe_unused]] ValidatedKernel<GainKernel> _gainKernel;
+
+void usage() {
+  std::cerr << "usage: offline-render [--input FILE.wav] [--seconds N] [--sample-rate N] [--channels N]\n"
+               "                      [--block-sizes N[,N...]] [--event-interval N] [--ramp N] [--in-place]\n";
+}
+
+std::vector<AUAudioFrameCount> parseBlockSizes(const std::string& arg) {
+  std::vector<AUAudioFrameCount> sizes;
+  std::stringstream stream(arg);
+  std::string item;
+  while (std::getline(stream, item, ',')) sizes.push_back(AUAudioFrameCount(std::stoul(item)));
+  return sizes;
+}
+
+std::vector<std::vector<AUValue>> makeSine(double sampleRate, AUAudioChannelCount channelCount) {
+  std::vector<std::vector<AUValue>> channels(channelCount, std::vector<AUValue>(size_t(sampleRate)));
+  for (size_t frame = 0; frame < channels[0].size(); ++frame) {
+    auto value = AUValue(0.5 * std::sin(2.0 * M_PI * 440.0 * double(frame) / sampleRate));
+    for (auto& channel : channels) channel[frame] = value;
+  }
+  return channels;
+}
+
+} // end anonymous namespace
+
+int main(int argc, const char* argv[]) {
+  std::string inputPath;
+  double seconds = 60.0;
+  double sampleRate = 48000.0;
+  AUAudioChannelCount channelCount = 2;
+  std::vector<AUAudioFrameCount> blockSizes{512};
+  AUAudioFrameCount eventInterval = 0;
+  AUAudioFrameCount rampDuration = 0;
+  bool inPlace = false;
+
+  try {
+    for (int index = 1; index < argc; ++index) {
+      std::string arg{argv[index]};
+      auto next = [&]() -> std::string {
+        if (index + 1 >= argc) throw std::invalid_argument("missing value for " + arg);
+        return argv[++index];
+      };
+      if (arg == "--input") inputPath = next();
+      else if (arg == "--seconds") seconds = std::stod(next());
+      else if (arg == "--sample-rate") sampleRate = std::stod(next());
+      else if (arg == "--channels") channelCount = AUAudioChannelCount(std::stoul(next()));
+      else if (arg == "--block-sizes") blockSizes = parseBlockSizes(next());
+      else if (arg == "--event-interval") eventInterval = AUAudioFrameCount(std::stoul(next()));
+      else if (arg == "--ramp") rampDuration = AUAudioFrameCount(std::stoul(next()));
+      else if (arg == "--in-place") inPlace = true;
+      else { usage(); return EXIT_FAILURE; }
+    }
+
+    OfflineRender::WaveFile wave;
+    if (!inputPath.empty()) {
+      wave = OfflineRender::WaveFile::load(inputPath);
+      sampleRate = wave.sampleRate;
+      channelCount = wave.format.channelCount;
+    }
+
+    GainKernel kernel;
+    AUAudioFrameCount maxFramesToRender = *std::max_element(blockSizes.begin(), blockSizes.end());
+    OfflineRenderer<GainKernel> renderer(kernel, sampleRate, channelCount, maxFramesToRender);
+    if (!inputPath.empty()) {
+      renderer.setInput(std::move(wave.samples), wave.format);
+    } else {
+      renderer.setInput(makeSine(sampleRate, channelCount));
+    }
+    renderer.setBlockSizes(blockSizes);
+    renderer.setInPlace(inPlace);
+
+    // Render in one-second chunks so that automation events do not need to be generated all at once.
+    auto total = AUEventSampleTime(seconds * sampleRate);
+    auto chunk = AUEventSampleTime(sampleRate);
+    while (renderer.sampleTime() < total) {
+      auto start = renderer.sampleTime();
+      auto frames = std::min(chunk, total - start);
+      if (eventInterval > 0) {
+        for (auto when = start; when < start + frames; when += eventInterval) {
+          auto value = AUValue(0.5 + 0.5 * std::sin(double(when) / sampleRate));
+          renderer.addParameterEvent(when, 0, value, rampDuration);
+        }
+      }
+      auto status = renderer.render(frames);
+      if (status != noErr) {
+        std::cerr << "processAndRender failed: " << status << '\n';
+        return EXIT_FAILURE;
+      }
+    }
+
+    const auto& stats{renderer.statistics()};
+    std::printf("frames: %lld calls: %zu events: %zu\n", static_cast<long long>(stats.framesRendered),
+                stats.renderCalls, stats.eventsDelivered);
+    std::printf("render time: %.6f s  max call: %.3f us\n", stats.renderSeconds, stats.maxCallSeconds * 1.0e6);
+    std::printf("frames/s: %.0f  real-time factor: %.1fx\n", stats.framesPerSecond(), stats.realTimeFactor());
+#if DSPHEADERS_RENDER_METRICS_ENABLED
+    auto metrics = kernel.renderMetrics().snapshot();
+    std::printf("sub-blocks: %llu  budget p50: %.0f%%  p99: %.0f%%  max: %.2f%%  overruns: %llu\n",
+                static_cast<unsigned long long>(metrics.subBlocks), metrics.budgetPercentile(0.5) * 100.0,
+                metrics.budgetPercentile(0.99) * 100.0, metrics.maxBudget * 100.0,
+                static_cast<unsigned long long>(metrics.overruns));
+#endif
+#if DSPHEADERS_RENDER_GUARD_ENABLED
+    if (auto count = RenderGuard::violationCount(); count > 0) {
+      std::cerr << "kernel allocated memory or took a lock while rendering " << count << " times. First one:\n"
+                << RenderGuard::describe(0) << '\n';
+      return EXIT_FAILURE;
+    }
+#endif
+  } catch (const std::exception& error) {
+    std::cerr << "error: " << error.what() << '\n';
+    usage();
+    return EXIT_FAILURE;
+  }
+
+  return EXIT_SUCCESS;
+}